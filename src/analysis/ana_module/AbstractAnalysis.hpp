@@ -5,10 +5,15 @@
 #ifndef TINKER_ABSTRACTANALYSIS_HPP
 #define TINKER_ABSTRACTANALYSIS_HPP
 
+#include <boost/optional.hpp>
+
+#include "dsl/AmberMask.hpp"
 #include "utils/std.hpp"
 
 class Frame;
 
+class PairKernelDriver;
+
 class AbstractAnalysis {
 public:
     void process_topology(std::shared_ptr<Frame> &frame) { process_topology_impl(frame); }
@@ -29,6 +34,21 @@ public:
 
     bool enable_parralle_while() { return enable_paralel_while_impl(); }
 
+    /*
+     *  masks of all atoms this task reads from frames (their molecules included),
+     *  boost::none if the task may read any atom
+     */
+    [[nodiscard]] const boost::optional<std::vector<AmberMask>> &required_atoms() const { return required_masks; }
+
+    void set_required_atoms(boost::optional<std::vector<AmberMask>> masks) { required_masks = std::move(masks); }
+
+    // hand the pair kernels made on the first frame to driver, which runs them with those of other tasks before
+    // any task processes a frame
+    void register_pair_kernels(PairKernelDriver &driver) { register_pair_kernels_impl(driver); }
+
+    // number of frames the task will process, called after processFirstFrame when the frame range is known
+    void reserve_frames(std::size_t frames) { reserve_frames_impl(frames); }
+
     virtual ~AbstractAnalysis() = default;
 
 protected:
@@ -38,9 +58,17 @@ protected:
 
     virtual void process_topology_impl([[maybe_unused]] std::shared_ptr<Frame> &frame) {}
 
+    virtual void register_pair_kernels_impl([[maybe_unused]] PairKernelDriver &driver) {}
+
+    // tasks keeping a value per frame size their histories ahead, so the frame loop does not grow them
+    virtual void reserve_frames_impl([[maybe_unused]] std::size_t frames) {}
+
     void setOutFilename(std::string outfilename);
 
     std::string outfilename;
+
+private:
+    boost::optional<std::vector<AmberMask>> required_masks;
 };
 
 #endif  // TINKER_ABSTRACTANALYSIS_HPP
@@ -4,6 +4,7 @@
 #include "AngleWat.hpp"
 
 #include "data_structure/frame.hpp"
+#include "utils/Geometry.hpp"
 #include "utils/ThrowAssert.hpp"
 #include "utils/common.hpp"
 
@@ -22,31 +23,30 @@ void AngleWat::processFirstFrame(std::shared_ptr<Frame> &frame) {
             }
         }
     }
+    for (auto &atom3 : group1) {
+        group1_indices.push_back(atom3->index);
+    }
+    row_triplets.resize(group1_indices.size());
+    row_pairs.resize(group1_indices.size());
+    row_angles.resize(group1_indices.size());
+    row_distances.resize(group1_indices.size());
 }
 
 void AngleWat::process(std::shared_ptr<Frame> &frame) {
     for (auto &[vec1_atom1, vec1_atom2] : pairs) {
-        double xr = vec1_atom2->x - vec1_atom1->x;
-        double yr = vec1_atom2->y - vec1_atom1->y;
-        double zr = vec1_atom2->z - vec1_atom1->z;
-
-        frame->image(xr, yr, zr);
-
-        double leng1 = sqrt(xr * xr + yr * yr + zr * zr);
-
-        for (auto &atom3 : group1) {
-            double xr2 = vec1_atom1->x - atom3->x;
-            double yr2 = vec1_atom1->y - atom3->y;
-            double zr2 = vec1_atom1->z - atom3->z;
-
-            frame->image(xr2, yr2, zr2);
+        for (std::size_t k = 0; k < group1_indices.size(); ++k) {
+            row_triplets[k] = {vec1_atom2->index, vec1_atom1->index, group1_indices[k]};
+            row_pairs[k] = {vec1_atom1->index, group1_indices[k]};
+        }
+        atom_angles(*frame, row_triplets, row_angles);
+        atom_distances(*frame, row_pairs, row_distances);
 
-            double distance = sqrt(xr2 * xr2 + yr2 * yr2 + zr2 * zr2);
+        for (std::size_t k = 0; k < group1_indices.size(); ++k) {
+            double distance = row_distances[k];
 
             if (cutoff1 <= distance and distance < cutoff2) {
-                double _cos = (xr * xr2 + yr * yr2 + zr * zr2) / (distance * leng1);
-
-                double angle = acos(_cos) * radian;
+                // between atom1->atom2 and atom3->atom1, the supplement of the angle at atom1
+                double angle = 180.0 - row_angles[k];
 
                 int i_angle_bin = int(angle / angle_width) + 1;
 
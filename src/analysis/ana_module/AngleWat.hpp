@@ -30,6 +30,12 @@ protected:
 
     std::list<std::tuple<std::shared_ptr<Atom>, std::shared_ptr<Atom>>> pairs;
 
+    // per pair, the index tuples against all of group1 and their geometry, reused every row
+    std::vector<std::size_t> group1_indices;
+    std::vector<std::array<std::size_t, 3>> row_triplets;
+    std::vector<std::array<std::size_t, 2>> row_pairs;
+    std::vector<double> row_angles, row_distances;
+
     double angle_width{};
 
     int angle_bins{};
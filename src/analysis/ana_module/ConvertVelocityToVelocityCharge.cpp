@@ -44,6 +44,7 @@ void ConvertVelocityToVelocityCharge::process(std::shared_ptr<Frame> &frame) {
     last_atom->vx = std::get<0>(vq);
     last_atom->vy = std::get<1>(vq);
     last_atom->vz = std::get<2>(vq);
+    frame->sync_atoms();
 
     writer->setCurrentTime(frame->getCurrentTime().value());
     writer->write(frame);
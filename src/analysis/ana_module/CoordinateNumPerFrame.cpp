@@ -10,15 +10,9 @@
 CoordinateNumPerFrame::CoordinateNumPerFrame() { enable_outfile = true; }
 
 void CoordinateNumPerFrame::process(std::shared_ptr<Frame> &frame) {
-    int cn_sum = 0;
-    for (auto &atom1 : group1) {
-        for (auto &atom2 : group2) {
-            if (atom_distance(atom1, atom2, frame) <= this->dist_cutoff) {
-                cn_sum++;
-            }
-        }
-    }
+    pair_kernel->process(*frame);
     cn_list.push_back(cn_sum);
+    cn_sum = 0;
 }
 
 void CoordinateNumPerFrame::print(std::ostream &os) {
@@ -41,12 +35,16 @@ void CoordinateNumPerFrame::readInfo() {
 }
 
 void CoordinateNumPerFrame::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    std::for_each(frame->atom_list.begin(), frame->atom_list.end(), [this](std::shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->ids1)) this->group1.insert(atom);
-        if (is_match(atom, this->ids2)) this->group2.insert(atom);
-    });
+    group1 = AtomGroup(frame, ids1);
+    group2 = AtomGroup(frame, ids2);
+    pair_kernel = make_pair_kernel(group1.indices(), group2.indices(), dist_cutoff,
+                                   [this]([[maybe_unused]] const CellList::Pair &pair) { cn_sum++; });
 }
 
+void CoordinateNumPerFrame::register_pair_kernels_impl(PairKernelDriver &driver) { driver.add(pair_kernel); }
+
+void CoordinateNumPerFrame::reserve_frames_impl(std::size_t frames) { cn_list.reserve(cn_list.size() + frames); }
+
 void CoordinateNumPerFrame::setParameters(const AmberMask &M, const AmberMask &L, double cutoff,
                                           const std::string &out) {
     ids1 = M;
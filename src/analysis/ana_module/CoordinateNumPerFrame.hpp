@@ -10,7 +10,9 @@
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/PairKernel.hpp"
 #include "utils/common.hpp"
 
 class Frame;
@@ -31,15 +33,23 @@ public:
 
     void setParameters(const AmberMask &M, const AmberMask &L, double cutoff, const std::string &out);
 
+protected:
+    void register_pair_kernels_impl(PairKernelDriver &driver) override;
+
+    void reserve_frames_impl(std::size_t frames) override;
+
 private:
     AmberMask ids1;
     AmberMask ids2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
+
+    std::shared_ptr<PairKernel> pair_kernel;
 
     double dist_cutoff;
-    std::list<int> cn_list;
+    int cn_sum = 0; // pairs of the current frame
+    std::vector<int> cn_list;
 };
 
 #endif  // TINKER_COORDINATENUMPERFRAME_HPP
@@ -17,23 +17,25 @@ Diffuse::Diffuse() {
 }
 
 void Diffuse::process(std::shared_ptr<Frame> &frame) {
-    int mol_index = 0;
+    if (steps == total_frame_number) return;
     if (steps == 0) {
-        xyzcm.resize(total_frame_number, mols.size());
+        last_xyzcm.clear();
         for (auto &mol : mols) {
-            xyzcm(steps, mol_index) = mol->calc_weigh_center(frame);
-            mol_index++;
+            last_xyzcm.push_back(mol->calc_weigh_center(frame));
         }
     } else {
+        int mol_index = 0;
         for (auto &mol : mols) {
-            auto coord = mol->calc_weigh_center(frame);
-            auto &xyzold = xyzcm(steps - 1, mol_index);
-            auto r = coord - xyzold;
+            auto &xyzold = last_xyzcm[mol_index];
+            auto r = mol->calc_weigh_center(frame) - xyzold;
             frame->image(r);
-            xyzcm(steps, mol_index) = r + xyzold;
+            xyzold += r;
             mol_index++;
         }
     }
+    for (auto &[x, y, z] : last_xyzcm) {
+        xyzcm.push_back({float(x), float(y), float(z)});
+    }
     steps++;
 }
 
@@ -44,10 +46,9 @@ void Diffuse::print(std::ostream &os) {
         std::vector<std::tuple<double, double, double>, tbb::tbb_allocator<std::tuple<double, double, double>>> msd;
 
         int total_mol;
-        Eigen::Matrix<std::tuple<double, double, double>, Eigen::Dynamic, Eigen::Dynamic> &xyzcm;
+        const ChunkedArray<std::array<float, 3>> &xyzcm;
 
-        Body(int total_frame_number, int total_mol,
-             Eigen::Matrix<std::tuple<double, double, double>, Eigen::Dynamic, Eigen::Dynamic> &xyzcm)
+        Body(int total_frame_number, int total_mol, const ChunkedArray<std::array<float, 3>> &xyzcm)
             : total_frame_number(total_frame_number), msd(total_frame_number - 1), total_mol(total_mol), xyzcm(xyzcm) {}
 
         Body(const Body &body, tbb::split)
@@ -67,20 +68,24 @@ void Diffuse::print(std::ostream &os) {
                 for (int j = i + 1; j < total_frame_number; j++) {
                     int m = j - i - 1;
                     for (int k = 0; k < total_mol; k++) {
-                        auto [xr, yr, zr] = xyzcm(j, k) - xyzcm(i, k);
+                        auto &ri = xyzcm[std::size_t(i) * total_mol + k];
+                        auto &rj = xyzcm[std::size_t(j) * total_mol + k];
+                        double xr = rj[0] - ri[0];
+                        double yr = rj[1] - ri[1];
+                        double zr = rj[2] - ri[2];
                         msd[m] += std::make_tuple(xr * xr, yr * yr, zr * zr);
                     }
                 }
             }
         }
-    } body(total_frame_number, mols.size(), xyzcm);
+    } body(steps, mols.size(), xyzcm);
 
-    tbb::parallel_reduce(tbb::blocked_range<int>(0, total_frame_number - 1), body);
+    tbb::parallel_reduce(tbb::blocked_range<int>(0, steps - 1), body);
 
     constexpr double dunits = 10.0;
 
-    for (int i = 0; i < total_frame_number - 1; i++) {
-        auto counts = mols.size() * (total_frame_number - (i + 1));
+    for (int i = 0; i < steps - 1; i++) {
+        auto counts = mols.size() * (steps - (i + 1));
         body.msd[i] /= counts;
     }
 
@@ -88,7 +93,7 @@ void Diffuse::print(std::ostream &os) {
     os << "    Time Gap      X MSD       Y MSD       Z MSD       R MSD      Diff Const\n";
     os << "      (ps)       (Ang^2)     (Ang^2)     (Ang^2)     (Ang^2)   (x 10^-5 cm**2/sec)\n";
 
-    for (int i = 0; i < total_frame_number - 1; i++) {
+    for (int i = 0; i < steps - 1; i++) {
         double delta = time_increment_ps * (i + 1);
         auto [xvalue, yvalue, zvalue] = body.msd[i];
         double rvalue = xvalue + yvalue + zvalue;
@@ -5,11 +5,12 @@
 #ifndef TINKER_DIFFUSE_HPP
 #define TINKER_DIFFUSE_HPP
 
-#include <Eigen/Eigen>
+#include <array>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/CompactSeries.hpp"
 #include "utils/common.hpp"
 #include "utils/std.hpp"
 
@@ -45,7 +46,11 @@ private:
     int steps = 0;
     double time_increment_ps = 0.1;
 
-    Eigen::Matrix<std::tuple<double, double, double>, Eigen::Dynamic, Eigen::Dynamic> xyzcm;
+    // unwrapped mass centers in float, frame by frame, xyzcm[step * mols.size() + mol_index]
+    ChunkedArray<std::array<float, 3>> xyzcm;
+
+    // unwrapped mass centers of the last frame in double, so rounding of xyzcm never accumulates
+    std::vector<std::tuple<double, double, double>> last_xyzcm;
 };
 
 #endif  // TINKER_DIFFUSE_HPP
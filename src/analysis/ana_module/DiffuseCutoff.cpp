@@ -1,8 +1,6 @@
 
 #include "DiffuseCutoff.hpp"
 
-#include <boost/range/algorithm.hpp>
-
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
 #include "utils/common.hpp"
@@ -24,29 +22,33 @@ auto DiffuseCutoff::find_in(int seq) {
 }
 
 void DiffuseCutoff::process(std::shared_ptr<Frame> &frame) {
-    for (auto &ref : group1) {
-        for (auto &atom2 : group2) {
-            auto it = find_in(atom2->molecule.lock()->seq());
-            if (atom_distance2(ref, atom2, frame) < cutoff2) {
-                // in the shell
-                auto coord = atom2->molecule.lock()->calc_weigh_center(frame);
-                if (it != inner_atoms.end()) {
-                    auto &old = it->list_ptr->back();
-                    auto shift = coord - old;
-                    frame->image(shift);
-                    it->list_ptr->push_back(shift + old);
-                } else {
-                    auto list_ptr = std::make_shared<std::deque<std::tuple<double, double, double>>>();
-                    list_ptr->push_back(coord);
-                    inner_atoms.insert(InnerAtom(atom2->molecule.lock()->seq(), list_ptr));
-                    rcm.emplace_back(list_ptr);
-                }
+    const auto &pairs = neighbor_list->search(*frame);
+    auto pair = pairs.begin();
+    for (std::size_t i = 0; i < group1.size(); ++i) {
+        shell_molecules.clear();
+        for (; pair != pairs.end() and pair->i == i; ++pair) {
+            if (pair->distance2 >= cutoff2) continue;
+            // in the shell
+            auto mol = group2.atom(pair->j)->molecule.lock();
+            shell_molecules.push_back(mol->seq());
+            auto it = find_in(mol->seq());
+            auto coord = mol->calc_weigh_center(frame);
+            if (it != inner_atoms.end()) {
+                auto &old = it->list_ptr->back();
+                auto shift = coord - old;
+                frame->image(shift);
+                it->list_ptr->push_back(shift + old);
             } else {
-                if (it != inner_atoms.end()) {
-                    inner_atoms.erase(it);
-                }
+                auto list_ptr = std::make_shared<std::deque<std::tuple<double, double, double>>>();
+                list_ptr->push_back(coord);
+                inner_atoms.insert(InnerAtom(mol->seq(), list_ptr));
+                rcm.emplace_back(list_ptr);
             }
         }
+        // out of the shell
+        std::erase_if(inner_atoms, [this](const InnerAtom &atom) {
+            return std::find(shell_molecules.begin(), shell_molecules.end(), atom.index) == shell_molecules.end();
+        });
     }
 }
 
@@ -146,10 +148,9 @@ void DiffuseCutoff::setParameters(const AmberMask &M, const AmberMask &L, double
 }
 
 void DiffuseCutoff::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    boost::for_each(frame->atom_list, [this](std::shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->mask1)) this->group1.insert(atom);
-        if (is_match(atom, this->mask2)) this->group2.insert(atom);
-    });
+    group1 = AtomGroup(frame, mask1);
+    group2 = AtomGroup(frame, mask2);
+    neighbor_list = NeighborList::shared(group1.indices(), group2.indices(), std::sqrt(cutoff2));
     if (group1.size() > 1) {
         std::cerr << "the reference(metal cation) atom for DiffuseCutoff function can only have one\n";
         exit(EXIT_FAILURE);
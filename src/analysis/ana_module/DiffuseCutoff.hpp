@@ -9,7 +9,9 @@
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
 #include "utils/std.hpp"
 
 class Frame;
@@ -62,11 +64,16 @@ private:
     AmberMask mask1;
     AmberMask mask2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
+
+    std::shared_ptr<NeighborList> neighbor_list;
 
     std::unordered_set<InnerAtom, InnerAtomHasher> inner_atoms;
 
+    // molecule seq of the atoms in the shell of the current reference atom
+    std::vector<int> shell_molecules;
+
     std::deque<std::shared_ptr<std::deque<std::tuple<double, double, double>>>> rcm;
 
     auto find_in(int seq);
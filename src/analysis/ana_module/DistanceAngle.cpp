@@ -3,6 +3,7 @@
 
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
+#include "utils/Geometry.hpp"
 #include "utils/ThrowAssert.hpp"
 #include "utils/common.hpp"
 
@@ -28,26 +29,28 @@ void DistanceAngle::processFirstFrame(std::shared_ptr<Frame> &frame) {
         }
     }
     throw_assert(!pairs.empty(), "Atom selection semtatic error ! not atom1 & atom2 selected!");
+    for (auto &atom3 : group3) {
+        group3_indices.push_back(atom3->index);
+    }
+    row_triplets.resize(group3_indices.size());
+    row_pairs.resize(group3_indices.size());
+    row_angles.resize(group3_indices.size());
+    row_distances.resize(group3_indices.size());
 }
 
 void DistanceAngle::process(std::shared_ptr<Frame> &frame) {
     for (auto &[ref, atom2] : pairs) {
-        auto r = atom2->getCoordinate() - ref->getCoordinate();
-        frame->image(r);
-
-        r /= vector_norm(r);
-
-        for (auto &atom3 : group3) {
-            auto v = atom3->getCoordinate() - ref->getCoordinate();
-            frame->image(v);
-
-            auto dist = vector_norm(v);
-
-            v /= dist;
+        for (std::size_t k = 0; k < group3_indices.size(); ++k) {
+            row_triplets[k] = {atom2->index, ref->index, group3_indices[k]};
+            row_pairs[k] = {ref->index, group3_indices[k]};
+        }
+        atom_angles(*frame, row_triplets, row_angles);
+        atom_distances(*frame, row_pairs, row_distances);
 
-            auto _cos = dot_multiplication(r, v);
+        for (std::size_t k = 0; k < group3_indices.size(); ++k) {
+            auto dist = row_distances[k];
 
-            auto angle = std::abs(acos(_cos) * radian - 90.0);
+            auto angle = std::abs(row_angles[k] - 90.0);
 
             int i_distance_bin = int(dist / distance_width) + 1;
             int i_angle_bin = int(angle / angle_width) + 1;
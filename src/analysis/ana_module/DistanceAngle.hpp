@@ -2,6 +2,7 @@
 #ifndef TINKER_DISTANCEANGLE_HPP
 #define TINKER_DISTANCEANGLE_HPP
 
+#include <array>
 #include <list>
 #include <map>
 #include <memory>
@@ -36,6 +37,12 @@ protected:
 
     std::unordered_set<std::shared_ptr<Atom>> group3;
 
+    // per pair, the index tuples against all of group3 and their geometry, reused every row
+    std::vector<std::size_t> group3_indices;
+    std::vector<std::array<std::size_t, 3>> row_triplets;
+    std::vector<std::array<std::size_t, 2>> row_pairs;
+    std::vector<double> row_angles, row_distances;
+
     double distance_width;
     double angle_width;
 
@@ -2,6 +2,10 @@
 
 #include "FirstCoordExchangeSearch.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
 #include "data_structure/frame.hpp"
 #include "utils/common.hpp"
 
@@ -10,35 +14,58 @@ FirstCoordExchangeSearch::FirstCoordExchangeSearch() { enable_outfile = true; }
 void FirstCoordExchangeSearch::process(std::shared_ptr<Frame> &frame) {
     step++;
 
-    for (auto &atom1 : group1) {
-        for (auto &atom2 : group2) {
+    /*
+     *  only atoms within dist_cutoff + tol_dist of a reference atom, or inner before it, can change state.
+     *  Those candidates are visited in the order of group2, inner atoms out of the search have no distance
+     */
+    const auto &pairs = neighbor_list->search(*frame);
+    auto pair = pairs.begin();
+    for (std::size_t i = 0; i < group1.size(); ++i) {
+        candidates.clear();
+        for (; pair != pairs.end() and pair->i == i; ++pair) {
+            candidates.push_back(*pair);
+        }
+        for (auto j : inner_members) {
+            candidates.push_back({static_cast<std::uint32_t>(i), j, std::numeric_limits<double>::max()});
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+            return std::tie(lhs.j, lhs.distance2) < std::tie(rhs.j, rhs.distance2);
+        });
+        candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                     [](const auto &lhs, const auto &rhs) { return lhs.j == rhs.j; }),
+                         candidates.end());
+
+        inner_members.clear();
+        for (const auto &candidate : candidates) {
+            const auto j = candidate.j;
+            const double distance = std::sqrt(candidate.distance2);
+            const int seq = group2.atom(j)->seq;
+            auto &state = state_machine[j];
             if (step == 1) {
-                State state;
-                state.inner = atom_distance(atom1, atom2, frame) <= this->dist_cutoff;
-                state_machine[atom2->seq] = state;
-                if (state.inner) init_seq_in_shell.insert(atom2->seq);
+                state.inner = distance <= this->dist_cutoff;
+                if (state.inner) init_seq_in_shell.insert(seq);
             } else {
-                auto &state = state_machine[atom2->seq];
                 if (state.inner) {
-                    if (atom_distance(atom1, atom2, frame) >= this->dist_cutoff + tol_dist) {
+                    if (distance >= this->dist_cutoff + tol_dist) {
                         state.inner = false;
                         ExchangeItem item;
-                        item.seq = atom2->seq;
+                        item.seq = seq;
                         item.direction = Direction::OUT;
                         item.exchange_frame = step;
                         exchange_list.push_back(item);
                     }
                 } else {
-                    if (atom_distance(atom1, atom2, frame) <= this->dist_cutoff - tol_dist) {
+                    if (distance <= this->dist_cutoff - tol_dist) {
                         state.inner = true;
                         ExchangeItem item;
-                        item.seq = atom2->seq;
+                        item.seq = seq;
                         item.direction = Direction::IN;
                         item.exchange_frame = step;
                         exchange_list.push_back(item);
                     }
                 }
             }
+            if (state.inner) inner_members.push_back(j);
         }
     }
 }
@@ -83,8 +110,8 @@ void FirstCoordExchangeSearch::readInfo() {
 }
 
 void FirstCoordExchangeSearch::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    std::for_each(frame->atom_list.begin(), frame->atom_list.end(), [this](std::shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->ids1)) this->group1.insert(atom);
-        if (is_match(atom, this->ids2)) this->group2.insert(atom);
-    });
-}
\ No newline at end of file
+    group1 = AtomGroup(frame, ids1);
+    group2 = AtomGroup(frame, ids2);
+    state_machine.assign(group2.size(), State{});
+    neighbor_list = NeighborList::shared(group1.indices(), group2.indices(), dist_cutoff + tol_dist);
+}
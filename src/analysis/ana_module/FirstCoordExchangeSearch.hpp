@@ -4,16 +4,17 @@
 #define TINKER_FIRSTCOORDEXCHANGESEARCH_HPP
 
 #include <list>
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
-#include <unordered_set>
+#include <vector>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "data_structure/frame.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
 
 class Frame;
 
@@ -35,8 +36,8 @@ private:
     AmberMask ids1;
     AmberMask ids2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
 
     double dist_cutoff, tol_dist, time_cutoff;
     enum class Direction { IN, OUT };
@@ -53,7 +54,12 @@ private:
     typedef struct {
         bool inner;
     } State;
-    std::map<int, State> state_machine;
+    // indexed by position in group2
+    std::vector<State> state_machine;
+
+    std::shared_ptr<NeighborList> neighbor_list;
+    std::vector<CellList::Pair> candidates;
+    std::vector<std::uint32_t> inner_members; // positions in group2 with inner state, in order
 
     std::set<int> init_seq_in_shell;
 };
@@ -2,14 +2,14 @@
 // Created by xiamr on 6/14/19.
 //
 
-#include <boost/range/adaptor/indexed.hpp>
-#include <boost/range/algorithm.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include "HBond.hpp"
 
 #include "data_structure/atom.hpp"
 #include "data_structure/forcefield.hpp"
 #include "data_structure/frame.hpp"
+#include "data_structure/topology.hpp"
 #include "utils/common.hpp"
 
 using namespace std;
@@ -59,21 +59,16 @@ void HBond::print(std::ostream &os) {
     os << "#distance cutoff : " << donor_acceptor_dist_cutoff << '\n';
     os << "#angle cutoff : " << angle_cutoff << '\n';
     os << std::string(20, '#') << '\n';
-    // os << boost::format("#%14s %14s\n") % "Frame" % "Number";
-    // for (const auto &element : hbdist | boost::adaptors::indexed(1)) {
-    //     os << boost::format("%15d %14d\n") % element.index() % element.value().size();
-    // }
-    // os << std::string(20, '#') << '\n';
     output_distance_statistics(os);
 }
 
 void HBond::process(std::shared_ptr<Frame> &frame) {
-    // hbdist.emplace_back();
-    residue_map.emplace_back();
+    residue_contacts.begin_frame();
     if (mode == Selector::Both)
         Selector_Both(frame);
     else
         Selector_Donor_Acceptor(frame);
+    residue_contacts.end_frame();
 }
 
 void HBond::readInfo() {
@@ -96,11 +91,8 @@ void HBond::readInfo() {
 
 void HBond::setParameters(const AmberMask &donor, const AmberMask &acceptor, double distance, double angle,
                           std::string criteria, const std::string &outfilename) {
-    if (donor == acceptor) {
-        mode = Selector::Both;
-    } else {
-        mode = Selector::Donor;
-    }
+    mask1 = donor;
+    mask2 = acceptor;
     mode = donor == acceptor ? Selector::Both : Selector::Donor;
 
     boost::trim(criteria);
@@ -120,107 +112,74 @@ void HBond::setParameters(const AmberMask &donor, const AmberMask &acceptor, dou
 }
 
 void HBond::Selector_Donor_Acceptor(const std::shared_ptr<Frame> &frame) {
-    for (const auto &[donor, hydrogen] : donor_hydrogens) {
-        for (const auto &acceptor : acceptors) {
-            check_hbond(donor, hydrogen, acceptor, frame);
-        }
+    for (const auto &[i, j, distance2] : neighbor_list->search(*frame)) {
+        const auto &[donor, hydrogen] = donor_hydrogens[i];
+        check_hbond(donor, hydrogen, acceptors.indices()[j], distance2, frame);
     }
 }
 
 void HBond::Selector_Both(const std::shared_ptr<Frame> &frame) {
-    for (const auto &[donor, hydrogen] : donor_hydrogens) {
-        for (const auto &acceptor : acceptors) {
-            if (donor not_eq acceptor) check_hbond(donor, hydrogen, acceptor, frame);
-        }
+    for (const auto &[i, j, distance2] : neighbor_list->search(*frame)) {
+        const auto &[donor, hydrogen] = donor_hydrogens[i];
+        const auto acceptor = acceptors.indices()[j];
+        if (donor not_eq acceptor) check_hbond(donor, hydrogen, acceptor, distance2, frame);
     }
 }
 
 void HBond::processFirstFrame(std::shared_ptr<Frame> &frame) {
+    std::vector<std::shared_ptr<Atom>> acceptor_atoms;
+    residue_keys.assign(frame->atom_list.size(), 0);
     for (const auto &atom : frame->atom_list) {
         if (is_match(atom, mask1)) {
             auto symbol = which(atom);
             if (symbol == Symbol::Hydrogen) {
-                const auto &donor = frame->atom_map[atom->con_list.front()];
+                const auto &donor = frame->atom_list[frame->topology->bonded(atom->index).front()];
                 if (donor_acceptor_symbols.contains(which(donor))) {
-                    donor_hydrogens.emplace_back(std::array{donor, atom});
+                    donor_hydrogens.push_back({donor->index, atom->index});
                 }
             } else if (mode == Selector::Both and donor_acceptor_symbols.contains(symbol))
-                acceptors.push_back(atom);
+                acceptor_atoms.push_back(atom);
         }
         if (mode not_eq Selector::Both and is_match(atom, mask2) and donor_acceptor_symbols.contains(which(atom)))
-            acceptors.push_back(atom);
+            acceptor_atoms.push_back(atom);
     };
+    acceptors = AtomGroup(frame, acceptor_atoms);
+    for (const auto &[donor, hydrogen] : donor_hydrogens) {
+        donor_atoms.push_back(donor);
+    }
+    const auto donor_keys = residue_contacts.residue_keys(*frame, donor_atoms);
+    for (std::size_t i = 0; i < donor_atoms.size(); i++) {
+        residue_keys[donor_atoms[i]] = donor_keys[i];
+    }
+    neighbor_list = NeighborList::shared(donor_atoms, acceptors.indices(), donor_acceptor_dist_cutoff);
 }
 
-bool HBond::check_hbond(const std::shared_ptr<Atom> &donor, const std::shared_ptr<Atom> &hydrogen,
-                        const std::shared_ptr<Atom> &acceptor, const std::shared_ptr<Frame> &frame) {
-    if (atom_distance(donor, acceptor, frame) <= donor_acceptor_dist_cutoff) {
-        auto v1 = hydrogen->getCoordinate() - donor->getCoordinate();
-        frame->image(v1);
-        auto len1 = vector_norm2(v1);
-
-        auto v2 = acceptor->getCoordinate() -
-                  (hbond_type == HBondType::GMXVersion ? donor->getCoordinate() : hydrogen->getCoordinate());
-        frame->image(v2);
-        auto len2 = vector_norm2(v2);
-
-        auto cosine = dot_multiplication(v1, v2) / std::sqrt(len1 * len2);
-        if (std::abs(radian * std::acos(cosine)) <= angle_cutoff) {
-            record_hbond(donor, acceptor, frame);
-            return true;
-        }
+void HBond::reserve_frames_impl(std::size_t frames) { residue_contacts.reserve(frames); }
+
+bool HBond::check_hbond(std::size_t donor, std::size_t hydrogen, std::size_t acceptor, double distance2,
+                        const std::shared_ptr<Frame> &frame) {
+    const auto &x = frame->x;
+    const auto &y = frame->y;
+    const auto &z = frame->z;
+    std::tuple<double, double, double> v1{x[hydrogen] - x[donor], y[hydrogen] - y[donor], z[hydrogen] - z[donor]};
+    frame->image(v1);
+    auto len1 = vector_norm2(v1);
+
+    auto origin = hbond_type == HBondType::GMXVersion ? donor : hydrogen;
+    std::tuple<double, double, double> v2{x[acceptor] - x[origin], y[acceptor] - y[origin], z[acceptor] - z[origin]};
+    frame->image(v2);
+    auto len2 = vector_norm2(v2);
+
+    auto cosine = dot_multiplication(v1, v2) / std::sqrt(len1 * len2);
+    if (std::abs(radian * std::acos(cosine)) <= angle_cutoff) {
+        record_hbond(donor, std::sqrt(distance2));
+        return true;
     }
     return false;
 }
 
-void HBond::record_hbond(const std::shared_ptr<Atom> &donor, const std::shared_ptr<Atom> &acceptor,
-                         const std::shared_ptr<Frame> &frame) {
-    auto distance = atom_distance(donor, acceptor, frame);
-    // hbdist.back()[std::array{donor, acceptor}] = distance;
-
-    auto key = donor->residue_name.value() + std::to_string(donor->residue_num.value());
-    auto &last = residue_map.back();
-    if (auto it = last.find(key); it != std::end(last)) {
-        it->second = std::min(it->second, distance);
-    } else {
-        last.emplace(key, distance);
-    }
+void HBond::record_hbond(std::size_t donor, double distance) {
+    residue_contacts.record(residue_keys[donor], distance);
 }
 
-void HBond::output_distance_statistics(std::ostream &os) {
-    std::map<std::string, std::size_t> countor_map;
-    for (auto &seq : residue_map) {
-        for (auto &[key, value] : seq) {
-            ++countor_map[key];
-        }
-    }
-    std::vector<std::pair<std::string, std::size_t>> countor(begin(countor_map), end(countor_map));
-
-    boost::sort(countor, [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
-
-    os << "#Frame ";
-    for (const auto &p : countor) {
-        os << std::setw(15) << p.first;
-    }
-    os << '\n';
-    os << std::string(7 + 15 * countor.size(), '#') << '\n';
-    os << "# Count";
-    for (const auto &p : countor) {
-        os << std::setw(15) << p.second;
-    }
-    os << '\n';
-    os << std::string(7 + 15 * countor.size(), '#') << '\n';
-
-    for (const auto &element : residue_map | boost::adaptors::indexed(1)) {
-        os << std::setw(7) << element.index();
-        const auto &hb_distances = element.value();
-        for (const auto &[key, value] : countor) {
-            if (auto it = hb_distances.find(key); it != hb_distances.end()) {
-                os << std::setw(15) << it->second;
-            } else {
-                os << std::setw(15) << "";
-            }
-        }
-        os << '\n';
-    }
-}
+void HBond::output_distance_statistics(std::ostream &os) { residue_contacts.print_distance_table(os); }
@@ -5,7 +5,6 @@
 #ifndef TINKER_HBOND_HPP
 #define TINKER_HBOND_HPP
 
-#include <map>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -13,7 +12,10 @@
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
+#include "utils/ResidueContactSeries.hpp"
 
 class Frame;
 
@@ -42,21 +44,27 @@ public:
     void setParameters(const AmberMask &donor, const AmberMask &acceptor, double distance, double angle,
                        std::string criteria, const std::string &outfilename);
 
+protected:
+    void reserve_frames_impl(std::size_t frames) override;
+
 private:
     void Selector_Both(const std::shared_ptr<Frame> &frame);
 
     void Selector_Donor_Acceptor(const std::shared_ptr<Frame> &frame);
 
-    bool check_hbond(const std::shared_ptr<Atom> &donor, const std::shared_ptr<Atom> &hydrogen,
-                     const std::shared_ptr<Atom> &acceptor, const std::shared_ptr<Frame> &frame);
+    // donor, hydrogen and acceptor are Atom::index, distance2 the squared donor-acceptor distance within the cutoff
+    bool check_hbond(std::size_t donor, std::size_t hydrogen, std::size_t acceptor, double distance2,
+                     const std::shared_ptr<Frame> &frame);
 
-    void record_hbond(const std::shared_ptr<Atom> &donor, const std::shared_ptr<Atom> &acceptor,
-                      const std::shared_ptr<Frame> &frame);
+    void record_hbond(std::size_t donor, double distance);
 
     AmberMask mask1, mask2;
 
-    std::vector<std::array<std::shared_ptr<Atom>, 2>> donor_hydrogens;
-    std::vector<std::shared_ptr<Atom>> acceptors;
+    std::vector<std::array<std::size_t, 2>> donor_hydrogens;
+    std::vector<std::size_t> donor_atoms; // donor of every entry of donor_hydrogens
+    AtomGroup acceptors;
+
+    std::shared_ptr<NeighborList> neighbor_list;
 
     HBondType hbond_type = HBondType::VMDVerion;
 
@@ -64,9 +72,9 @@ private:
     double donor_acceptor_dist_cutoff;
     double angle_cutoff;
 
-    std::deque<std::map<std::array<std::shared_ptr<Atom>, 2>, double>> hbdist;
+    std::vector<std::uint32_t> residue_keys; // key in residue_contacts of every donor, indexed by Atom::index
 
-    std::deque<std::map<std::string, double>> residue_map;
+    ResidueContactSeries residue_contacts;
 
     inline static const std::set<Symbol> donor_acceptor_symbols{Symbol::Oxygen, Symbol::Nitrogen, Symbol::Sulfur};
 
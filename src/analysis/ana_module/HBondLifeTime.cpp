@@ -8,6 +8,7 @@
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
+#include "data_structure/topology.hpp"
 #include "utils/ThrowAssert.hpp"
 #include "utils/common.hpp"
 
@@ -35,7 +36,7 @@ void HBondLifeTime::process(std::shared_ptr<Frame> &frame) {
     int vector_shift = 0;
 
     for (auto &hydrogen : hydrogens) {
-        auto o1 = frame->atom_map[hydrogen->con_list.front()];
+        const auto &o1 = frame->atom_list[frame->topology->bonded(hydrogen->index).front()];
         int hbond_dest_oxygen_num = 0;
         for (auto &o2 : oxygens) {
             if (o2 != o1 and atom_distance(o2, o1, frame) <= dist_R_cutoff) {
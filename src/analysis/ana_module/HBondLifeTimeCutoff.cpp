@@ -31,51 +31,73 @@ void HBondLifeTimeCutoff::processFirstFrame(std::shared_ptr<Frame> &frame) {
                     }
                 }
                 water_struct.emplace_back(atom, hydrogens);
+                Ow_atoms.push_back(atom->index);
             } else if (is_match(atom, center_Metal_atom_mask)) {
                 metal.emplace(atom);
             }
         }
     }
     throw_assert(metal.size() == 1, "Only one metal atom is allowed!");
+    metal_atoms.push_back((*metal.begin())->index);
+    shell_list = NeighborList::shared(metal_atoms, Ow_atoms, std::sqrt(cutoff2));
+    hbond_cell_list.set_cutoff(dist_R_cutoff);
 }
 
 void HBondLifeTimeCutoff::process(std::shared_ptr<Frame> &frame) {
-    for (auto &ref : metal) {
-        for (auto &[Ow, hydrogens] : water_struct) {
-            auto it = find_in(Ow->molecule.lock()->seq());
-            if (atom_distance2(ref, Ow, frame) < cutoff2) {
-                // in the shell
-                auto &o1 = Ow;
-                if (it != inner_atoms.end()) {
-                    it->list_ptr1->push_back(find_hbond(o1, hydrogens[0], frame));
-                    it->list_ptr2->push_back(find_hbond(o1, hydrogens[1], frame));
-                } else {
-                    auto list_ptr1 = std::make_shared< std::deque<int>>();
-                    auto list_ptr2 = std::make_shared< std::deque<int>>();
-                    list_ptr1->push_back(find_hbond(o1, hydrogens[0], frame));
-                    list_ptr2->push_back(find_hbond(o1, hydrogens[1], frame));
-
-                    inner_atoms.insert(InnerAtom(Ow->molecule.lock()->seq(), list_ptr1, list_ptr2));
-                    hb_histroy.emplace_back(list_ptr1);
-                    hb_histroy.emplace_back(list_ptr2);
-                }
-            } else {
-                if (it != inner_atoms.end()) {
-                    inner_atoms.erase(it);
-                }
-            }
+    // waters in the shell, then the oxygens around each of them
+    shell_waters.clear();
+    shell_oxygens.clear();
+    for (const auto &pair : shell_list->search(*frame)) {
+        if (pair.distance2 < cutoff2) {
+            shell_waters.push_back(pair.j);
+            shell_oxygens.push_back(Ow_atoms[pair.j]);
+        }
+    }
+    const auto &neighbors = hbond_cell_list.search(*frame, shell_oxygens, Ow_atoms);
+
+    auto first = neighbors.begin();
+    shell_molecules.clear();
+    for (std::size_t k = 0; k < shell_waters.size(); ++k) {
+        auto last = first;
+        while (last != neighbors.end() and last->i == k) ++last;
+        const std::span<const CellList::Pair> around(first, last);
+        first = last;
+
+        const auto o1 = shell_waters[k];
+        auto &[Ow, hydrogens] = water_struct[o1];
+        const int seq = Ow->molecule.lock()->seq();
+        shell_molecules.push_back(seq);
+        auto it = find_in(seq);
+        // in the shell
+        if (it != inner_atoms.end()) {
+            it->list_ptr1->push_back(find_hbond(o1, hydrogens[0], around, frame));
+            it->list_ptr2->push_back(find_hbond(o1, hydrogens[1], around, frame));
+        } else {
+            auto list_ptr1 = std::make_shared< std::deque<int>>();
+            auto list_ptr2 = std::make_shared< std::deque<int>>();
+            list_ptr1->push_back(find_hbond(o1, hydrogens[0], around, frame));
+            list_ptr2->push_back(find_hbond(o1, hydrogens[1], around, frame));
+
+            inner_atoms.insert(InnerAtom(seq, list_ptr1, list_ptr2));
+            hb_histroy.emplace_back(list_ptr1);
+            hb_histroy.emplace_back(list_ptr2);
         }
     }
+    // out of the shell
+    std::erase_if(inner_atoms, [this](const InnerAtom &atom) {
+        return std::find(shell_molecules.begin(), shell_molecules.end(), atom.index) == shell_molecules.end();
+    });
 }
 
-int HBondLifeTimeCutoff::find_hbond(const std::shared_ptr<Atom> &o1, const std::shared_ptr<Atom> &hydrogen,
-                                    std::shared_ptr<Frame> &frame) const {
+int HBondLifeTimeCutoff::find_hbond(std::size_t o1, const std::shared_ptr<Atom> &hydrogen,
+                                    std::span<const CellList::Pair> neighbors, std::shared_ptr<Frame> &frame) const {
     int hbond_dest_oxygen_num = 0;
-    for (auto &ele : water_struct) {
-        auto &o2 = ele.first;
-        if (o2 != o1 and atom_distance(o2, o1, frame) <= dist_R_cutoff) {
-            auto o1_h_vector = hydrogen->getCoordinate() - o1->getCoordinate();
-            auto o1_o2_vector = o2->getCoordinate() - o1->getCoordinate();
+    const auto &oxygen1 = water_struct[o1].first;
+    for (const auto &neighbor : neighbors) {
+        auto &o2 = water_struct[neighbor.j].first;
+        if (o2 != oxygen1) {
+            auto o1_h_vector = hydrogen->getCoordinate() - oxygen1->getCoordinate();
+            auto o1_o2_vector = o2->getCoordinate() - oxygen1->getCoordinate();
 
             frame->image(o1_h_vector);
             frame->image(o1_o2_vector);
@@ -6,10 +6,13 @@
 #define TINKER_HBONDLIFETIMECUTOFF_HPP
 
 #include <boost/container_hash/hash.hpp>
+#include <span>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/CellList.hpp"
+#include "utils/NeighborList.hpp"
 #include "utils/std.hpp"
 
 class Frame;
@@ -72,13 +75,26 @@ protected:
     //  Ow, Hw
     std::vector<std::pair<std::shared_ptr<Atom>, std::deque<std::shared_ptr<Atom>>>> water_struct;
 
+    // Atom::index of the metal and of the oxygens of water_struct
+    std::vector<std::size_t> metal_atoms;
+    std::vector<std::size_t> Ow_atoms;
+
+    std::shared_ptr<NeighborList> shell_list;
+    CellList hbond_cell_list;
+
+    // positions in water_struct of the waters in the shell, their oxygens and molecule seq
+    std::vector<std::size_t> shell_waters;
+    std::vector<std::size_t> shell_oxygens;
+    std::vector<int> shell_molecules;
+
     [[nodiscard]] virtual std::vector<double> calculateAcf() const;
 
     void printData(std::ostream &os, const std::vector<double> &acf, std::string_view title) const;
 
     auto find_in(int seq);
 
-    int find_hbond(const std::shared_ptr<Atom> &o1, const std::shared_ptr<Atom> &hydrogen,
+    // o1 is a position in water_struct, neighbors the oxygens within dist_R_cutoff of it in the order of water_struct
+    int find_hbond(std::size_t o1, const std::shared_ptr<Atom> &hydrogen, std::span<const CellList::Pair> neighbors,
                    std::shared_ptr<Frame> &frame) const;
 };
 
@@ -5,7 +5,7 @@
 #include "HBondSpread.hpp"
 
 #include <boost/range/adaptors.hpp>
-#include <boost/range/algorithm.hpp>
+#include <numeric>
 
 #include "HBond.hpp"
 #include "data_structure/frame.hpp"
@@ -16,10 +16,11 @@
 HBondSpread::HBondSpread() { enable_outfile = true; }
 
 void HBondSpread::processFirstFrame(std::shared_ptr<Frame> &frame) {
+    std::unordered_map<int, std::size_t> Ow_positions;
     for (auto &mol : frame->molecule_list) {
         for (auto &atom : mol->atom_list) {
             if (is_match(atom, Ow_atom_mask)) {
-                Ow_mapping[atom->seq] = boost::add_vertex(atom->seq, g);
+                Ow_positions[atom->seq] = Ow.size();
                 Ow.emplace_back(atom);
                 for (auto &hydro : mol->atom_list) {
                     if (which(hydro) == Symbol::Hydrogen) {
@@ -32,12 +33,33 @@ void HBondSpread::processFirstFrame(std::shared_ptr<Frame> &frame) {
         }
     }
     throw_assert(metal.size() == 1, "Only one metal atom is allowed!");
+    // only hydrogens of Ow atoms donate
+    std::erase_if(hydrogens, [&](const auto &hydrogen) { return !Ow_positions.contains(hydrogen->con_list.front()); });
+    for (auto &hydrogen : hydrogens) {
+        hydrogen_owners.push_back(Ow_positions[hydrogen->con_list.front()]);
+    }
+    cluster_parent.resize(Ow.size());
+    cluster_near_metal.resize(Ow.size());
+}
+
+void HBondSpread::reserve_frames_impl(std::size_t frames) {
+    hbond_connected_num_and_max_distance.reserve(hbond_connected_num_and_max_distance.size() + frames);
+}
+
+std::size_t HBondSpread::find_cluster(std::size_t i) {
+    while (cluster_parent[i] != i) {
+        i = cluster_parent[i] = cluster_parent[cluster_parent[i]];
+    }
+    return i;
 }
 
 void HBondSpread::process(std::shared_ptr<Frame> &frame) {
-    for (auto &hydrogen : hydrogens) {
-        auto o1 = frame->atom_map[hydrogen->con_list.front()];
-        for (auto &o2 : Ow) {
+    std::iota(cluster_parent.begin(), cluster_parent.end(), 0);
+    for (std::size_t h = 0; h < hydrogens.size(); ++h) {
+        const auto &hydrogen = hydrogens[h];
+        const auto &o1 = Ow[hydrogen_owners[h]];
+        for (std::size_t k = 0; k < Ow.size(); ++k) {
+            const auto &o2 = Ow[k];
             if (o2 != o1 and atom_distance(o2, o1, frame) <= dist_R_cutoff) {
                 auto o1_h_vector = hydrogen->getCoordinate() - o1->getCoordinate();
                 auto o1_o2_vector = o2->getCoordinate() - o1->getCoordinate();
@@ -51,35 +73,32 @@ void HBondSpread::process(std::shared_ptr<Frame> &frame) {
                 auto angle = radian * acos(dot_multiplication(o1_h_vector, o1_o2_vector));
 
                 if (angle <= angle_HOO_cutoff) {
-                    boost::add_edge(Ow_mapping[o1->seq], Ow_mapping[o2->seq], g);
-                    //     std::cout << o1->seq << " <-> " << o2->seq << '\n';
+                    cluster_parent[find_cluster(hydrogen_owners[h])] = find_cluster(k);
                     break;
                 }
             }
         }
     }
     auto &m = *metal.begin();
-    std::unordered_set<int> hbond_connected;
-
-    for (auto &atom : Ow) {
-        if (atom_distance2(m, atom, frame) < cutoff2) {
-            MyVisitor vis(hbond_connected);
-            boost::depth_first_visit(
-                g, Ow_mapping[atom->seq], vis,
-                boost::make_vector_property_map<boost::default_color_type>(boost::get(boost::vertex_index, g)));
-            // std::cout << atom->seq << '\n';
+
+    // every cluster holding an Ow near the metal is connected to it
+    std::fill(cluster_near_metal.begin(), cluster_near_metal.end(), false);
+    for (std::size_t k = 0; k < Ow.size(); ++k) {
+        if (atom_distance2(m, Ow[k], frame) < cutoff2) {
+            cluster_near_metal[find_cluster(k)] = true;
         }
     }
 
+    int connected_num = 0;
     double max_distance2 = 0;
-
-    for (auto &atom : hbond_connected) {
-        max_distance2 = std::max(max_distance2, atom_distance2(m, frame->atom_map[atom], frame));
+    for (std::size_t k = 0; k < Ow.size(); ++k) {
+        if (cluster_near_metal[find_cluster(k)]) {
+            ++connected_num;
+            max_distance2 = std::max(max_distance2, atom_distance2(m, Ow[k], frame));
+        }
     }
 
-    hbond_connected_num_and_max_distance.emplace_back(hbond_connected.size(), std::sqrt(max_distance2));
-
-    boost::remove_edge_if([](auto) { return true; }, g);
+    hbond_connected_num_and_max_distance.emplace_back(connected_num, std::sqrt(max_distance2));
 }
 
 void HBondSpread::print(std::ostream &os) {
@@ -101,6 +120,25 @@ void HBondSpread::print(std::ostream &os) {
     os << std::string(50, '#') << '\n';
 }
 
+void HBondSpread::setParameters(const AmberMask &metal_mask, const AmberMask &Ow_mask, double dist_R,
+                                double angle_HOO, double cutoff, const std::string &outfilename) {
+    if (dist_R <= 0) {
+        throw std::runtime_error("dist_R_cutoff must large than zero");
+    }
+    if (angle_HOO <= 0) {
+        throw std::runtime_error("angle_HOO_cutoff must large than zero");
+    }
+    if (cutoff <= 0) {
+        throw std::runtime_error("cutoff must large than zero");
+    }
+    center_Metal_atom_mask = metal_mask;
+    Ow_atom_mask = Ow_mask;
+    dist_R_cutoff = dist_R;
+    angle_HOO_cutoff = angle_HOO;
+    cutoff2 = cutoff * cutoff;
+    setOutFilename(outfilename);
+}
+
 void HBondSpread::readInfo() {
     dist_R_cutoff = choose(0.0, 100.0, "Distance Cutoff(O-O) for Hydogen Bond [3.5 Ang] :", Default(3.5));
     angle_HOO_cutoff = choose(0.0, 100.0, "Angle Cutoff(H-O-O) for Hydogen Bond [30 degree] :", Default(30.0));
@@ -5,9 +5,6 @@
 #ifndef TINKER_HBONDSPREAD_HPP
 #define TINKER_HBONDSPREAD_HPP
 
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/depth_first_search.hpp>
-
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
 #include "dsl/AmberMask.hpp"
@@ -15,23 +12,6 @@
 
 class Frame;
 
-struct VertexNode {
-    typedef boost::vertex_property_tag kind;
-};
-
-class MyVisitor : public boost::default_dfs_visitor {
-public:
-    explicit MyVisitor(std::unordered_set<int> &all_connected_atoms) : all_connected_atoms(all_connected_atoms){};
-
-    template <typename Vertex, typename Graph>
-    void discover_vertex(Vertex v, const Graph &g) const {
-        all_connected_atoms.emplace(boost::get(VertexNode(), g, v));
-    }
-
-private:
-    std::unordered_set<int> &all_connected_atoms;
-};
-
 class HBondSpread : public AbstractAnalysis {
 public:
     HBondSpread();
@@ -46,7 +26,12 @@ public:
 
     [[nodiscard]] static std::string_view title() { return "Hydrogen Bond Spread Analysis"; }
 
+    void setParameters(const AmberMask &metal_mask, const AmberMask &Ow_mask, double dist_R, double angle_HOO,
+                       double cutoff, const std::string &outfilename);
+
 protected:
+    void reserve_frames_impl(std::size_t frames) override;
+
     AmberMask center_Metal_atom_mask;
     AmberMask Ow_atom_mask;
 
@@ -55,17 +40,18 @@ protected:
 
     double cutoff2;
 
-    typedef boost::adjacency_list<boost::setS, boost::vecS, boost::undirectedS, boost::property<VertexNode, int>>
-        graph_t;
-    graph_t g;
-
     std::unordered_set<std::shared_ptr<Atom>> metal;
     std::vector<std::shared_ptr<Atom>> Ow;
     std::vector<std::shared_ptr<Atom>> hydrogens;
+    std::vector<std::size_t> hydrogen_owners; // position in Ow of the oxygen bonded to each hydrogen
+
+    // scratch of the per-frame hydrogen bond network, Ow positions joined into clusters by union-find
+    std::vector<std::size_t> cluster_parent;
+    std::vector<char> cluster_near_metal;
 
-    std::unordered_map<int, boost::graph_traits<graph_t>::vertex_descriptor> Ow_mapping;
+    std::size_t find_cluster(std::size_t i);
 
-    std::deque<std::pair<int, double>> hbond_connected_num_and_max_distance;
+    std::vector<std::pair<int, double>> hbond_connected_num_and_max_distance;
 };
 
 #endif  // TINKER_HBONDSPREAD_HPP
@@ -1,35 +1,37 @@
 
 #include "KeyInteractionResidueFinder.hpp"
 #include "data_structure/frame.hpp"
-#include "utils/PBCUtils.hpp"
 #include "utils/common.hpp"
 
-#include <boost/range/adaptors.hpp>
-#include <boost/range/algorithm.hpp>
-
 KeyInteractionResidueFinder::KeyInteractionResidueFinder() { enable_outfile = true; }
 
 void KeyInteractionResidueFinder::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    sidechain_N_O_atoms = PBCUtils::find_atoms(sidechain_N_O_mask, frame);
-    dna_P_atoms = PBCUtils::find_atoms(dna_P_mask, frame);
+    sidechain_N_O_atoms = AtomGroup(frame, sidechain_N_O_mask);
+    dna_P_atoms = AtomGroup(frame, dna_P_mask);
+    residue_keys = residue_distance_evolution.residue_keys(*frame, sidechain_N_O_atoms.indices());
+}
+
+void KeyInteractionResidueFinder::reserve_frames_impl(std::size_t frames) {
+    residue_distance_evolution.reserve(frames);
 }
 
 void KeyInteractionResidueFinder::process(std::shared_ptr<Frame> &frame) {
-    std::map<std::string, double> residue_map;
-    for (auto &atom1 : sidechain_N_O_atoms) {
-        for (auto &atom2 : dna_P_atoms) {
-            auto dist = atom_distance(atom1, atom2, frame);
+    sidechain_N_O_atoms.gather(*frame);
+    dna_P_atoms.gather(*frame);
+    residue_distance_evolution.begin_frame();
+    for (std::size_t i = 0; i < sidechain_N_O_atoms.size(); ++i) {
+        for (std::size_t j = 0; j < dna_P_atoms.size(); ++j) {
+            coord_real dx = dna_P_atoms.x[j] - sidechain_N_O_atoms.x[i];
+            coord_real dy = dna_P_atoms.y[j] - sidechain_N_O_atoms.y[i];
+            coord_real dz = dna_P_atoms.z[j] - sidechain_N_O_atoms.z[i];
+            frame->image(dx, dy, dz);
+            double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
             if (dist < cutoff) {
-                auto key = atom1->residue_name.value() + std::to_string(atom1->residue_num.value());
-                if (auto it = residue_map.find(key); it != std::end(residue_map)) {
-                    it->second = std::min(it->second, dist);
-                } else {
-                    residue_map.emplace(key, dist);
-                }
+                residue_distance_evolution.record(residue_keys[i], dist);
             }
         }
     }
-    residue_distance_evolution.push_back(std::move(residue_map));
+    residue_distance_evolution.end_frame();
 }
 
 void KeyInteractionResidueFinder::print(std::ostream &os) {
@@ -41,42 +43,18 @@ void KeyInteractionResidueFinder::print(std::ostream &os) {
     os << "# cutoff(Ang) = " << cutoff << '\n';
     os << std::string(50, '#') << '\n';
 
-    std::map<std::string, std::size_t> counter_map;
-
-    for (const auto &m : residue_distance_evolution) {
-        for (const auto &[k, v] : m) {
-            ++counter_map[k];
-        }
-    }
-    std::vector<std::pair<std::string, std::size_t>> counter(std::begin(counter_map), std::end(counter_map));
-
-    boost::sort(counter, [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
-
-    os << "#Frame ";
-    for (const auto &p : counter) {
-        os << std::setw(15) << p.first;
-    }
-    os << '\n';
-    os << std::string(7 + 15 * counter.size(), '#') << '\n';
-    os << "# Count";
-    for (const auto &p : counter) {
-        os << std::setw(15) << p.second;
-    }
-    os << '\n';
-    os << std::string(7 + 15 * counter.size(), '#') << '\n';
+    residue_distance_evolution.print_distance_table(os);
+}
 
-    for (const auto &element : residue_distance_evolution | boost::adaptors::indexed(1)) {
-        os << std::setw(7) << element.index();
-        const auto &dists = element.value();
-        for (const auto &[key, value] : counter) {
-            if (auto it = dists.find(key); it != dists.end()) {
-                os << std::setw(15) << it->second;
-            } else {
-                os << std::setw(15) << "";
-            }
-        }
-        os << '\n';
+void KeyInteractionResidueFinder::setParameters(const AmberMask &sidechain_N_O, const AmberMask &dna_P, double cutoff,
+                                                const std::string &outfilename) {
+    if (cutoff <= 0) {
+        throw std::runtime_error("cutoff must large than zero");
     }
+    sidechain_N_O_mask = sidechain_N_O;
+    dna_P_mask = dna_P;
+    this->cutoff = cutoff;
+    setOutFilename(outfilename);
 }
 
 void KeyInteractionResidueFinder::readInfo() {
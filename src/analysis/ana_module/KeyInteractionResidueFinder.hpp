@@ -4,7 +4,9 @@
 
 #include "ana_module/AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/ResidueContactSeries.hpp"
 
 class Frame;
 
@@ -22,13 +24,21 @@ public:
 
     [[nodiscard]] static std::string_view title() { return "Key Residue Finder for Protein-DNA interaction"; }
 
+    void setParameters(const AmberMask &sidechain_N_O, const AmberMask &dna_P, double cutoff,
+                       const std::string &outfilename);
+
+protected:
+    void reserve_frames_impl(std::size_t frames) override;
+
 private:
     AmberMask sidechain_N_O_mask, dna_P_mask;
     double cutoff;
 
-    std::vector<std::shared_ptr<Atom>> sidechain_N_O_atoms, dna_P_atoms;
+    AtomGroup sidechain_N_O_atoms, dna_P_atoms;
+
+    std::vector<std::uint32_t> residue_keys; // key in residue_distance_evolution of every sidechain atom
 
-    std::deque<std::map<std::string, double>> residue_distance_evolution;
+    ResidueContactSeries residue_distance_evolution;
 };
 
 #endif // KEYINTERACTIONRESIDUEFINDER_HPP
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "NMRRange.hpp"
 
 #include "data_structure/frame.hpp"
+#include "utils/Geometry.hpp"
 #include "utils/common.hpp"
 
 using namespace std;
@@ -22,28 +23,29 @@ void NMRRange::process(std::shared_ptr<Frame> &frame) {
         }
         for (size_t i = 0; i < need_to_calc_list.size() - 1; i++) {
             for (size_t j = i + 1; j < need_to_calc_list.size(); j++) {
-                dist_range_map[make_pair(need_to_calc_list[i], need_to_calc_list[j])] = list<double>();
-                dist_range_map[make_pair(need_to_calc_list[i], need_to_calc_list[j])].push_back(
-                    atom_distance(frame->atom_map[need_to_calc_list[i]], frame->atom_map[need_to_calc_list[j]], frame));
+                dist_range_map[make_pair(need_to_calc_list[i], need_to_calc_list[j])];
             }
         }
-    } else {
         for (auto &item : dist_range_map) {
-            item.second.push_back(
-                atom_distance(frame->atom_map[item.first.first], frame->atom_map[item.first.second], frame));
+            pair_atoms.push_back(
+                {frame->atom_by_seq(item.first.first)->index, frame->atom_by_seq(item.first.second)->index});
         }
+        pair_distances.resize(pair_atoms.size());
+    }
+    atom_distances(*frame, pair_atoms, pair_distances);
+    auto it = pair_distances.begin();
+    for (auto &item : dist_range_map) {
+        item.second.push_back(*it++);
     }
 }
 
 void NMRRange::print(std::ostream &os) {
     for (auto &item : dist_range_map) {
         double sum = 0.0;
-        int count = 0;
-        for (auto v : item.second) {
-            sum += pow(v, -6);
-            count++;
+        for (size_t i = 0; i < item.second.size(); i++) {
+            sum += pow(double(item.second[i]), -6);
         }
-        double avg = sum / count;
+        double avg = sum / item.second.size();
         double e = -1.0 / 6;
         double value = pow(avg, e);
         os << name_map[item.first.first] << " <->\t" << name_map[item.first.second] << "\t" << value << endl;
@@ -117,7 +119,7 @@ bool NMRRange::recognize_walk(shared_ptr<Atom> atom, shared_ptr<AminoTop::AminoI
     list<shared_ptr<Atom>> child_atom_list;
     list<shared_ptr<AminoTop::AminoItem>> child_item_list;
     for (int i : atom->con_list) {
-        auto next_atom = frame->atom_map[i];
+        auto next_atom = frame->atom_by_seq(i);
         if (next_atom->mark) continue;
         bool ok = false;
 
@@ -5,16 +5,19 @@
 #ifndef TINKER_NMRRANGE_HPP
 #define TINKER_NMRRANGE_HPP
 
+#include <array>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "AbstractAnalysis.hpp"
 #include "AminoTop.hpp"
 #include "data_structure/atom.hpp"
+#include "utils/CompactSeries.hpp"
 
 class Frame;
 
@@ -53,7 +56,11 @@ private:
 
     std::list<std::shared_ptr<AminoAcid>> amino_acid_list;
 
-    std::map<std::pair<int, int>, std::list<double>> dist_range_map;
+    std::map<std::pair<int, int>, ChunkedArray<float>> dist_range_map;
+
+    // atom indices of the pairs in the order of dist_range_map
+    std::vector<std::array<std::size_t, 2>> pair_atoms;
+    std::vector<double> pair_distances;
 
     std::map<int, std::string> name_map;
 };
@@ -1,5 +1,7 @@
 #include "ProteinDihedral.hpp"
 #include "data_structure/frame.hpp"
+#include "data_structure/topology.hpp"
+#include "utils/Geometry.hpp"
 #include "utils/common.hpp"
 #include <boost/algorithm/algorithm.hpp>
 #include <boost/range/algorithm.hpp>
@@ -10,27 +12,14 @@ ProteinDihedral::ProteinDihedral() {
 }
 
 void ProteinDihedral::process(std::shared_ptr<Frame> &frame) {
-    for (std::size_t index = 0; index + 2 < atom_sequence.size(); ++index) {
-
-        const auto &atom1 = atom_sequence[index];
-        const auto &atom2 = atom_sequence[index + 1];
-        const auto &atom3 = atom_sequence[index + 2];
-
-        auto angle = atom_angle(atom1, atom2, atom3, frame);
-
-        angles[index](angle);
+    atom_angles(*frame, angle_atoms, angle_values);
+    for (std::size_t index = 0; index < angle_values.size(); ++index) {
+        angles[index](angle_values[index]);
     }
 
-    for (std::size_t index = 0; index + 3 < atom_sequence.size(); ++index) {
-
-        const auto &atom1 = atom_sequence[index];
-        const auto &atom2 = atom_sequence[index + 1];
-        const auto &atom3 = atom_sequence[index + 2];
-        const auto &atom4 = atom_sequence[index + 3];
-
-        auto angle = atom_dihedral(atom1, atom2, atom3, atom4, frame);
-
-        dihedrals[index](angle);
+    atom_dihedrals(*frame, dihedral_atoms, dihedral_values);
+    for (std::size_t index = 0; index < dihedral_values.size(); ++index) {
+        dihedrals[index](dihedral_values[index]);
     }
 }
 
@@ -85,7 +74,6 @@ void ProteinDihedral::print(std::ostream &os) {
 }
 
 void ProteinDihedral::processFirstFrame(std::shared_ptr<Frame> &frame) {
-
     std::set<std::shared_ptr<Atom>> atoms;
     std::shared_ptr<Atom> init_atom;
 
@@ -105,8 +93,8 @@ void ProteinDihedral::processFirstFrame(std::shared_ptr<Frame> &frame) {
             atom_sequence.push_back(init_atom);
         init_atom->mark = true;
 
-        for (auto i : init_atom->con_list) {
-            const auto &atom = frame->atom_map[i];
+        for (auto i : frame->topology->bonded(init_atom->index)) {
+            const auto &atom = frame->atom_list[i];
             if (atoms.contains(atom) and atom->mark == false) {
                 init_atom = atom;
                 goto cont;
@@ -117,6 +105,17 @@ void ProteinDihedral::processFirstFrame(std::shared_ptr<Frame> &frame) {
 
     angles.resize(atom_sequence.size() - 2);
     dihedrals.resize(atom_sequence.size() - 3);
+
+    for (std::size_t index = 0; index + 2 < atom_sequence.size(); ++index) {
+        angle_atoms.push_back(
+            {atom_sequence[index]->index, atom_sequence[index + 1]->index, atom_sequence[index + 2]->index});
+    }
+    for (std::size_t index = 0; index + 3 < atom_sequence.size(); ++index) {
+        dihedral_atoms.push_back({atom_sequence[index]->index, atom_sequence[index + 1]->index,
+                                  atom_sequence[index + 2]->index, atom_sequence[index + 3]->index});
+    }
+    angle_values.resize(angle_atoms.size());
+    dihedral_values.resize(dihedral_atoms.size());
 }
 
 void ProteinDihedral::readInfo() {
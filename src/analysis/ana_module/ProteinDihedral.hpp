@@ -32,6 +32,10 @@ protected:
     AmberMask mask, init_mask;
     std::vector<std::shared_ptr<Atom>> atom_sequence;
 
+    std::vector<std::array<std::size_t, 3>> angle_atoms;
+    std::vector<std::array<std::size_t, 4>> dihedral_atoms;
+    std::vector<double> angle_values, dihedral_values;
+
     std::vector<boost::accumulators::accumulator_set<double, boost::accumulators::features<boost::accumulators::tag::variance>>> angles, dihedrals;
 
 };
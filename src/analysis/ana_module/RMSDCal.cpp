@@ -357,7 +357,9 @@ void RMSDCal::save_superposed_frame(double *x, double *y, double *z, const std::
         element.value()->x = x[element.index()];
         element.value()->y = y[element.index()];
         element.value()->z = z[element.index()];
+        frame->sync_atom(*element.value());
     }
+    frame->coordinates_changed();
     writer->write(frame);
 }
 
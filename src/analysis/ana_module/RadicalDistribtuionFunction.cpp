@@ -13,29 +13,7 @@ void RadicalDistribtuionFunction::process(std::shared_ptr<Frame> &frame) {
     nframe++;
     volume = frame->volume();
 
-    for (auto &atom_j : group1) {
-        double xj = atom_j->x;
-        double yj = atom_j->y;
-        double zj = atom_j->z;
-        auto molj = atom_j->molecule.lock();
-
-        for (auto &atom_k : group2) {
-            if (atom_j != atom_k) {
-                auto mol_k = atom_k->molecule.lock();
-                if (intramol or (molj not_eq mol_k)) {
-                    double dx = atom_k->x - xj;
-                    double dy = atom_k->y - yj;
-                    double dz = atom_k->z - zj;
-                    frame->image(dx, dy, dz);
-                    double rjk = sqrt(dx * dx + dy * dy + dz * dz);
-                    int ibin = int(rjk / width) + 1;
-                    if (ibin <= nbin) {
-                        hist[ibin] += 1;
-                    }
-                }
-            }
-        }
-    }
+    pair_kernel->process(*frame);
 }
 
 void RadicalDistribtuionFunction::readInfo() {
@@ -45,8 +23,8 @@ void RadicalDistribtuionFunction::readInfo() {
     width = choose(0.0, std::numeric_limits<double>::max(), "Enter Width of Distance Bins [0.01 Ang]:", Default(0.01));
     intramol = choose_bool("Include Intramolecular Pairs in Distribution[N]:", Default(false));
     nbin = int(rmax / width);
+    hist.assign(nbin + 1, 0);
     for (int i = 0; i <= nbin; i++) {
-        hist[i] = 0;
         gr[i] = gs[i] = 0.0;
     }
 }
@@ -104,14 +82,22 @@ void RadicalDistribtuionFunction::print(std::ostream &os) {
 }
 
 void RadicalDistribtuionFunction::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    std::for_each(frame->atom_list.begin(), frame->atom_list.end(), [this](std::shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->ids1)) this->group1.insert(atom);
-        if (is_match(atom, this->ids2)) this->group2.insert(atom);
-    });
+    group1 = AtomGroup(frame, ids1);
+    group2 = AtomGroup(frame, ids2);
     numj = group1.size();
     numk = group2.size();
+    pair_kernel = make_pair_kernel(group1.indices(), group2.indices(), rmax, [this](const CellList::Pair &pair) {
+        if (!group1.excluded(pair.i, group2, pair.j, intramol)) {
+            int ibin = int(std::sqrt(pair.distance2) / width) + 1;
+            if (ibin <= nbin) {
+                hist[ibin] += 1;
+            }
+        }
+    });
 }
 
+void RadicalDistribtuionFunction::register_pair_kernels_impl(PairKernelDriver &driver) { driver.add(pair_kernel); }
+
 void RadicalDistribtuionFunction::setParameters(const AmberMask &id1, const AmberMask &id2, double max_dist,
                                                 double width, bool intramol, std::string outfilename) {
     this->ids1 = id1;
@@ -132,8 +118,8 @@ void RadicalDistribtuionFunction::setParameters(const AmberMask &id1, const Ambe
     this->width = width;
     this->intramol = intramol;
     nbin = int(rmax / width);
+    hist.assign(nbin + 1, 0);
     for (int i = 0; i <= nbin; i++) {
-        hist[i] = 0;
         gr[i] = gs[i] = 0.0;
     }
 }
@@ -7,11 +7,13 @@
 
 #include <map>
 #include <memory>
-#include <unordered_set>
+#include <vector>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/PairKernel.hpp"
 
 class Frame;
 
@@ -32,6 +34,9 @@ public:
 
     [[nodiscard]] static std::string_view title() { return "Radical Distribution Function"; }
 
+protected:
+    void register_pair_kernels_impl(PairKernelDriver &driver) override;
+
 private:
     double rmax;
     double width;
@@ -41,7 +46,7 @@ private:
     int numj = 0, numk = 0;
 
     int nbin;
-    std::map<int, int> hist;
+    std::vector<int> hist;
     std::map<int, double> gr, gs, integral;
 
     double volume;
@@ -49,8 +54,10 @@ private:
     AmberMask ids1;
     AmberMask ids2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
+
+    std::shared_ptr<PairKernel> pair_kernel;
 };
 
 #endif // TINKER_RADICALDISTRIBTUIONFUNCTION_HPP
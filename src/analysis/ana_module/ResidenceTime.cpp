@@ -61,22 +61,22 @@ void ResidenceTime::calculate() {
     public:
         int steps;
 
-        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> &mark;
+        const std::vector<BitSeries> &marks;
         std::vector<int, tbb::tbb_allocator<int>> time_array;
         std::vector<double, tbb::tbb_allocator<double>> Rt_array;
         std::vector<std::vector<std::pair<int, int>>> &hydrationed_atoms;
 
-        Body(int steps, Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> &mark,
+        Body(int steps, const std::vector<BitSeries> &marks,
              std::vector<std::vector<std::pair<int, int>>> &hydrationed_atoms)
             : steps(steps),
-              mark(mark),
+              marks(marks),
               time_array(steps - 1),
               Rt_array(steps - 1),
               hydrationed_atoms(hydrationed_atoms) {}
 
         Body(Body &body, tbb::split)
             : steps(body.steps),
-              mark(body.mark),
+              marks(body.marks),
               time_array(body.steps - 1),
               Rt_array(body.steps - 1),
               hydrationed_atoms(body.hydrationed_atoms) {}
@@ -100,14 +100,14 @@ void ResidenceTime::calculate() {
                     int value = 0.0;
                     auto n = j - i - 1;
                     for (auto [atom, outframe] : hydrationed_atoms[i]) {
-                        if (mark(j, atom) and j < outframe) value++;
+                        if (marks[atom][j] and j < outframe) value++;
                     }
                     ++time_array[n];
                     Rt_array[n] += value * factor;
                 }
             }
         }
-    } body(steps, mark, hydrationed_atoms);
+    } body(steps, marks, hydrationed_atoms);
     tbb::parallel_reduce(tbb::blocked_range<int>(0, steps - 1), body);
     for (int i = 0; i < steps - 1; i++) body.Rt_array[i] /= body.time_array[i];
 
@@ -116,22 +116,19 @@ void ResidenceTime::calculate() {
 
 void ResidenceTime::process(std::shared_ptr<Frame> &frame) {
     steps++;
-    int atom_no = 0;
-    for (auto &atom1 : center_atom_group) {
-        for (auto &atom2 : Ow_atom_group) {
-            double xr = atom1->x - atom2->x;
-            double yr = atom1->y - atom2->y;
-            double zr = atom1->z - atom2->z;
-            frame->image(xr, yr, zr);
-            double dist = std::sqrt(xr * xr + yr * yr + zr * zr);
-            mark_map[atom_no].push_back(dist <= dis_cutoff);
-            atom_no += 1;
-        }
+    if (marks.empty()) marks.resize(center_atoms.size() * Ow_atoms.size());
+    // pairs come ordered like the marks, center atom first
+    const auto &pairs = neighbor_list->search(*frame);
+    auto pair = pairs.begin();
+    for (std::size_t atom_no = 0; atom_no < marks.size(); ++atom_no) {
+        const bool within = pair != pairs.end() and pair->i * Ow_atoms.size() + pair->j == atom_no;
+        marks[atom_no].push_back(within);
+        if (within) ++pair;
     }
 }
 
 void ResidenceTime::print(std::ostream &os) {
-    fill_mark();
+    check_frames();
     calculate();
 
     os << "# " << title() << '\n';
@@ -146,20 +143,12 @@ void ResidenceTime::print(std::ostream &os) {
     }
 }
 
-void ResidenceTime::fill_mark() {
+void ResidenceTime::check_frames() {
     if (steps < 2) {
         cerr << "Too few frame number :" << steps << endl;
         exit(1);
     }
-    atom_num = static_cast<int>(mark_map.size());
-    mark.resize(steps, atom_num);
-    for (const auto &it : mark_map) {
-        auto atom_no = it.first;
-        for (const auto &ele : it.second | boost::adaptors::indexed(0)) {
-            mark(ele.index(), atom_no) = ele.value();
-        }
-    }
-    mark_map.clear();
+    atom_num = static_cast<int>(marks.size());
 }
 
 void ResidenceTime::readInfo() {
@@ -205,4 +194,10 @@ void ResidenceTime::processFirstFrame(std::shared_ptr<Frame> &frame) {
         if (is_match(atom, this->center_atom_mask)) this->center_atom_group.insert(atom);
         if (is_match(atom, this->Ow_atom_mask)) this->Ow_atom_group.insert(atom);
     });
+    for (auto &atom : center_atom_group) center_atoms.push_back(atom->index);
+    for (auto &atom : Ow_atom_group) Ow_atoms.push_back(atom->index);
+    // sorted like AtomGroup, so other tasks over the same atoms share the neighbor list
+    boost::sort(center_atoms);
+    boost::sort(Ow_atoms);
+    neighbor_list = NeighborList::shared(center_atoms, Ow_atoms, dis_cutoff);
 }
@@ -7,15 +7,16 @@
 
 #include <tbb/tbb.h>
 
-#include <Eigen/Eigen>
-#include <map>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
+#include "utils/CompactSeries.hpp"
 
 class Frame;
 
@@ -37,7 +38,10 @@ public:
     [[nodiscard]] static std::string_view title() { return "ResidenceTime"; }
 
 protected:
-    std::map<int, std::list<bool>> mark_map;
+    // one bit per frame for every center-Ow pair, set when the pair is within the cutoff
+    std::vector<BitSeries> marks;
+
+    [[nodiscard]] bool mark(int step, int atom) const { return marks[atom][step]; }
 
     void calculate();
 
@@ -46,8 +50,6 @@ protected:
     int atom_num = 0;
     std::vector<double, tbb::tbb_allocator<double>> Rt_array;
 
-    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> mark;
-
     int time_star = 0;
 
     enum class TimeStarMode : int { Loose = 0, Strict = 1 } timeStarMode;
@@ -58,7 +60,13 @@ protected:
     std::unordered_set<std::shared_ptr<Atom>> center_atom_group;
     std::unordered_set<std::shared_ptr<Atom>> Ow_atom_group;
 
-    void fill_mark();
+    // sorted Atom::index of the groups, marks are ordered by them
+    std::vector<std::size_t> center_atoms;
+    std::vector<std::size_t> Ow_atoms;
+
+    std::shared_ptr<NeighborList> neighbor_list;
+
+    void check_frames();
 
     void readTimeStarSetting();
 
@@ -32,7 +32,7 @@ void RotAcf::process(std::shared_ptr<Frame> &frame) {
     auto it2 = rots.begin();
     assert(vectors.size() == rots.size());
     for (; it1 != vectors.end(); ++it1, ++it2) {
-        it2->push_back(*it1);
+        it2->push_back(PackedUnitVector(*it1));
     }
 }
 
@@ -65,14 +65,14 @@ std::vector<double> RotAcf::integrate(const std::vector<double> &acf) const {
 namespace {
 template <typename Function> class RotAcfParallelBody {
 public:
-    const std::vector<std::vector<std::tuple<double, double, double>>> &rots;
+    const std::vector<ChunkedArray<PackedUnitVector>> &rots;
     std::vector<double, tbb::tbb_allocator<double>> acf;
 
     size_t array_length;
     size_t max_time_gap_step;
     Function f;
 
-    explicit RotAcfParallelBody(const std::vector<std::vector<std::tuple<double, double, double>>> &rots,
+    explicit RotAcfParallelBody(const std::vector<ChunkedArray<PackedUnitVector>> &rots,
                                 size_t max_time_gap_step, size_t array_length, Function f)
         : rots(rots), acf(array_length), array_length(array_length), max_time_gap_step(max_time_gap_step),
           f(std::move(f)) {}
@@ -88,9 +88,14 @@ public:
     }
 
     void operator()(const tbb::blocked_range<std::size_t> &range) {
+        // the series of one vector is unpacked once, the pair loop reads plain floats
+        std::vector<std::array<float, 3>> _vector;
         for (auto index = range.begin(); index != range.end(); index++) {
-            auto &_vector = rots[index];
-            auto total_size = _vector.size();
+            auto total_size = rots[index].size();
+            _vector.resize(total_size);
+            for (size_t i = 0; i < total_size; i++) {
+                _vector[i] = rots[index][i].unpack();
+            }
 
             for (size_t i = 0; i < total_size - 1; i++) {
                 for (size_t j = i + 1; j < std::min(total_size, max_time_gap_step + i); j++) {
@@ -99,7 +104,8 @@ public:
                     assert(i < _vector.size());
                     assert(j < _vector.size());
 
-                    double cos = dot_multiplication(_vector[i], _vector[j]);
+                    double cos = _vector[i][0] * _vector[j][0] + _vector[i][1] * _vector[j][1] +
+                                 _vector[i][2] * _vector[j][2];
 
                     acf[m] += f(cos);
                 }
@@ -6,6 +6,7 @@
 #define TINKER_ROTACF_HPP
 
 #include "AbstractAnalysis.hpp"
+#include "utils/CompactSeries.hpp"
 #include "utils/VectorSelector.hpp"
 
 class Frame;
@@ -37,7 +38,8 @@ protected:
 
     [[nodiscard]] std::vector<double> integrate(const std::vector<double> &acf) const;
 
-    std::vector<std::vector<std::tuple<double, double, double>>> rots;
+    // selected vectors are unit vectors, each frame of each one is kept packed in 4 bytes
+    std::vector<ChunkedArray<PackedUnitVector>> rots;
 
     std::shared_ptr<VectorSelector> vectorSelector;
 
@@ -4,8 +4,6 @@
 
 #include "RotAcfCutoff.hpp"
 
-#include <boost/range/algorithm.hpp>
-
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
@@ -29,26 +27,29 @@ auto RotAcfCutoff::find_in(int seq) {
 }
 
 void RotAcfCutoff::process(std::shared_ptr<Frame> &frame) {
-    for (auto &ref : group1) {
-        for (auto &atom2 : group2) {
-            auto mol = atom2->molecule.lock();
+    const auto &pairs = neighbor_list->search(*frame);
+    auto pair = pairs.begin();
+    for (std::size_t i = 0; i < group1.size(); ++i) {
+        shell_molecules.clear();
+        for (; pair != pairs.end() and pair->i == i; ++pair) {
+            if (pair->distance2 >= cutoff2) continue;
+            // in the shell
+            auto mol = group2.atom(pair->j)->molecule.lock();
+            shell_molecules.push_back(mol->seq());
             auto it = find_in(mol->seq());
-            if (atom_distance2(ref, atom2, frame) < cutoff2) {
-                // in the shell
-                if (it != inner_atoms.end()) {
-                    it->list_ptr->push_back(calVector(mol, frame));
-                } else {
-                    auto list_ptr = std::make_shared<std::list<std::tuple<double, double, double>>>();
-                    list_ptr->push_back(calVector(mol, frame));
-                    inner_atoms.insert(InnerAtom(mol->seq(), list_ptr));
-                    rots.emplace_back(list_ptr);
-                }
+            if (it != inner_atoms.end()) {
+                it->list_ptr->push_back(calVector(mol, frame));
             } else {
-                if (it != inner_atoms.end()) {
-                    inner_atoms.erase(it);
-                }
+                auto list_ptr = std::make_shared<std::list<std::tuple<double, double, double>>>();
+                list_ptr->push_back(calVector(mol, frame));
+                inner_atoms.insert(InnerAtom(mol->seq(), list_ptr));
+                rots.emplace_back(list_ptr);
             }
         }
+        // out of the shell
+        std::erase_if(inner_atoms, [this](const InnerAtom &atom) {
+            return std::find(shell_molecules.begin(), shell_molecules.end(), atom.index) == shell_molecules.end();
+        });
     }
 }
 
@@ -195,12 +196,9 @@ void RotAcfCutoff::calculateAutocorrelaionFunction(vector<pair<unsigned long lon
 }
 
 void RotAcfCutoff::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    boost::for_each(frame->atom_list, [this](shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->ids1))
-            this->group1.insert(atom);
-        if (is_match(atom, this->ids2))
-            this->group2.insert(atom);
-    });
+    group1 = AtomGroup(frame, ids1);
+    group2 = AtomGroup(frame, ids2);
+    neighbor_list = NeighborList::shared(group1.indices(), group2.indices(), std::sqrt(cutoff2));
     if (group1.size() > 1) {
         cerr << "the reference(metal cation) atom for RotAcfCutoff function can only have one\n";
         exit(EXIT_FAILURE);
@@ -15,7 +15,9 @@
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
 #include "utils/VectorSelector.hpp"
 
 class Frame;
@@ -71,11 +73,16 @@ private:
     AmberMask ids1;
     AmberMask ids2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
+
+    std::shared_ptr<NeighborList> neighbor_list;
 
     std::unordered_set<InnerAtom, InnerAtomHasher> inner_atoms;
 
+    // molecule seq of the atoms in the shell of the current reference atom
+    std::vector<int> shell_molecules;
+
     std::list<std::shared_ptr<std::list<std::tuple<double, double, double>>>> rots;
 
     [[nodiscard]] auto find_in(int seq);
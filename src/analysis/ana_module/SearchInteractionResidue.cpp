@@ -12,20 +12,16 @@ using namespace std;
 SearchInteractionResidue::SearchInteractionResidue() { enable_outfile = true; }
 
 void SearchInteractionResidue::process(std::shared_ptr<Frame> &frame) {
-    std::unordered_set<std::string> residue_set;  // resname:no
-
-    for (auto &atomA : group1) {
-        for (auto &atomB : group2) {
-            if (atom_distance(atomA, atomB, frame) <= cutoff) {
-                residue_set.insert(atomB->residue_name.get() + "-" +
-                                   boost::lexical_cast<std::string>(atomB->residue_num.get()));
-            }
-        }
+    interaction_residues.begin_frame();
+    for (const auto &pair : neighbor_list->search(*frame)) {
+        interaction_residues.record(residue_keys[pair.j], 0.0);
     }
-    interaction_residues.push_back(residue_set);
+    interaction_residues.end_frame();
     total_frames++;
 }
 
+void SearchInteractionResidue::reserve_frames_impl(std::size_t frames) { interaction_residues.reserve(frames); }
+
 void SearchInteractionResidue::print(std::ostream &os) {
     os << "************************************************\n";
     os << "*****" << SearchInteractionResidue::title() << " ****\n";
@@ -35,56 +31,43 @@ void SearchInteractionResidue::print(std::ostream &os) {
 
     os << "************************************************\n";
 
-    using ResItem = struct {
-        std::string name;
-        int count;
-    };
+    const auto counter = interaction_residues.frequencies();
 
-    std::unordered_map<std::string, ResItem> map;
-    for (auto &set : interaction_residues) {
-        for (auto &item : set) {
-            auto it = map.find(item);
-            if (it == map.end()) {
-                map.emplace(item, ResItem{item, 1});
-            } else {
-                it->second.count++;
-            }
-        }
-    }
-
-    std::vector<std::reference_wrapper<ResItem> > itemVec;
-    for (auto &item : map) {
-        itemVec.push_back(std::ref(item.second));
-    }
-
-    std::sort(itemVec.begin(), itemVec.end(), [](auto &i1, auto &i2) { return i1.get().count > i2.get().count; });
-
-    std::size_t nframe = 1;
     os << boost::format("%10s") % "name";
-    for (auto &item : itemVec) {
-        os << boost::format("%10s") % item.get().name;
+    for (const auto &[key, count] : counter) {
+        os << boost::format("%10s") % interaction_residues.label(key);
     }
     os << boost::format("\n%10s") % "Freq";
-    ;
-    for (auto &item : itemVec) {
-        os << boost::format("%9.1f%%") % (item.get().count * 100.0 / total_frames);
+    for (const auto &[key, count] : counter) {
+        os << boost::format("%9.1f%%") % (count * 100.0 / total_frames);
     }
     os << '\n';
-    for (auto &set : interaction_residues) {
-        os << boost::format("%10d") % nframe;
+    for (std::size_t i = 0; i < interaction_residues.frames(); i++) {
+        os << boost::format("%10d") % (i + 1);
         int index = 1;
-        for (auto &item : itemVec) {
-            os << boost::format("%10d") %
-                      (style == OutputStyle::NUMBER ? (set.count(item.get().name) ? index : 0) : set.count(item.get().name));
+        for (const auto &[key, count] : counter) {
+            bool found = interaction_residues.find(i, key);
+            os << boost::format("%10d") % (style == OutputStyle::NUMBER ? (found ? index : 0) : int(found));
             index++;
         }
         os << '\n';
-        nframe++;
     }
 
     os << "************************************************" << endl;
 }
 
+void SearchInteractionResidue::setParameters(const AmberMask &mask1, const AmberMask &mask2, double cutoff,
+                                             bool number_style, const std::string &outfilename) {
+    if (cutoff <= 0) {
+        throw std::runtime_error("cutoff must large than zero");
+    }
+    ids1 = mask1;
+    ids2 = mask2;
+    this->cutoff = cutoff;
+    style = number_style ? OutputStyle::NUMBER : OutputStyle::BOOL;
+    setOutFilename(outfilename);
+}
+
 void SearchInteractionResidue::readInfo() {
     std::cout << "The output residues is in the second group\n";
     select2group(ids1, ids2);
@@ -94,8 +77,8 @@ void SearchInteractionResidue::readInfo() {
 }
 
 void SearchInteractionResidue::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    std::for_each(frame->atom_list.begin(), frame->atom_list.end(), [this](shared_ptr<Atom> &atom) {
-        if (is_match(atom, this->ids1)) this->group1.insert(atom);
-        if (is_match(atom, this->ids2)) this->group2.insert(atom);
-    });
-}
\ No newline at end of file
+    group1 = AtomGroup(frame, ids1);
+    group2 = AtomGroup(frame, ids2);
+    neighbor_list = NeighborList::shared(group1.indices(), group2.indices(), cutoff);
+    residue_keys = interaction_residues.residue_keys(*frame, group2.indices(), "-");
+}
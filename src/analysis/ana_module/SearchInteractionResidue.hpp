@@ -5,16 +5,16 @@
 #ifndef TINKER_SEARCHINTERACTIONRESIDUE_HPP
 #define TINKER_SEARCHINTERACTIONRESIDUE_HPP
 
-#include <list>
-#include <map>
 #include <memory>
 #include <string>
-#include <unordered_set>
-#include <utility>
+#include <vector>
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/NeighborList.hpp"
+#include "utils/ResidueContactSeries.hpp"
 
 class Frame;
 
@@ -32,16 +32,27 @@ public:
 
     [[nodiscard]] static std::string_view title() { return "Search Interaction Residue between two groups"; }
 
+    // number_style: residues are printed as their column number instead of 1 in the frames they are found
+    void setParameters(const AmberMask &mask1, const AmberMask &mask2, double cutoff, bool number_style,
+                       const std::string &outfilename);
+
+protected:
+    void reserve_frames_impl(std::size_t frames) override;
+
 private:
     AmberMask ids1;
     AmberMask ids2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
 
     double cutoff;
 
-    std::list<std::unordered_set<std::string>> interaction_residues;
+    std::shared_ptr<NeighborList> neighbor_list;
+
+    std::vector<std::uint32_t> residue_keys; // key in interaction_residues of every atom of group2
+
+    ResidueContactSeries interaction_residues;
     int total_frames = 0;
 
     enum class OutputStyle { BOOL = 0, NUMBER = 1 };
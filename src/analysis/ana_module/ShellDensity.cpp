@@ -14,14 +14,7 @@ ShellDensity::ShellDensity() { enable_outfile = true; }
 
 void ShellDensity::process(std::shared_ptr<Frame> &frame) {
     nframe++;
-    for (auto &ref : group1) {
-        for (auto &atom : group2) {
-            int ibin = int(atom_distance(ref, atom, frame) / distance_width) + 1;
-            if (ibin <= distance_bins) {
-                hist[ibin]++;
-            }
-        }
-    }
+    pair_kernel->process(*frame);
 }
 
 void ShellDensity::print(std::ostream &os) {
@@ -69,18 +62,23 @@ void ShellDensity::readInfo() {
     distance_width =
         choose(0.0, std::numeric_limits<double>::max(), "Enter Width of Distance Bins [0.01 Ang]:", Default(0.01));
     distance_bins = int(rmax / distance_width);
-    for (int i = 1; i <= distance_bins; i++) {
-        hist[i] = 0;
-    }
+    hist.assign(distance_bins + 1, 0);
 }
 
 void ShellDensity::processFirstFrame(std::shared_ptr<Frame> &frame) {
-    std::for_each(frame->atom_list.begin(), frame->atom_list.end(), [this](shared_ptr<Atom> &atom) {
-        if (is_match(atom, mask1)) group1.insert(atom);
-        if (is_match(atom, mask2)) group2.insert(atom);
-    });
+    group1 = AtomGroup(frame, mask1);
+    group2 = AtomGroup(frame, mask2);
+    pair_kernel = make_pair_kernel(group1.indices(), group2.indices(), distance_bins * distance_width,
+                                   [this](const CellList::Pair &pair) {
+                                       int ibin = int(std::sqrt(pair.distance2) / distance_width) + 1;
+                                       if (ibin <= distance_bins) {
+                                           hist[ibin]++;
+                                       }
+                                   });
 }
 
+void ShellDensity::register_pair_kernels_impl(PairKernelDriver &driver) { driver.add(pair_kernel); }
+
 void ShellDensity::setParameters(const AmberMask &id1, const AmberMask &id2, double max_dist, double width,
                                  std::string outfilename) {
     this->mask1 = id1;
@@ -99,7 +97,5 @@ void ShellDensity::setParameters(const AmberMask &id1, const AmberMask &id2, dou
 
     distance_bins = int(rmax / distance_width);
 
-    for (int i = 1; i <= distance_bins; i++) {
-        hist[i] = 0;
-    }
+    hist.assign(distance_bins + 1, 0);
 }
@@ -14,7 +14,9 @@
 
 #include "AbstractAnalysis.hpp"
 #include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
 #include "dsl/AmberMask.hpp"
+#include "utils/PairKernel.hpp"
 
 class Frame;
 
@@ -36,17 +38,21 @@ public:
     [[nodiscard]] static std::string_view title() { return "Shell Density function"; }
 
 protected:
+    void register_pair_kernels_impl(PairKernelDriver &driver) override;
+
     AmberMask mask1;
     AmberMask mask2;
 
-    std::unordered_set<std::shared_ptr<Atom>> group1;
-    std::unordered_set<std::shared_ptr<Atom>> group2;
+    AtomGroup group1;
+    AtomGroup group2;
+
+    std::shared_ptr<PairKernel> pair_kernel;
 
     double distance_width;
 
     int distance_bins;
 
-    std::map<int, std::size_t> hist;
+    std::vector<std::size_t> hist;
 
     std::size_t nframe = 0;
 
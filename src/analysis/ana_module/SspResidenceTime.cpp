@@ -24,7 +24,7 @@ void SspResidenceTime::print(std::ostream &os) {
 }
 
 void SspResidenceTime::calculateSSP() {
-    fill_mark();
+    check_frames();
 
     std::vector<std::vector<int>> hydrationed_atoms(steps);
 
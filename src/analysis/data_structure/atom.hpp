@@ -30,6 +30,7 @@ class Atom {
 public:
     boost::graph_traits<graph_t>::vertex_descriptor vertex_descriptor;
     std::size_t seq;
+    std::size_t index = 0; // position in Frame::atom_list and Frame coordinate arrays
     std::string atom_name;
 
     const boost::optional<int> &getAtNo() const { return at_no; }
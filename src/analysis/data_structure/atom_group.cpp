@@ -0,0 +1,63 @@
+#include "atom_group.hpp"
+
+#include <algorithm>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/topology.hpp"
+#include "dsl/AmberMaskIndex.hpp"
+
+AtomGroup::AtomGroup(const std::shared_ptr<Frame> &frame, const AmberMask &mask) {
+    std::vector<std::shared_ptr<Atom>> atoms;
+    auto selection = AmberMaskIndex::select(mask, frame);
+    for (auto i = selection->find_first(); i != AmberMaskIndex::Selection::npos; i = selection->find_next(i)) {
+        atoms.push_back(frame->atom_list[i]);
+    }
+    compile(frame, std::move(atoms));
+}
+
+AtomGroup::AtomGroup(const std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) {
+    compile(frame, atoms);
+}
+
+void AtomGroup::compile(const std::shared_ptr<Frame> &frame, std::vector<std::shared_ptr<Atom>> atoms) {
+    if (!frame->has_coordinate_arrays() or !frame->topology) {
+        frame->index_atoms();
+    }
+    const auto &topology = *frame->topology;
+    std::sort(atoms.begin(), atoms.end(), [](auto &lhs, auto &rhs) { return lhs->index < rhs->index; });
+    atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+
+    atom_indices.clear();
+    molecule_ids.clear();
+    for (const auto &atom : atoms) {
+        atom_indices.push_back(atom->index);
+        auto mol = topology.molecule_of(atom->index);
+        // atoms outside all molecules share one id, as their empty molecule pointers compared equal before
+        molecule_ids.push_back(mol != Topology::npos ? mol : frame->molecule_list.size());
+    }
+    group_atoms = std::move(atoms);
+    x.resize(size());
+    y.resize(size());
+    z.resize(size());
+}
+
+void AtomGroup::gather(const Frame &frame) { gather(frame, x, y, z); }
+
+template <typename Real>
+void AtomGroup::gather(const Frame &frame, std::vector<Real> &xs, std::vector<Real> &ys, std::vector<Real> &zs) const {
+    xs.resize(size());
+    ys.resize(size());
+    zs.resize(size());
+    for (std::size_t i = 0; i < atom_indices.size(); ++i) {
+        const auto index = atom_indices[i];
+        xs[i] = static_cast<Real>(frame.x[index]);
+        ys[i] = static_cast<Real>(frame.y[index]);
+        zs[i] = static_cast<Real>(frame.z[index]);
+    }
+}
+
+template void AtomGroup::gather(const Frame &, std::vector<float> &, std::vector<float> &,
+                                std::vector<float> &) const;
+template void AtomGroup::gather(const Frame &, std::vector<double> &, std::vector<double> &,
+                                std::vector<double> &) const;
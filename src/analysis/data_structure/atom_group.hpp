@@ -0,0 +1,61 @@
+#ifndef TINKER_ATOM_GROUP_HPP
+#define TINKER_ATOM_GROUP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dsl/AmberMask.hpp"
+#include "utils/precision.hpp"
+
+class Atom;
+
+class Frame;
+
+/*
+ *  a selection compiled once on the first frame into plain integers: sorted Atom::index of the selected atoms
+ *  and the molecule id of each of them (position in Frame::molecule_list, atoms without molecule all share
+ *  one id). Pair loops compare integers instead of locking weak_ptr or hashing shared_ptr, and read
+ *  coordinates from Frame::x/y/z or from the contiguous copies made by gather
+ */
+class AtomGroup {
+public:
+    AtomGroup() = default;
+
+    AtomGroup(const std::shared_ptr<Frame> &frame, const AmberMask &mask);
+
+    AtomGroup(const std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms);
+
+    [[nodiscard]] std::size_t size() const { return atom_indices.size(); }
+
+    [[nodiscard]] bool empty() const { return atom_indices.empty(); }
+
+    [[nodiscard]] const std::vector<std::size_t> &indices() const { return atom_indices; }
+
+    [[nodiscard]] const std::vector<std::uint32_t> &molecules() const { return molecule_ids; }
+
+    [[nodiscard]] const std::shared_ptr<Atom> &atom(std::size_t i) const { return group_atoms[i]; }
+
+    // pairs of the same atom, or of the same molecule unless intramol, are excluded
+    [[nodiscard]] bool excluded(std::size_t i, const AtomGroup &other, std::size_t j, bool intramol) const {
+        return atom_indices[i] == other.atom_indices[j] or (!intramol and molecule_ids[i] == other.molecule_ids[j]);
+    }
+
+    // copy coordinates of the group out of frame coordinate arrays into x, y, z
+    void gather(const Frame &frame);
+
+    // the same into arrays of any precision
+    template <typename Real>
+    void gather(const Frame &frame, std::vector<Real> &xs, std::vector<Real> &ys, std::vector<Real> &zs) const;
+
+    std::vector<coord_real> x, y, z;
+
+private:
+    void compile(const std::shared_ptr<Frame> &frame, std::vector<std::shared_ptr<Atom>> atoms);
+
+    std::vector<std::size_t> atom_indices;
+    std::vector<std::uint32_t> molecule_ids;
+    std::vector<std::shared_ptr<Atom>> group_atoms;
+};
+
+#endif // TINKER_ATOM_GROUP_HPP
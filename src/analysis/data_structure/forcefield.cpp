@@ -80,4 +80,5 @@ void Forcefield::assign_forcefield(std::shared_ptr<Frame> &frame) {
         atom->setAtNo(it->second.at_no);
         atom->residue_name = it->second.res;
     }
+    frame->topology_changed();
 }
@@ -6,6 +6,7 @@
 #include "config.h"
 #include "data_structure/atom.hpp"
 #include "molecule.hpp"
+#include "topology.hpp"
 #include "utils/common.hpp"
 
 void Frame::image(double &xr, double &yr, double &zr) const {
@@ -13,6 +14,11 @@ void Frame::image(double &xr, double &yr, double &zr) const {
     box.image(xr, yr, zr);
 }
 
+void Frame::image(float &xr, float &yr, float &zr) const {
+    if (!enable_bound) return;
+    box.image(xr, yr, zr);
+}
+
 void Frame::image(std::array<double, 3> &r) const { image(r[0], r[1], r[2]); }
 
 void Frame::image(std::tuple<double, double, double> &r) const {
@@ -20,6 +26,11 @@ void Frame::image(std::tuple<double, double, double> &r) const {
     image(xr, yr, zr);
 }
 
+void Frame::image(std::span<double> xr, std::span<double> yr, std::span<double> zr) const {
+    if (!enable_bound) return;
+    box.image(xr, yr, zr);
+}
+
 std::tuple<double, double, double> Frame::getDipole() {
     auto frame = shared_from_this();
     std::tuple<double, double, double> system_dipole{};
@@ -29,6 +40,68 @@ std::tuple<double, double, double> Frame::getDipole() {
     return system_dipole;
 }
 
+void Frame::index_atoms() {
+    for (std::size_t i = 0; i < atom_list.size(); ++i) {
+        atom_list[i]->index = i;
+    }
+    topology = std::make_shared<const Topology>(*this);
+    topology_changed();
+    for (auto *array : {&x, &y, &z, &vx, &vy, &vz}) {
+        array->resize(atom_list.size());
+    }
+    sync_atoms();
+}
+
+const std::shared_ptr<Atom> &Frame::atom_by_seq(std::size_t seq) {
+    if (topology and topology->atom_count() == atom_list.size()) {
+        if (auto i = topology->index_of_seq(seq); i != Topology::npos) {
+            return atom_list[i];
+        }
+    }
+    return atom_map[seq];
+}
+
+std::uint64_t Frame::next_version() {
+    static std::atomic<std::uint64_t> counter = 0;
+    return ++counter;
+}
+
+void Frame::sync_atom(const Atom &atom) {
+    if (!has_coordinate_arrays())
+        return;
+    const auto i = atom.index;
+    x[i] = atom.x;
+    y[i] = atom.y;
+    z[i] = atom.z;
+    if (has_velocity) {
+        vx[i] = atom.vx;
+        vy[i] = atom.vy;
+        vz[i] = atom.vz;
+    }
+}
+
+void Frame::sync_atoms() {
+    for (const auto &atom : atom_list) {
+        sync_atom(*atom);
+    }
+    coordinates_changed();
+}
+
+bool Frame::coordinate_arrays_in_sync() const {
+    if (!has_coordinate_arrays())
+        return true;
+    for (const auto &atom : atom_list) {
+        const auto i = atom->index;
+        if (x[i] != atom->x or y[i] != atom->y or z[i] != atom->z)
+            return false;
+        if (has_velocity and (vx[i] != atom->vx or vy[i] != atom->vy or vz[i] != atom->vz))
+            return false;
+    }
+    return true;
+}
+
 void Frame::build_graph() {
+    // bonds are read from the topology tables
+    index_atoms();
     for (auto &mol : molecule_list) mol->build_graph(shared_from_this());
 }
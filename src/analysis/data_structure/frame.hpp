@@ -8,9 +8,11 @@
 #include "config.h"
 
 #include <Eigen/Eigen>
+#include <atomic>
 #include <cassert>
 #include <list>
 #include <memory>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -26,9 +28,17 @@ class Atom;
 
 class Molecule;
 
+class Topology;
+
 class Frame : public std::enable_shared_from_this<Frame> {
     std::optional<float> current_time;
 
+    std::atomic<std::uint64_t> version = next_version();
+
+    std::uint64_t atom_properties_version = next_version();
+
+    static std::uint64_t next_version();
+
 public:
     const std::optional<float> &getCurrentTime() const { return current_time; }
 
@@ -46,12 +56,65 @@ public:
 
     bool has_velocity = false;
 
+    /*
+     *  structure-of-arrays coordinates (Angstrom) and velocities of all atoms, indexed by Atom::index.
+     *  trajectory readers fill the arrays and Atom::x/y/z together. Code that moves atoms through Atom objects
+     *  calls sync_atom or sync_atoms afterwards, so both views hold the same coordinates
+     */
+    std::vector<double> x, y, z;
+    std::vector<double> vx, vy, vz;
+
+    // assign Atom::index by position in atom_list, build topology tables, then allocate and fill coordinate arrays
+    void index_atoms();
+
+    // contiguous connectivity, residue and molecule tables, available after index_atoms
+    std::shared_ptr<const Topology> topology;
+
+    // atom with Atom::seq, found through the topology tables when present
+    [[nodiscard]] const std::shared_ptr<Atom> &atom_by_seq(std::size_t seq);
+
+    [[nodiscard]] bool has_coordinate_arrays() const { return !atom_list.empty() and x.size() == atom_list.size(); }
+
+    /*
+     *  copy coordinates (and velocities) of atom into coordinate arrays. The version is not renewed, callers
+     *  call coordinates_changed once after the last atom they moved; sync_atoms renews it itself
+     */
+    void sync_atom(const Atom &atom);
+
+    void sync_atoms();
+
+    // Atom::x/y/z (and velocities) of every atom equal to the coordinate arrays, checked by debug builds
+    [[nodiscard]] bool coordinate_arrays_in_sync() const;
+
+    /*
+     *  unique over all frames and renewed whenever coordinates or box change (a new frame is applied, sync_atoms,
+     *  coordinates_changed after sync_atom).
+     *  values cached per frame, like molecule centers, stay valid as long as the version is the same
+     */
+    [[nodiscard]] std::uint64_t coordinate_version() const { return version.load(std::memory_order_acquire); }
+
+    void coordinates_changed() { version.store(next_version(), std::memory_order_release); }
+
+    /*
+     *  unique over all frames and renewed by index_atoms and topology_changed. Callers that rename atoms or
+     *  residues, or assign types and elements (force field), call topology_changed afterwards, so lookup tables
+     *  built from atom properties, like AmberMaskIndex, are rebuilt
+     */
+    [[nodiscard]] std::uint64_t topology_version() const { return atom_properties_version; }
+
+    void topology_changed() { atom_properties_version = next_version(); }
+
     void image(double &xr, double &yr, double &zr) const;
 
+    void image(float &xr, float &yr, float &zr) const;
+
     void image(std::array<double, 3> &r) const;
 
     void image(std::tuple<double, double, double> &r) const;
 
+    // minimum image of many difference vectors at once, see PBCBox
+    void image(std::span<double> xr, std::span<double> yr, std::span<double> zr) const;
+
     double volume() const {
         assert(enable_bound);
         return box.volume();
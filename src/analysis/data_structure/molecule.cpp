@@ -6,12 +6,14 @@
 
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/range/numeric.hpp>
+#include <unordered_map>
 
 #include "ana_module/HBond.hpp"
 #include "config.h"
 #include "data_structure/atom.hpp"
 #include "data_structure/forcefield.hpp"
 #include "data_structure/frame.hpp"
+#include "data_structure/topology.hpp"
 #include "utils/PBCUtils.hpp"
 #include "utils/ThrowAssert.hpp"
 #include "utils/common.hpp"
@@ -32,82 +34,115 @@ void Molecule::calc_mass() {
 
 namespace {
 
-template <typename Func>
-class CenterVisitor : public boost::default_bfs_visitor {
+using PlanPosition = std::unordered_map<boost::graph_traits<graph_t>::vertex_descriptor, std::uint32_t>;
+
+class PlanVisitor : public boost::default_bfs_visitor {
 public:
-    explicit CenterVisitor(const std::shared_ptr<Frame> &frame, std::shared_ptr<Atom> &atom, Func f)
-        : frame(frame), func(std::move(f)) {
-        map[atom->vertex_descriptor] = atom->getCoordinate();
-    };
+    PlanVisitor(Molecule &mol, PlanPosition &position) : mol(mol), position(position) {}
 
     template <typename Edge, typename Graph>
     void tree_edge(Edge e, const Graph &g) {
-        const auto &source_loc = map[boost::source(e, g)];
-        const auto &target = g[boost::target(e, g)];
-        auto r = target->getCoordinate() - source_loc;
-        frame->image(r);
-        r += source_loc;
-        func(r, target);
-        map[boost::target(e, g)] = r;
+        auto parent = position[boost::source(e, g)]; // the first atom is not in position and gets 0
+        position[boost::target(e, g)] = mol.unwrap_atoms.size();
+        mol.unwrap_plan.emplace_back(parent, mol.unwrap_atoms.size());
+        mol.unwrap_atoms.push_back(g[boost::target(e, g)]);
     }
 
 private:
-    const std::shared_ptr<Frame> &frame;
-    std::map<boost::graph_traits<graph_t>::vertex_descriptor, std::tuple<double, double, double>> map;
-    Func func;
+    Molecule &mol;
+    PlanPosition &position;
 };
 
 }  // namespace
 
+const std::vector<std::tuple<double, double, double>> &Molecule::unwrapped_coordinates(
+    const std::shared_ptr<Frame> &frame) {
+    std::lock_guard lock(property_mutex);
+    const auto version = frame->coordinate_version();
+    if (unwrapped_version != version) {
+        unwrap(*frame, unwrapped);
+        unwrapped_version = version;
+    }
+    return unwrapped;
+}
+
+void Molecule::unwrap(const Frame &frame, std::vector<std::tuple<double, double, double>> &positions) const {
+    positions.resize(unwrap_plan.size() + 1);
+    positions[0] = atom_list.front()->getCoordinate();
+    for (const auto &[parent, child] : unwrap_plan) {
+        auto r = unwrap_atoms[child]->getCoordinate() - positions[parent];
+        frame.image(r);
+        positions[child] = r + positions[parent];
+    }
+}
+
+template <typename Func>
+std::tuple<double, double, double> Molecule::memoize(Property property, const std::shared_ptr<Frame> &frame,
+                                                     Func compute) {
+    std::lock_guard lock(property_mutex);
+    const auto version = frame->coordinate_version();
+    auto &[cached_version, value] = properties[static_cast<std::size_t>(property)];
+    if (cached_version != version) {
+        value = compute();
+        cached_version = version;
+    }
+    return value;
+}
+
 std::tuple<double, double, double> Molecule::calc_weigh_center(const std::shared_ptr<Frame> &frame,
                                                                bool includeHydrogen) {
-    double mol_mass = atom_list.front()->mass.value();
-    auto sum = atom_list.front()->getCoordinate() * mol_mass;
-
-    CenterVisitor vis(frame, atom_list.front(),
-                      [&sum, &mol_mass, includeHydrogen](auto &r, const std::shared_ptr<Atom> &atom) {
-                          if (!includeHydrogen and which(atom) == Symbol::Hydrogen) return;
-                          auto weight = atom->mass.value();
-                          mol_mass += weight;
-                          sum += weight * r;
-                      });
-    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(vis));
-    return sum / mol_mass;
+    auto property = includeHydrogen ? Property::WeighCenter : Property::HeavyAtomWeighCenter;
+    return memoize(property, frame, [&] {
+        const auto &positions = unwrapped_coordinates(frame);
+        double mol_mass = 0.0;
+        std::tuple<double, double, double> sum{};
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            const auto &atom = plan_atom(i);
+            // the first atom is always counted
+            if (i != 0 and !includeHydrogen and which(atom) == Symbol::Hydrogen) continue;
+            auto weight = atom->mass.value();
+            mol_mass += weight;
+            sum += weight * positions[i];
+        }
+        return sum / mol_mass;
+    });
 }
 
 std::tuple<double, double, double> Molecule::calc_charge_center(const std::shared_ptr<Frame> &frame) {
-    double mol_charge = atom_list.front()->charge.value();
-    std::tuple<double, double, double> sum = atom_list.front()->getCoordinate() * mol_charge;
-
-    CenterVisitor vis(frame, atom_list.front(), [&sum, &mol_charge](auto &r, const std::shared_ptr<Atom> &atom) {
-        auto charge = atom->charge.get();
-        mol_charge += charge;
-        sum += charge * r;
+    return memoize(Property::ChargeCenter, frame, [&] {
+        const auto &positions = unwrapped_coordinates(frame);
+        double mol_charge = 0.0;
+        std::tuple<double, double, double> sum{};
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            auto charge = plan_atom(i)->charge.value();
+            mol_charge += charge;
+            sum += charge * positions[i];
+        }
+        if (std::abs(mol_charge) < 1E-3) {
+            return calc_geom_center(frame);
+        }
+        return sum / mol_charge;
     });
-    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(vis));
-
-    if (std::abs(mol_charge) < 1E-3) {
-        return calc_geom_center(frame);
-    }
-    return sum / mol_charge;
 }
 
 std::tuple<double, double, double> Molecule::calc_dipole(const std::shared_ptr<Frame> &frame) {
-    auto dipole = atom_list.front()->getCoordinate() * atom_list.front()->charge.value();
-
-    CenterVisitor vis(frame, atom_list.front(), [&dipole](auto &r, const std::shared_ptr<Atom> &atom) {
-        auto charge = atom->charge.get();
-        dipole += charge * r;
+    return memoize(Property::Dipole, frame, [&] {
+        const auto &positions = unwrapped_coordinates(frame);
+        std::tuple<double, double, double> dipole{};
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            dipole += plan_atom(i)->charge.value() * positions[i];
+        }
+        return dipole;
     });
-    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(vis));
-    return dipole;
 }
 
 std::tuple<double, double, double> Molecule::calc_geom_center(const std::shared_ptr<Frame> &frame) {
-    auto sum = atom_list.front()->getCoordinate();
-    CenterVisitor vis(frame, atom_list.front(), [&sum](auto &r, const auto &) { sum += r; });
-    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(vis));
-    return sum / atom_list.size();
+    return memoize(Property::GeomCenter, frame, [&] {
+        const auto &positions = unwrapped_coordinates(frame);
+        return boost::accumulate(positions, std::tuple<double, double, double>{},
+                                 [](auto sum, const auto &r) { return sum + r; }) /
+               atom_list.size();
+    });
 }
 
 std::tuple<double, double, double> Molecule::calc_geom_center_inplace() {
@@ -120,7 +155,17 @@ std::tuple<double, double, double> Molecule::calc_geom_center_inplace() {
 }
 
 void Molecule::do_aggregate(const std::shared_ptr<Frame> &frame) {
-    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(AggregateVisitor(frame)));
+    // atoms may have been moved without sync_atom since the last unwrap, so the cache is not used
+    thread_local std::vector<std::tuple<double, double, double>> positions;
+    unwrap(*frame, positions);
+    for (std::size_t i = 1; i < positions.size(); ++i) {
+        const auto &atom = plan_atom(i);
+        std::tie(atom->x, atom->y, atom->z) = positions[i];
+    }
+    for (const auto &atom : atom_list) {
+        frame->sync_atom(*atom);
+    }
+    frame->coordinates_changed();
 }
 
 std::pair<double, std::array<std::shared_ptr<Atom>, 2>> min_distance(const std::shared_ptr<Molecule> &mol1,
@@ -145,9 +190,17 @@ void Molecule::build_graph(const std::shared_ptr<Frame> &frame) {
     for (auto &atom : atom_list) {
         atom->vertex_descriptor = boost::add_vertex(atom, g);
     }
+    const auto &topology = *frame->topology;
     for (auto &atom : atom_list) {
-        for (auto i : atom->con_list) {
-            boost::add_edge(atom->vertex_descriptor, frame->atom_map[i]->vertex_descriptor, g);
+        for (auto i : topology.bonded(atom->index)) {
+            boost::add_edge(atom->vertex_descriptor, frame->atom_list[i]->vertex_descriptor, g);
         }
     }
+    unwrap_plan.clear();
+    unwrap_atoms.clear();
+    if (atom_list.empty()) return;
+    unwrap_atoms.push_back(atom_list.front());
+    PlanPosition position;
+    PlanVisitor vis(*this, position);
+    boost::breadth_first_search(g, atom_list.front()->vertex_descriptor, boost::visitor(vis));
 }
@@ -5,7 +5,9 @@
 #ifndef TINKER_MOLECULE_HPP
 #define TINKER_MOLECULE_HPP
 
+#include <array>
 #include <boost/optional.hpp>
+#include <mutex>
 
 #include "utils/common.hpp"
 #include "utils/std.hpp"
@@ -52,7 +54,40 @@ public:
     graph_t g;
     void build_graph(const std::shared_ptr<Frame> &frame);
 
+    /*
+     *  breadth first spanning tree of g compiled by build_graph : atoms in visiting order (the first is
+     *  atom_list.front()) and (parent, child) positions in that order. Replaying the pairs unwraps the molecule
+     *  through periodic images for any PBCBox without traversing the graph again
+     */
+    std::vector<std::shared_ptr<Atom>> unwrap_atoms;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> unwrap_plan;
+
     std::tuple<double, double, double> inplace_geometry_center;
+
+private:
+    /*
+     *  positions of unwrap_atoms after replaying unwrap_plan on the current coordinates of frame, computed once per
+     *  Frame::coordinate_version. The buffer is shared, so only callers holding property_mutex may read it
+     */
+    const std::vector<std::tuple<double, double, double>> &unwrapped_coordinates(const std::shared_ptr<Frame> &frame);
+
+    void unwrap(const Frame &frame, std::vector<std::tuple<double, double, double>> &positions) const;
+
+    // atom at position i of the unwrap order, also without a plan (build_graph not called)
+    const std::shared_ptr<Atom> &plan_atom(std::size_t i) const { return i ? unwrap_atoms[i] : atom_list.front(); }
+
+    // centers and dipole memoized per frame version, shared by all tasks working on the same frame
+    enum class Property : std::size_t { GeomCenter, WeighCenter, HeavyAtomWeighCenter, ChargeCenter, Dipole, Count };
+
+    template <typename Func>
+    std::tuple<double, double, double> memoize(Property property, const std::shared_ptr<Frame> &frame, Func compute);
+
+    std::recursive_mutex property_mutex;
+    std::uint64_t unwrapped_version = 0;
+    std::vector<std::tuple<double, double, double>> unwrapped;
+    std::array<std::pair<std::uint64_t, std::tuple<double, double, double>>,
+               static_cast<std::size_t>(Property::Count)>
+        properties{};
 };
 
 std::pair<double, std::array<std::shared_ptr<Atom>, 2>> min_distance(const std::shared_ptr<Molecule> &mol1,
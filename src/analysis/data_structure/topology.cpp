@@ -0,0 +1,73 @@
+#include "topology.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+
+Topology::Topology(const Frame &frame) {
+    const auto &atoms = frame.atom_list;
+    const auto natoms = atoms.size();
+
+    std::size_t max_seq = 0;
+    for (const auto &atom : atoms) {
+        max_seq = std::max(max_seq, atom->seq);
+    }
+    seq_index.assign(natoms ? max_seq + 1 : 0, npos);
+    for (std::size_t i = 0; i < natoms; ++i) {
+        seq_index[atoms[i]->seq] = i;
+    }
+
+    bond_offsets.reserve(natoms + 1);
+    bond_offsets.push_back(0);
+    for (const auto &atom : atoms) {
+        for (auto seq : atom->con_list) {
+            if (auto j = index_of_seq(seq); j != npos) {
+                bond_targets.push_back(j);
+            }
+        }
+        bond_offsets.push_back(bond_targets.size());
+    }
+
+    atom_residue.assign(natoms, npos);
+    for (std::size_t i = 0; i < natoms; ++i) {
+        const auto &atom = atoms[i];
+        if (!atom->residue_num) {
+            continue;
+        }
+        const bool same = i > 0 and atom_residue[i - 1] != npos and atoms[i - 1]->residue_num == atom->residue_num and
+                          atoms[i - 1]->residue_name == atom->residue_name and
+                          atoms[i - 1]->molecule.lock() == atom->molecule.lock();
+        if (same) {
+            residue_ranges.back().second = i + 1;
+        } else {
+            residue_numbers.push_back(atom->residue_num.get());
+            residue_ranges.emplace_back(i, i + 1);
+        }
+        atom_residue[i] = residue_numbers.size() - 1;
+    }
+
+    std::unordered_map<const Molecule *, std::uint32_t> molecule_seq;
+    for (std::size_t m = 0; m < frame.molecule_list.size(); ++m) {
+        molecule_seq.emplace(frame.molecule_list[m].get(), m);
+    }
+    atom_molecule.assign(natoms, npos);
+    for (std::size_t i = 0; i < natoms; ++i) {
+        if (auto mol = atoms[i]->molecule.lock()) {
+            if (auto it = molecule_seq.find(mol.get()); it != molecule_seq.end()) {
+                atom_molecule[i] = it->second;
+            }
+        }
+    }
+    molecule_offsets.reserve(frame.molecule_list.size() + 1);
+    molecule_offsets.push_back(0);
+    for (const auto &mol : frame.molecule_list) {
+        for (const auto &atom : mol->atom_list) {
+            molecule_atom_indices.push_back(atom->index);
+        }
+        std::sort(molecule_atom_indices.begin() + molecule_offsets.back(), molecule_atom_indices.end());
+        molecule_offsets.push_back(molecule_atom_indices.size());
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TINKER_TOPOLOGY_HPP
+#define TINKER_TOPOLOGY_HPP
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+class Frame;
+
+/*
+ *  compact, read-only tables of a topology, all indexed by Atom::index :
+ *  bond adjacency in CSR form, atom -> residue and atom -> molecule arrays, atom ranges of residues and molecules,
+ *  and a dense Atom::seq -> Atom::index array. Built by Frame::index_atoms from Atom::con_list, the residue fields
+ *  of atoms and Frame::molecule_list, which stay the editable form of the topology
+ */
+class Topology {
+public:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    explicit Topology(const Frame &frame);
+
+    [[nodiscard]] std::size_t atom_count() const { return atom_residue.size(); }
+
+    // atoms bonded to atom i
+    [[nodiscard]] std::span<const std::uint32_t> bonded(std::size_t i) const {
+        return {bond_targets.data() + bond_offsets[i], bond_targets.data() + bond_offsets[i + 1]};
+    }
+
+    // residue of atom i, residues are runs of consecutive atoms with the same residue number, name and molecule
+    [[nodiscard]] std::uint32_t residue_of(std::size_t i) const { return atom_residue[i]; }
+
+    [[nodiscard]] std::size_t residue_count() const { return residue_numbers.size(); }
+
+    [[nodiscard]] unsigned residue_number(std::size_t r) const { return residue_numbers[r]; }
+
+    // atoms of residue r are [first, second)
+    [[nodiscard]] std::pair<std::uint32_t, std::uint32_t> residue_atoms(std::size_t r) const {
+        return residue_ranges[r];
+    }
+
+    // molecule of atom i as position in Frame::molecule_list
+    [[nodiscard]] std::uint32_t molecule_of(std::size_t i) const { return atom_molecule[i]; }
+
+    [[nodiscard]] std::size_t molecule_count() const { return molecule_offsets.size() - 1; }
+
+    [[nodiscard]] std::span<const std::uint32_t> molecule_atoms(std::size_t m) const {
+        return {molecule_atom_indices.data() + molecule_offsets[m],
+                molecule_atom_indices.data() + molecule_offsets[m + 1]};
+    }
+
+    [[nodiscard]] std::uint32_t index_of_seq(std::size_t seq) const {
+        return seq < seq_index.size() ? seq_index[seq] : npos;
+    }
+
+private:
+    std::vector<std::uint32_t> bond_offsets, bond_targets;
+    std::vector<std::uint32_t> atom_residue;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> residue_ranges;
+    std::vector<unsigned> residue_numbers;
+    std::vector<std::uint32_t> atom_molecule, molecule_offsets, molecule_atom_indices;
+    std::vector<std::uint32_t> seq_index;
+};
+
+#endif // TINKER_TOPOLOGY_HPP
@@ -0,0 +1,247 @@
+#include "AmberMaskIndex.hpp"
+
+#include <boost/fusion/include/at_c.hpp>
+#include <fnmatch.h>
+#include <mutex>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+
+namespace fusion = boost::fusion;
+using namespace AmberMaskAST;
+
+namespace {
+
+// same range rule as is_match : first, or first to last (in either order) every step counted from first
+template <typename T> bool in_range(T value, const numItemType &i) {
+    auto first = static_cast<long long>(fusion::at_c<0>(i));
+    const auto &op = fusion::at_c<1>(i);
+    if (!op)
+        return static_cast<long long>(value) == first;
+    auto last = static_cast<long long>(op.get().first);
+    auto v = static_cast<long long>(value);
+    return v >= std::min(first, last) and v <= std::max(first, last) and (v - first) % op.get().second == 0;
+}
+
+bool glob_match(const Name &pattern, const std::string &str) {
+    return fnmatch(pattern.name.c_str(), str.c_str(), 0) == 0;
+}
+
+} // namespace
+
+AmberMaskIndex::AmberMaskIndex(const std::shared_ptr<Frame> &frame) : natoms(frame->atom_list.size()) {
+    residue_numbers.resize(natoms);
+    real_residue_numbers.resize(natoms);
+    molecule_seqs.resize(natoms);
+    has_molecule.resize(natoms);
+    seqs.resize(natoms);
+    types.resize(natoms);
+
+    auto add_name = [this](NameTable &table, const std::string &name, std::size_t i) {
+        auto [it, inserted] = table.try_emplace(name);
+        if (inserted)
+            it->second.resize(natoms);
+        it->second.set(i);
+    };
+
+    for (std::size_t i = 0; i < natoms; ++i) {
+        const auto &atom = frame->atom_list[i];
+        seqs[i] = atom->seq;
+        types[i] = atom->typ;
+        add_name(atom_names, atom->atom_name, i);
+        add_name(type_names, atom->type_name, i);
+        if (atom->residue_name and atom->residue_num) {
+            residue_numbers[i] = atom->residue_num.get();
+            add_name(residue_names, atom->residue_name.get(), i);
+        } else {
+            has_residue = false;
+        }
+        if (atom->real_residue_number) {
+            real_residue_numbers[i] = atom->real_residue_number.get();
+        } else {
+            has_real_residue = false;
+        }
+        if (atom->atom_symbol) {
+            add_name(symbols, atom->atom_symbol.get(), i);
+        } else {
+            has_symbol = false;
+        }
+        if (auto mol = atom->molecule.lock()) {
+            has_molecule[i] = true;
+            molecule_seqs[i] = mol->sequence;
+        }
+    }
+}
+
+struct AmberMaskIndex::Evaluator : boost::static_visitor<Selection> {
+    explicit Evaluator(const AmberMaskIndex &index) : index(index) {}
+
+    Selection none() const { return Selection(index.natoms); }
+
+    // a name pattern, matched against the distinct names and, for globs without letters, the numbers too
+    template <typename T>
+    void match(const Name &pattern, const NameTable &names, const std::vector<T> &numbers, Selection &selected) const {
+        if (pattern.has_GLOB) {
+            for (const auto &[name, atoms] : names) {
+                if (glob_match(pattern, name))
+                    selected |= atoms;
+            }
+            if (!pattern.has_alpha) {
+                std::unordered_map<T, bool> matched;
+                for (std::size_t i = 0; i < index.natoms; ++i) {
+                    auto [it, inserted] = matched.try_emplace(numbers[i]);
+                    if (inserted)
+                        it->second = glob_match(pattern, std::to_string(numbers[i]));
+                    if (it->second)
+                        selected.set(i);
+                }
+            }
+        } else if (pattern.has_alpha) {
+            if (auto it = names.find(pattern.name); it != names.end())
+                selected |= it->second;
+        }
+    }
+
+    template <typename T> void match(const numItemType &item, const std::vector<T> &numbers, Selection &selected) const {
+        for (std::size_t i = 0; i < index.natoms; ++i) {
+            if (in_range(numbers[i], item))
+                selected.set(i);
+        }
+    }
+
+    template <typename T>
+    Selection match_all(const select_ranges &ranges, const NameTable &names, const std::vector<T> &numbers) const {
+        auto selected = none();
+        for (const auto &range : ranges) {
+            if (auto item = boost::get<numItemType>(&range)) {
+                match(*item, numbers, selected);
+            } else {
+                match(boost::get<Name>(range), names, numbers, selected);
+            }
+        }
+        return selected;
+    }
+
+    Selection operator()(const boost::blank &) const { return none(); }
+
+    Selection operator()(const std::shared_ptr<residue_name_nums> &residues) const {
+        if (!residues or index.natoms == 0)
+            return none();
+        if (!index.has_residue) {
+            throw std::runtime_error("residue selection syntax is invaild in current context");
+        }
+        return match_all(residues->val, index.residue_names, index.residue_numbers);
+    }
+
+    Selection operator()(const std::shared_ptr<real_residue_nums> &residues) const {
+        auto selected = none();
+        if (!residues or index.natoms == 0)
+            return selected;
+        if (!index.has_real_residue) {
+            throw std::runtime_error("residue selection syntax is invaild in current context");
+        }
+        for (const auto &item : residues->val) {
+            match(item, index.real_residue_numbers, selected);
+        }
+        return selected;
+    }
+
+    Selection operator()(const std::shared_ptr<molecule_nums> &molecules) const {
+        auto selected = none();
+        if (!molecules)
+            return selected;
+        for (const auto &item : molecules->val) {
+            auto first = static_cast<long long>(fusion::at_c<0>(item));
+            const auto &op = fusion::at_c<1>(item);
+            for (std::size_t i = 0; i < index.natoms; ++i) {
+                if (!index.has_molecule[i])
+                    continue;
+                auto seq = static_cast<long long>(index.molecule_seqs[i]);
+                if (op) {
+                    auto last = static_cast<long long>(fusion::at_c<0>(op.get()));
+                    auto step = fusion::at_c<1>(op.get()) ? fusion::at_c<1>(op.get()).get() : 1;
+                    if (seq >= std::min(first, last) and seq <= std::max(first, last) and (seq - first) % step == 0)
+                        selected.set(i);
+                } else if (seq == first) {
+                    selected.set(i);
+                }
+            }
+        }
+        return selected;
+    }
+
+    Selection operator()(const std::shared_ptr<atom_name_nums> &names) const {
+        return names ? match_all(names->val, index.atom_names, index.seqs) : none();
+    }
+
+    Selection operator()(const std::shared_ptr<atom_types> &types) const {
+        return types ? match_all(types->val, index.type_names, index.types) : none();
+    }
+
+    Selection operator()(const std::shared_ptr<atom_element_names> &ele) const {
+        auto selected = none();
+        if (!ele or index.natoms == 0)
+            return selected;
+        if (!index.has_symbol) {
+            throw std::runtime_error("atom element symbol selection syntax is invaild in current context");
+        }
+        for (const auto &pattern : ele->val) {
+            if (pattern.has_GLOB) {
+                for (const auto &[symbol, atoms] : index.symbols) {
+                    if (glob_match(pattern, symbol))
+                        selected |= atoms;
+                }
+            } else if (auto it = index.symbols.find(pattern.name); it != index.symbols.end()) {
+                selected |= it->second;
+            }
+        }
+        return selected;
+    }
+
+    Selection operator()(const std::shared_ptr<Operator> &op) const {
+        if (!op)
+            return none();
+        switch (op->op) {
+        case Op::NOT:
+            return ~boost::apply_visitor(*this, op->node1);
+        case Op::AND:
+            return boost::apply_visitor(*this, op->node1) & boost::apply_visitor(*this, op->node2);
+        case Op::OR:
+            return boost::apply_visitor(*this, op->node1) | boost::apply_visitor(*this, op->node2);
+        default:
+            throw std::runtime_error("invalid Operator");
+        }
+    }
+
+private:
+    const AmberMaskIndex &index;
+};
+
+AmberMaskIndex::Selection AmberMaskIndex::evaluate(const AmberMask &mask) const {
+    return boost::apply_visitor(Evaluator(*this), mask);
+}
+
+std::shared_ptr<const AmberMaskIndex::Selection> AmberMaskIndex::select(const AmberMask &mask,
+                                                                        const std::shared_ptr<Frame> &frame) {
+    static std::mutex mutex;
+    static std::weak_ptr<Frame> indexed_frame;
+    static std::uint64_t indexed_version;
+    static std::unique_ptr<AmberMaskIndex> index;
+    static std::unordered_map<std::string, std::shared_ptr<const Selection>> selections;
+
+    std::lock_guard lock(mutex);
+    if (!index or indexed_frame.lock() != frame or indexed_version != frame->topology_version() or
+        index->size() != frame->atom_list.size()) {
+        index = std::make_unique<AmberMaskIndex>(frame);
+        indexed_frame = frame;
+        indexed_version = frame->topology_version();
+        selections.clear();
+    }
+    auto key = to_string(mask);
+    if (auto it = selections.find(key); it != selections.end())
+        return it->second;
+    auto selection = std::make_shared<const Selection>(index->evaluate(mask));
+    selections.emplace(std::move(key), selection);
+    return selection;
+}
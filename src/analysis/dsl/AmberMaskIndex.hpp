@@ -0,0 +1,53 @@
+#ifndef TINKER_AMBERMASKINDEX_HPP
+#define TINKER_AMBERMASKINDEX_HPP
+
+#include <boost/dynamic_bitset.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dsl/AmberMask.hpp"
+
+class Frame;
+
+/*
+ *  lookup tables of one topology for evaluating AmberMask on all atoms at once.
+ *  every distinct residue name, atom name, type name and element owns the set of its atoms, numbers are kept
+ *  as plain arrays, so a mask becomes bitset algebra over Frame::atom_list positions and each name pattern is
+ *  matched once per distinct name instead of once per atom
+ */
+class AmberMaskIndex {
+public:
+    using Selection = boost::dynamic_bitset<>;
+
+    explicit AmberMaskIndex(const std::shared_ptr<Frame> &frame);
+
+    [[nodiscard]] Selection evaluate(const AmberMask &mask) const;
+
+    [[nodiscard]] std::size_t size() const { return natoms; }
+
+    /*
+     *  selection of mask over atoms of frame. The index of the frame is built on first use, selections are
+     *  cached by mask text and shared by all tasks until another topology is selected on or the topology version
+     *  of frame changes
+     */
+    static std::shared_ptr<const Selection> select(const AmberMask &mask, const std::shared_ptr<Frame> &frame);
+
+private:
+    using NameTable = std::unordered_map<std::string, Selection>;
+
+    struct Evaluator;
+
+    std::size_t natoms;
+
+    std::vector<uint> residue_numbers, real_residue_numbers, molecule_seqs;
+    std::vector<std::size_t> seqs;
+    std::vector<int> types;
+    bool has_residue = true, has_real_residue = true, has_symbol = true;
+    std::vector<bool> has_molecule;
+
+    NameTable residue_names, atom_names, type_names, symbols;
+};
+
+#endif // TINKER_AMBERMASKINDEX_HPP
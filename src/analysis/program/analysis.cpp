@@ -84,6 +84,8 @@ int main(int argc, char *argv[]) {
                 ? std::make_unique<ProgramConfiguration>(vm["config"].as<std::string>())
                 : std::make_unique<ProgramConfiguration>();
 
+        async_write_depth = getAsyncWriteDepth(vm);
+
         bool keep_silent = vm["silent"].as<bool>();
 
         /*
@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <typeindex>
 #include <vector>
 
 #if __has_include(<source_location>)
@@ -55,23 +56,59 @@ using namespace std::experimental;
 #include "trajectory_reader/trajectoryreader.hpp"
 #include "utils/IntertiaVector.hpp"
 #include "utils/NormalVectorSelector.hpp"
+#include "utils/PairKernel.hpp"
 #include "utils/ProgramConfiguration.hpp"
 #include "utils/ThrowAssert.hpp"
+#include "utils/TrajectoryRecordCopier.hpp"
 #include "utils/TwoAtomVectorSelector.hpp"
 #include "utils/TypeUtility.hpp"
 #include "utils/common.hpp"
 
 using namespace std;
 
+namespace {
+// pair kernels of the tasks in the frame loop, walked together before the tasks process the frame
+PairKernelDriver pair_kernels;
+
+// the first frame is checked for tasks moving atoms without sync_atom in all builds, later frames by debug builds
+bool check_coordinate_arrays = false;
+
+void ensure_coordinate_arrays_in_sync(const Frame &frame, AbstractAnalysis &task) {
+    if (!frame.coordinate_arrays_in_sync()) {
+        cerr << "task writing " << task.getOutfileName()
+             << " moved atoms without Frame::sync_atom, coordinate arrays are out of date\n";
+        exit(EXIT_FAILURE);
+    }
+}
+
+// frames from start to total_frames every step_size frames, 0 when reading until the end of the trajectory
+std::size_t selected_frames(int start, int total_frames, int step_size) {
+    return total_frames == 0 ? 0 : (total_frames - start) / step_size + 1;
+}
+} // namespace
+
 void processOneFrame(shared_ptr<Frame> &frame, shared_ptr<list<shared_ptr<AbstractAnalysis>>> &task_list) {
+    pair_kernels.run(*frame);
     for (auto &task : *task_list) {
         task->process(frame);
+        if (check_coordinate_arrays) ensure_coordinate_arrays_in_sync(*frame, *task);
+        // a task moved atoms without sync_atom
+        assert(frame->coordinate_arrays_in_sync());
     }
+    check_coordinate_arrays = false;
 }
 
-void processFirstFrame(shared_ptr<Frame> &frame, shared_ptr<list<shared_ptr<AbstractAnalysis>>> &task_list) {
+void processFirstFrame(shared_ptr<Frame> &frame, shared_ptr<list<shared_ptr<AbstractAnalysis>>> &task_list,
+                       std::size_t frames) {
+    pair_kernels.clear();
     for (auto &task : *task_list) {
         task->processFirstFrame(frame);
+        ensure_coordinate_arrays_in_sync(*frame, *task);
+    }
+    check_coordinate_arrays = true;
+    for (auto &task : *task_list) {
+        task->register_pair_kernels(pair_kernels);
+        if (frames) task->reserve_frames(frames);
     }
 }
 
@@ -81,9 +118,32 @@ void fastTrajectoryConvert(const boost::program_options::variables_map &vm, cons
         exit(EXIT_FAILURE);
     }
 
+    const string target = vm["target"].as<string>();
+    const uint start = vm.count("start") ? vm["start"].as<uint>() : 1;
+    const uint end = vm.count("end") ? vm["end"].as<uint>() : 0;
+    const uint step = vm.count("step") ? vm["step"].as<uint>() : 1;
+
+    /*
+     *  XTC to XTC and TRR to TRR without any atom selection, frame records are copied without decoding
+     */
+    auto time_before_process = std::chrono::steady_clock::now();
+    try {
+        TrajectoryRecordCopier copier(start, end, step, getCacheEnabled(vm));
+        if (auto frames = copier.copy(xyzfiles, boost::trim_copy(target))) {
+            auto total_time = chrono_cast(std::chrono::steady_clock::now() - time_before_process);
+            cout << "Fast Trajectory Copy... " << frames.get() << " frames written\n";
+            cout << "Mission Complete :) Time used  " << total_time << endl;
+            return;
+        }
+    } catch (std::runtime_error &e) {
+        std::cerr << e.what() << '\n';
+        exit(EXIT_FAILURE);
+    }
+
     auto reader = make_shared<TrajectoryReader>();
     if (boost::algorithm::one_of_equal<std::initializer_list<FileType>>(
-            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO}, getFileType(xyzfiles[0]))) {
+            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO, FileType::CACHE},
+            getFileType(xyzfiles[0]))) {
         if (!vm.count("topology")) {
             cerr << "ERROR !! topology file not set !\n";
             exit(EXIT_FAILURE);
@@ -108,18 +168,22 @@ void fastTrajectoryConvert(const boost::program_options::variables_map &vm, cons
         }
         reader->add_trajectoy_file(traj);
     }
+    reader->set_prefetch(getPrefetchDepth(vm));
+    reader->set_parallel_decode(getParallelDecode(vm));
+    reader->set_cache(getCacheEnabled(vm));
+    reader->set_frame_selection(start, end, step);
 
     shared_ptr<Frame> frame;
 
     Trajconv writer;
     try {
-        writer.fastConvertTo(vm["target"].as<string>());
+        writer.fastConvertTo(target);
     } catch (std::runtime_error &e) {
         std::cerr << e.what() << '\n';
         exit(EXIT_FAILURE);
     }
 
-    auto time_before_process = std::chrono::steady_clock::now();
+    time_before_process = std::chrono::steady_clock::now();
     cout << "Fast Trajectory Convert...\n";
 
     int current_frame_num = 0;
@@ -165,6 +229,29 @@ auto constexpr get_args_number(R (T::*)(ARGS...)) {
     return sizeof...(ARGS);
 }
 
+// AmberMask arguments of a task, boost::none if it has none or any argument may select atoms in other ways
+template <typename Args>
+boost::optional<std::vector<AmberMask>> collect_required_atoms(const Args &args) {
+    std::vector<AmberMask> masks;
+    for (const auto &arg : args) {
+        const auto &value = get<3>(arg);
+        if (value.type() == typeid(AmberMask)) {
+            const auto &mask = boost::any_cast<const AmberMask &>(value);
+            if (isBlank(mask)) {
+                return {};
+            }
+            masks.push_back(mask);
+        } else if (!boost::algorithm::one_of_equal<initializer_list<std::type_index>>(
+                       {typeid(int), typeid(double), typeid(bool), typeid(string), typeid(Grid)}, value.type())) {
+            return {};
+        }
+    }
+    if (masks.empty()) {
+        return {};
+    }
+    return masks;
+}
+
 template <typename T>
 struct FunObject {
     FunObject(std::shared_ptr<list<shared_ptr<AbstractAnalysis>>> &task_list, std::string name,
@@ -182,6 +269,7 @@ struct FunObject {
                  << ")\n";
             exit(EXIT_FAILURE);
         }
+        task->set_required_atoms(collect_required_atoms(args));
         print_desciption(task);
         task_list->emplace_back(task);
         return static_pointer_cast<AbstractAnalysis>(task);
@@ -533,12 +621,16 @@ void executeScript([[maybe_unused]] const boost::program_options::options_descri
     interpreter
         .registerFunction("go",
                           [&](auto &args) -> boost::any {
-                              int start, total_frames, step_size, nthreads;
+                              int start, total_frames, step_size, nthreads, prefetch, parallel_decode;
+                              bool cache;
                               try {
                                   start = AutoConvert(get<3>(args.at(0)));
                                   total_frames = AutoConvert(get<3>(args.at(1)));
                                   step_size = AutoConvert(get<3>(args.at(2)));
                                   nthreads = AutoConvert(get<3>(args.at(3)));
+                                  prefetch = AutoConvert(get<3>(args.at(4)));
+                                  parallel_decode = AutoConvert(get<3>(args.at(5)));
+                                  cache = AutoConvert(get<3>(args.at(6)));
                               } catch (std::exception &e) {
                                   cerr << e.what() << " for function go (" << __FILE__ << ":" << __LINE__ << ")\n";
                                   exit(EXIT_FAILURE);
@@ -546,12 +638,15 @@ void executeScript([[maybe_unused]] const boost::program_options::options_descri
 
                               return executeAnalysis(xyzfiles, argc, argv, scriptContent, script_file, topology,
                                                      forcefield_file, output_file, task_list, start, total_frames,
-                                                     step_size, nthreads);
+                                                     step_size, nthreads, prefetch, parallel_decode, cache);
                           })
         .addArgument<int>("start", 1)
         .addArgument<int>("end", 0)
         .addArgument<int>("step", 1)
-        .addArgument<int>("nthreads", 0);
+        .addArgument<int>("nthreads", 0)
+        .addArgument<int>("prefetch", 0)
+        .addArgument<int>("parallel_decode", 0)
+        .addArgument<bool>("cache", false);
 
     interpreter.execute(ast);
 
@@ -566,7 +661,8 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
                     boost::optional<string> &script_file, boost::optional<string> &topology,
                     boost::optional<string> &forcefield_file, const boost::optional<string> &output_file,
                     shared_ptr<list<shared_ptr<AbstractAnalysis>>> &task_list, int start, int total_frames,
-                    int step_size, int nthreads, const std::string &mask_string) {
+                    int step_size, int nthreads, int prefetch, int parallel_decode, bool cache,
+                    const std::string &mask_string) {
     if (task_list->empty()) {
         cerr << "Empty task in the pending list, skip go function ...\n";
         return 0;
@@ -574,9 +670,11 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
 
     auto start_time = chrono::steady_clock::now();
 
-    cout << boost::format("Start Process...  start = %d, end = %s, step = %d, nthreads = %s\n") % start %
-                (total_frames == 0 ? "all" : to_string(total_frames)) % step_size %
-                (nthreads == 0 ? "automatic" : to_string(nthreads));
+    cout << boost::format("Start Process...  start = %d, end = %s, step = %d, nthreads = %s, prefetch = %d, "
+                          "parallel_decode = %d, cache = %s\n") %
+                start % (total_frames == 0 ? "all" : to_string(total_frames)) % step_size %
+                (nthreads == 0 ? "automatic" : to_string(nthreads)) % prefetch % parallel_decode %
+                (cache ? "true" : "false");
 
     if (start <= 0) {
         cerr << "start frame cannot less than 1\n";
@@ -594,6 +692,14 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
         cerr << "thread number cannot less than zero\n";
         exit(EXIT_FAILURE);
     }
+    if (prefetch < 0) {
+        cerr << "prefetch frame number cannot less than zero\n";
+        exit(EXIT_FAILURE);
+    }
+    if (parallel_decode < 0) {
+        cerr << "parallel decode frame number cannot less than zero\n";
+        exit(EXIT_FAILURE);
+    }
     if (enable_forcefield) {
         if (topology && getFileType(topology.value()) != FileType::ARC) {
         } else if (forcefield_file) {
@@ -620,7 +726,8 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
     auto reader = make_shared<TrajectoryReader>();
     bool b_added_topology = true;
     if (boost::algorithm::one_of_equal<initializer_list<FileType>>(
-            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO}, getFileType(xyzfiles[0]))) {
+            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO, FileType::CACHE},
+            getFileType(xyzfiles[0]))) {
         b_added_topology = false;
     } else {
         if (topology) {
@@ -661,14 +768,34 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
         }
     }
     reader->set_mask(mask_string);
+    // read only atoms used by tasks when all of them tell which atoms they need
+    std::vector<AmberMask> required_masks;
+    for (auto &task : *task_list) {
+        if (!task->required_atoms()) {
+            required_masks.clear();
+            break;
+        }
+        required_masks.insert(required_masks.end(), task->required_atoms()->begin(), task->required_atoms()->end());
+    }
+    reader->set_required_atoms(std::move(required_masks));
+    reader->set_prefetch(prefetch);
+    reader->set_parallel_decode(parallel_decode);
+    reader->set_cache(cache);
+    reader->set_frame_selection(start, total_frames, step_size);
+    if (forcefield.isValid()) {
+        // before the first frame is read, so the required atoms are selected by the force field residues and elements
+        auto topology_frame = reader->readTopology();
+        forcefield.assign_forcefield(topology_frame);
+    }
 
     shared_ptr<Frame> frame;
     int Clear = 0;
     int current_frame_num = 0;
+    int processed_frame_num = 0;
     while ((frame = reader->readOneFrame())) {
-        current_frame_num++;
+        current_frame_num = reader->frame_number();
         if (total_frames != 0 and current_frame_num > total_frames) break;
-        if (current_frame_num % 10 == 0) {
+        if (++processed_frame_num % 10 == 0) {
             if (Clear) {
                 cout << "\r";
             }
@@ -677,10 +804,7 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
         }
         if (current_frame_num >= start && (current_frame_num - start) % step_size == 0) {
             if (current_frame_num == start) {
-                if (forcefield.isValid()) {
-                    forcefield.assign_forcefield(frame);
-                }
-                processFirstFrame(frame, task_list);
+                processFirstFrame(frame, task_list, selected_frames(start, total_frames, step_size));
             }
             processOneFrame(frame, task_list);
         }
@@ -703,6 +827,7 @@ int executeAnalysis(const vector<string> &xyzfiles, int argc, char *const *argv,
     cout << "Complete " << totol_task_count << " task(s)         Run Time "
          << chrono_cast(chrono::steady_clock::now() - start_time) << '\n';
 
+    pair_kernels.clear();
     task_list->clear();
     return totol_task_count;
 }
@@ -752,7 +877,8 @@ void processTrajectory(const boost::program_options::options_description &desc,
     auto reader = std::make_shared<TrajectoryReader>();
     bool b_added_topology = true;
     if (boost::algorithm::one_of_equal<std::initializer_list<FileType>>(
-            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO}, getFileType(xyzfiles[0]))) {
+            {FileType::NC, FileType::XTC, FileType::TRR, FileType::JSON, FileType::GRO, FileType::CACHE},
+            getFileType(xyzfiles[0]))) {
         b_added_topology = false;
     } else {
         if (vm.count("topology")) {
@@ -798,6 +924,10 @@ void processTrajectory(const boost::program_options::options_description &desc,
     }
 
     if (vm.count("mask")) reader->set_mask(vm["mask"].as<std::string>());
+    reader->set_prefetch(getPrefetchDepth(vm));
+    reader->set_parallel_decode(getParallelDecode(vm));
+    reader->set_cache(getCacheEnabled(vm));
+    reader->set_frame_selection(start, total_frames, step_size);
 
     std::shared_ptr<AbstractAnalysis> parallel_while_task;
     for (auto &task : *task_list) {
@@ -865,7 +995,7 @@ std::shared_ptr<Frame> getFrame(std::shared_ptr<std::list<std::shared_ptr<Abstra
                                 std::shared_ptr<TrajectoryReader> &reader) {
     std::shared_ptr<Frame> frame;
     while ((frame = reader->readOneFrame())) {
-        current_frame_num++;
+        current_frame_num = reader->frame_number();
         if (total_frames != 0 and current_frame_num > total_frames) break;
         std::cout << "\rProcessing Coordinate Frame  " << current_frame_num << "   " << std::flush;
         if (current_frame_num >= start && (current_frame_num - start) % step_size == 0) {
@@ -873,7 +1003,7 @@ std::shared_ptr<Frame> getFrame(std::shared_ptr<std::list<std::shared_ptr<Abstra
                 if (forcefield.isValid()) {
                     forcefield.assign_forcefield(frame);
                 }
-                processFirstFrame(frame, task_list);
+                processFirstFrame(frame, task_list, selected_frames(start, total_frames, step_size));
             }
             processOneFrame(frame, task_list);
             return frame;
@@ -10,40 +10,53 @@
 #include "utils/common.hpp"
 
 bool ArcTrajectoryReader::open(const std::string &file) {
-    ifs.open(file);
+    auto ok = arc_file.open(file);
     if (enable_read_velocity) {
         std::filesystem::path path(file);
         auto vel = path.parent_path() / (path.stem().string() + ".vel");
-        velocity_file.open(vel);
-        if (!velocity_file) {
+        if (!velocity_file.open(vel.string())) {
             std::cerr << "ERROR !! Could not open velocity file " << vel << '\n';
             std::exit(EXIT_FAILURE);
         }
     }
-    return static_cast<bool>(ifs);
+    return ok;
 }
 
-bool ArcTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
-                                           const std::vector<std::shared_ptr<Atom>> &atoms) {
-    std::getline(ifs, line);
+void ArcTrajectoryReader::close() {
+    arc_file.close();
+    velocity_file.close();
+}
+
+bool ArcTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    auto line = arc_file.getline();
     if (line.empty())
         return false;
 
-    if (frame->enable_bound) {
-        std::getline(ifs, line);
-        field = split(line);
+    if (buffer.enable_bound) {
+        split_line(arc_file.getline());
         if (field.empty())
             return false;
-        parse_box(frame);
+        buffer.box = parse_box();
     }
 
-    for (auto &atom : atoms) {
-        std::getline(ifs, line);
-        field = split(line);
-        parse_coord(atom);
+    // fast path: skip serial number and atom name, then three coordinates
+    auto wanted = buffer.subset.begin();
+    for (std::size_t i = 0; i < buffer.capacity; ++i) {
+        line = arc_file.getline();
+        if (!buffer.subset.empty()) {
+            if (wanted == buffer.subset.end() or *wanted != i)
+                continue;
+            ++wanted;
+        }
+        MappedTextFile::next_field(line);
+        MappedTextFile::next_field(line);
+        for (std::size_t k = 0; k < 3; ++k) {
+            buffer.x[3 * i + k] = MappedTextFile::to_double(MappedTextFile::next_field(line));
+        }
     }
+    buffer.natoms = buffer.capacity;
     if (enable_read_velocity)
-        readOneFrameVelocity(frame);
+        readOneFrameVelocity(buffer);
 
     return true;
 }
@@ -53,28 +66,25 @@ std::shared_ptr<Frame> ArcTrajectoryReader::read(const std::string &filename) {
 
     int atom_num = 0;
     auto frame = std::make_shared<Frame>();
-    std::getline(ifs, line);
-    field = split(line);
-    atom_num = std::stoi(field[0]);
-    frame->title = line.substr(line.rfind(field[0]) + field[0].size());
-    boost::trim(frame->title);
+    auto line = arc_file.getline();
+    split_line(line);
+    atom_num = MappedTextFile::to_int(field[0]);
+    frame->title = MappedTextFile::trim(line.substr(field[0].data() + field[0].size() - line.data()));
 
     if (frame->enable_bound) {
-        std::getline(ifs, line);
-        field = split(line);
+        split_line(arc_file.getline());
         if (field.empty())
             return {};
-        parse_box(frame);
+        frame->box = parse_box();
     }
 
     for (int i = 0; i < atom_num; i++) {
-        std::getline(ifs, line);
-        field = split(line);
+        split_line(arc_file.getline());
         if (i == 0) {
             if (field.empty())
                 return {};
             try {
-                parse_box(frame);
+                frame->box = parse_box();
                 frame->enable_bound = true;
                 i--;
                 continue;
@@ -83,12 +93,16 @@ std::shared_ptr<Frame> ArcTrajectoryReader::read(const std::string &filename) {
         }
 
         auto atom = std::make_shared<Atom>();
-        atom->seq = std::stoi(field[0]);
+        atom->seq = MappedTextFile::to_int(field[0]);
         atom->atom_name = field[1];
-        parse_coord(atom);
-        atom->typ = std::stoi(field[5]);
+        double xyz[3];
+        parse_coord(xyz);
+        atom->x = xyz[0];
+        atom->y = xyz[1];
+        atom->z = xyz[2];
+        atom->typ = MappedTextFile::to_int(field[5]);
         for (size_t j = 6; j < field.size(); j++) {
-            atom->con_list.push_back(std::stoi(field[j]));
+            atom->con_list.push_back(MappedTextFile::to_int(field[j]));
         }
         frame->atom_list.push_back(atom);
         frame->atom_map[atom->seq] = atom;
@@ -99,28 +113,48 @@ std::shared_ptr<Frame> ArcTrajectoryReader::read(const std::string &filename) {
     return frame;
 }
 
-void ArcTrajectoryReader::parse_coord(const std::shared_ptr<Atom> &atom) {
-    atom->x = std::stod(field[2]);
-    atom->y = std::stod(field[3]);
-    atom->z = std::stod(field[4]);
+void ArcTrajectoryReader::split_line(std::string_view line) {
+    field.clear();
+    for (auto f = MappedTextFile::next_field(line); !f.empty(); f = MappedTextFile::next_field(line)) {
+        field.push_back(f);
+    }
+}
+
+void ArcTrajectoryReader::parse_coord(double *xyz) {
+    if (field.size() < 6) {
+        throw std::invalid_argument("invalid atom line in arc file");
+    }
+    xyz[0] = MappedTextFile::to_double(field[2]);
+    xyz[1] = MappedTextFile::to_double(field[3]);
+    xyz[2] = MappedTextFile::to_double(field[4]);
 }
 
-void ArcTrajectoryReader::parse_box(std::shared_ptr<Frame> &frame) {
-    frame->box = PBCBox(std::stod(field[0]), std::stod(field[1]), std::stod(field[2]), std::stod(field[3]),
-                        std::stod(field[4]), std::stod(field[5]));
+PBCBox ArcTrajectoryReader::parse_box() {
+    if (field.size() < 6) {
+        throw std::invalid_argument("invalid box line in arc file");
+    }
+    return PBCBox(MappedTextFile::to_double(field[0]), MappedTextFile::to_double(field[1]),
+                  MappedTextFile::to_double(field[2]), MappedTextFile::to_double(field[3]),
+                  MappedTextFile::to_double(field[4]), MappedTextFile::to_double(field[5]));
 }
 
-void ArcTrajectoryReader::readOneFrameVelocity(std::shared_ptr<Frame> &frame) {
-    std::getline(velocity_file, line);
-    for (auto &atom : frame->atom_list) {
-        std::getline(velocity_file, line);
-        field = split(line);
-        auto len1 = field[2].length();
-        auto len2 = field[3].length();
-        auto len3 = field[4].length();
-        atom->vx = std::stod(field[2].replace(len1 - 4, 1, "E"));
-        atom->vy = std::stod(field[3].replace(len2 - 4, 1, "E"));
-        atom->vz = std::stod(field[4].replace(len3 - 4, 1, "E"));
+void ArcTrajectoryReader::readOneFrameVelocity(FrameBuffer &buffer) {
+    velocity_file.getline();
+    buffer.v.resize(buffer.x.size());
+    auto wanted = buffer.subset.begin();
+    for (std::size_t i = 0; i < buffer.natoms; ++i) {
+        auto line = velocity_file.getline();
+        if (!buffer.subset.empty()) {
+            if (wanted == buffer.subset.end() or *wanted != i)
+                continue;
+            ++wanted;
+        }
+        MappedTextFile::next_field(line);
+        MappedTextFile::next_field(line);
+        // velocities are written with Fortran D exponent
+        for (std::size_t k = 0; k < 3; ++k) {
+            buffer.v[3 * i + k] = MappedTextFile::to_double(MappedTextFile::next_field(line));
+        }
     }
-    frame->has_velocity = true;
+    buffer.has_velocity = true;
 }
@@ -1,8 +1,9 @@
 #ifndef TINKER_ARCTRAJECTORYREADER_HPP
 #define TINKER_ARCTRAJECTORYREADER_HPP
 
-#include <fstream>
+#include <string_view>
 
+#include "MappedTextFile.hpp"
 #include "TopologyInterface.hpp"
 #include "TrajectoryInterface.hpp"
 
@@ -14,22 +15,23 @@ public:
 
     std::shared_ptr<Frame> read(const std::string &filename) override;
 
-    void close() override{};
+    void close() override;
 
 protected:
-    bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
 
 private:
-    void parse_box(std::shared_ptr<Frame> &frame);
+    PBCBox parse_box();
 
-    void parse_coord(const std::shared_ptr<Atom> &atom);
+    void parse_coord(double *xyz);
 
-    void readOneFrameVelocity(std::shared_ptr<Frame> &frame);
+    void split_line(std::string_view line);
 
-    std::ifstream ifs, velocity_file;
+    void readOneFrameVelocity(FrameBuffer &buffer);
 
-    std::string line;
-    std::vector<std::string> field;
+    MappedTextFile arc_file, velocity_file;
+
+    std::vector<std::string_view> field; // views into the current line
 };
 
 #endif  // TINKER_ARCTRAJECTORYREADER_HPP
@@ -0,0 +1,72 @@
+#include "CacheTrajectoryReader.hpp"
+
+#include <cstring>
+
+bool CacheTrajectoryReader::open(const std::string &file) {
+    close();
+    try {
+        this->file.open(file);
+    } catch (std::exception &) {
+        std::cerr << "error open trajectory cache file: " << file << std::endl;
+        return false;
+    }
+    header = reinterpret_cast<const TrajectoryCache::Header *>(this->file.data());
+    if (this->file.size() < sizeof(TrajectoryCache::Header) or
+        std::memcmp(header->magic, TrajectoryCache::magic, sizeof(TrajectoryCache::magic)) != 0 or
+        header->table_offset + header->nframes * sizeof(TrajectoryCache::FrameEntry) != this->file.size()) {
+        std::cerr << "invalid trajectory cache file: " << file << std::endl;
+        close();
+        return false;
+    }
+    entries = reinterpret_cast<const TrajectoryCache::FrameEntry *>(this->file.data() + header->table_offset);
+    next_frame = 0;
+    return true;
+}
+
+bool CacheTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    if (!header or next_frame >= header->nframes)
+        return false;
+
+    static bool has_Warning_d = false;
+    if (!has_Warning_d and header->natoms != buffer.capacity) {
+        std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") % buffer.capacity %
+                         header->natoms;
+        has_Warning_d = true;
+    }
+
+    const auto &entry = entries[next_frame++];
+    const auto n = header->natoms;
+    const auto *x = reinterpret_cast<const float *>(file.data() + entry.offset);
+    const auto *y = x + n;
+    const auto *z = y + n;
+    buffer.natoms = std::min<std::size_t>(n, buffer.capacity);
+    buffer.for_each_atom([&](std::size_t i) {
+        buffer.x[3 * i] = x[i];
+        buffer.x[3 * i + 1] = y[i];
+        buffer.x[3 * i + 2] = z[i];
+    });
+    if (entry.has_box and buffer.enable_bound) {
+        const auto &box = entry.box;
+        buffer.box = PBCBox(box[0], box[1], box[2], box[3], box[4], box[5]);
+    }
+    if (entry.has_time) {
+        buffer.time = entry.time;
+    }
+    return true;
+}
+
+std::size_t CacheTrajectoryReader::skipFrames(std::size_t n, FrameBuffer &) {
+    if (!header)
+        return 0;
+    auto skipped = std::min<std::size_t>(n, header->nframes - std::min<std::size_t>(next_frame, header->nframes));
+    next_frame += skipped;
+    return skipped;
+}
+
+void CacheTrajectoryReader::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    header = nullptr;
+    entries = nullptr;
+}
@@ -0,0 +1,28 @@
+#ifndef TINKER_CACHETRAJECTORYREADER_HPP
+#define TINKER_CACHETRAJECTORYREADER_HPP
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "TrajectoryCache.hpp"
+#include "TrajectoryInterface.hpp"
+
+// reader of trajectory cache (*.cache), coordinates are copied straight from the memory-mapped file
+class CacheTrajectoryReader : public TrajectoryInterface {
+public:
+    bool open(const std::string &file) override;
+
+    void close() override;
+
+    std::size_t skipFrames(std::size_t n, FrameBuffer &buffer) override;
+
+protected:
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
+
+private:
+    boost::iostreams::mapped_file_source file;
+    const TrajectoryCache::Header *header = nullptr;
+    const TrajectoryCache::FrameEntry *entries = nullptr;
+    std::size_t next_frame = 0;
+};
+
+#endif // TINKER_CACHETRAJECTORYREADER_HPP
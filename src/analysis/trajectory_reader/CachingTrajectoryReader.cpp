@@ -0,0 +1,60 @@
+#include "CachingTrajectoryReader.hpp"
+
+CachingTrajectoryReader::CachingTrajectoryReader(std::shared_ptr<TrajectoryInterface> reader,
+                                                 std::string cache_filename)
+    : reader(std::move(reader)), cache_filename(std::move(cache_filename)) {}
+
+bool CachingTrajectoryReader::open(const std::string &file) {
+    source = file;
+    complete = failed = false;
+    return reader->open(file);
+}
+
+bool CachingTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    full.enable_bound = buffer.enable_bound;
+    if (full.capacity != buffer.capacity) {
+        full.reserve(buffer.capacity);
+    }
+    if (!reader->readOneFrame(full)) {
+        complete = true;
+        return false;
+    }
+
+    if (!failed) {
+        try {
+            if (!writer.is_open()) {
+                writer.open(cache_filename, full.natoms, source);
+            }
+            writer.write(full);
+        } catch (std::exception &e) {
+            std::cerr << "WARNING: trajectory cache " << cache_filename << " is not written, " << e.what() << '\n';
+            writer.discard();
+            failed = true;
+        }
+    }
+
+    std::swap(buffer.x, full.x);
+    std::swap(buffer.v, full.v);
+    buffer.natoms = full.natoms;
+    buffer.has_velocity = full.has_velocity;
+    buffer.box = full.box;
+    buffer.time = full.time;
+    buffer.title = full.title;
+    return true;
+}
+
+void CachingTrajectoryReader::close() {
+    if (complete and !failed) {
+        try {
+            writer.close();
+            LOG("write trajectory cache ", cache_filename, '\n');
+        } catch (std::exception &e) {
+            std::cerr << "WARNING: " << e.what() << '\n';
+        }
+    } else {
+        writer.discard();
+    }
+    reader->close();
+}
+
+CachingTrajectoryReader::~CachingTrajectoryReader() { writer.discard(); }
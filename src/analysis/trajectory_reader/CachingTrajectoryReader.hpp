@@ -0,0 +1,38 @@
+#ifndef TINKER_CACHINGTRAJECTORYREADER_HPP
+#define TINKER_CACHINGTRAJECTORYREADER_HPP
+
+#include "TrajectoryCache.hpp"
+#include "TrajectoryInterface.hpp"
+
+/*
+ *  pass frames of another reader through and write all of them to a trajectory cache on the way,
+ *  the cache is kept only when the trajectory has been read to the end
+ */
+class CachingTrajectoryReader : public TrajectoryInterface {
+public:
+    CachingTrajectoryReader(std::shared_ptr<TrajectoryInterface> reader, std::string cache_filename);
+
+    bool open(const std::string &file) override;
+
+    void close() override;
+
+    void setParallelDecode(std::size_t frames) override { reader->setParallelDecode(frames); }
+
+    void setWriteIndex(bool enable) override { reader->setWriteIndex(enable); }
+
+    ~CachingTrajectoryReader() override;
+
+protected:
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
+
+private:
+    std::shared_ptr<TrajectoryInterface> reader;
+    std::string cache_filename;
+    std::string source;
+    TrajectoryCacheWriter writer;
+    FrameBuffer full; // all atoms, whatever subset the caller wants
+    bool complete = false;
+    bool failed = false;
+};
+
+#endif // TINKER_CACHINGTRAJECTORYREADER_HPP
@@ -0,0 +1,59 @@
+#include "FrameBuffer.hpp"
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+
+void FrameBuffer::reserve(std::size_t atom_num) {
+    capacity = atom_num;
+    x.resize(3 * atom_num);
+    if (enable_read_velocity) {
+        v.resize(3 * atom_num);
+    }
+}
+
+void FrameBuffer::reset() {
+    natoms = 0;
+    has_velocity = false;
+    box.reset();
+    time.reset();
+    title.reset();
+}
+
+void FrameBuffer::apply(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) const {
+    frame->has_velocity = has_velocity;
+    const bool fill_arrays = frame->has_coordinate_arrays();
+    for_each_atom([&](std::size_t i) {
+        if (i >= atoms.size())
+            return;
+        auto &atom = atoms[i];
+        atom->x = x[3 * i];
+        atom->y = x[3 * i + 1];
+        atom->z = x[3 * i + 2];
+        if (has_velocity) {
+            atom->vx = v[3 * i];
+            atom->vy = v[3 * i + 1];
+            atom->vz = v[3 * i + 2];
+        }
+        if (fill_arrays) {
+            const auto j = atom->index;
+            frame->x[j] = x[3 * i];
+            frame->y[j] = x[3 * i + 1];
+            frame->z[j] = x[3 * i + 2];
+            if (has_velocity) {
+                frame->vx[j] = v[3 * i];
+                frame->vy[j] = v[3 * i + 1];
+                frame->vz[j] = v[3 * i + 2];
+            }
+        }
+    });
+    if (box) {
+        frame->box = box.get();
+    }
+    if (time) {
+        frame->setCurrentTime(time);
+    }
+    if (title) {
+        frame->title = title.value();
+    }
+    frame->coordinates_changed();
+}
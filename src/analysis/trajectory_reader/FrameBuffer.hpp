@@ -0,0 +1,53 @@
+#ifndef TINKER_FRAMEBUFFER_HPP
+#define TINKER_FRAMEBUFFER_HPP
+
+#include <boost/optional.hpp>
+#include <optional>
+
+#include "utils/PBCBox.hpp"
+#include "utils/std.hpp"
+
+class Atom;
+
+class Frame;
+
+/*
+ *  Coordinates of one decoded trajectory frame, detached from the Atom objects of the topology,
+ *  so a frame can be decoded ahead of time (e.g. on a prefetch thread) and applied later
+ */
+struct FrameBuffer {
+    // input, set by the owner before decoding
+    std::size_t capacity = 0; // number of atoms the caller wants
+    bool enable_bound = false;
+    std::vector<std::size_t> subset; // sorted indices (< capacity) of the only atoms wanted, empty for all atoms
+
+    // output, filled by TrajectoryInterface::readOneFrameImpl
+    std::size_t natoms = 0;  // number of atoms actually decoded, never larger than capacity
+    std::vector<double> x;   // Angstrom, natoms * 3, only atoms in subset are valid if subset is given
+    std::vector<double> v;   // Angstrom/ps, natoms * 3, valid when has_velocity
+    bool has_velocity = false;
+    boost::optional<PBCBox> box;
+    std::optional<float> time;
+    std::optional<std::string> title;
+
+    void reserve(std::size_t atom_num);
+
+    void reset();
+
+    void apply(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) const;
+
+    // call f(i) for every wanted atom i < natoms
+    template <typename Func>
+    void for_each_atom(Func &&f) const {
+        if (subset.empty()) {
+            for (std::size_t i = 0; i < natoms; ++i) f(i);
+        } else {
+            for (auto i : subset) {
+                if (i >= natoms) break;
+                f(i);
+            }
+        }
+    }
+};
+
+#endif // TINKER_FRAMEBUFFER_HPP
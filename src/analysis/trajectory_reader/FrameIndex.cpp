@@ -0,0 +1,276 @@
+#include "FrameIndex.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+
+constexpr char index_magic[8] = {'C', 'A', 'C', 'I', 'D', 'X', '0', '2'};
+
+constexpr std::int32_t xtc_magic = 1995;
+constexpr std::int32_t trr_magic = 1993;
+
+// big-endian reader for the XDR encoding of Gromacs trajectory files
+class XdrStream {
+public:
+    explicit XdrStream(const std::string &filename) : ifs(filename, std::ios::binary) {}
+
+    explicit operator bool() const { return static_cast<bool>(ifs); }
+
+    bool read(std::int32_t &value) {
+        std::uint32_t raw;
+        if (!ifs.read(reinterpret_cast<char *>(&raw), sizeof(raw)))
+            return false;
+        value = static_cast<std::int32_t>(boost::endian::big_to_native(raw));
+        return true;
+    }
+
+    bool read(float &value) {
+        std::uint32_t raw;
+        if (!ifs.read(reinterpret_cast<char *>(&raw), sizeof(raw)))
+            return false;
+        raw = boost::endian::big_to_native(raw);
+        std::memcpy(&value, &raw, sizeof(value));
+        return true;
+    }
+
+    bool read(double &value) {
+        std::uint64_t raw;
+        if (!ifs.read(reinterpret_cast<char *>(&raw), sizeof(raw)))
+            return false;
+        raw = boost::endian::big_to_native(raw);
+        std::memcpy(&value, &raw, sizeof(value));
+        return true;
+    }
+
+    // 9 box elements stored as Real
+    template <typename Real> bool read_box(std::array<float, 9> &box) {
+        for (auto &b : box) {
+            Real value;
+            if (!read(value))
+                return false;
+            b = static_cast<float>(value);
+        }
+        return true;
+    }
+
+    bool skip(std::uint64_t bytes) { return static_cast<bool>(ifs.seekg(bytes, std::ios::cur)); }
+
+    std::uint64_t tell() { return ifs.tellg(); }
+
+private:
+    std::ifstream ifs;
+};
+
+constexpr std::uint64_t xdr_padding(std::uint64_t bytes) { return (bytes + 3) / 4 * 4; }
+
+} // namespace
+
+boost::optional<FrameIndex> FrameIndex::load_or_build(const std::string &filename, FileType type,
+                                                      bool write_sidecar) {
+    if (type != FileType::XTC and type != FileType::TRR)
+        return {};
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename, ec);
+    if (ec)
+        return {};
+    auto mtime = std::filesystem::last_write_time(filename, ec);
+    if (ec)
+        return {};
+
+    FrameIndex index;
+    index.file_size = size;
+    index.file_mtime = mtime.time_since_epoch().count();
+
+    auto index_file = index_filename(filename);
+    if (index.load(index_file)) {
+        LOG("load frame index from ", index_file, '\n');
+        return index;
+    }
+    if (!(type == FileType::XTC ? index.build_xtc(filename) : index.build_trr(filename))) {
+        LOG("frame index is not available for ", filename, '\n');
+        return {};
+    }
+    if (write_sidecar and !index.save(index_file)) {
+        LOG("can not write frame index file ", index_file, '\n');
+    }
+    return index;
+}
+
+bool FrameIndex::load(const std::string &index_file) {
+    std::ifstream ifs(index_file, std::ios::binary);
+    if (!ifs)
+        return false;
+
+    char magic[sizeof(index_magic)];
+    std::uint64_t size;
+    std::int64_t mtime;
+    std::uint64_t count;
+    ifs.read(magic, sizeof(magic));
+    ifs.read(reinterpret_cast<char *>(&size), sizeof(size));
+    ifs.read(reinterpret_cast<char *>(&mtime), sizeof(mtime));
+    ifs.read(reinterpret_cast<char *>(&atom_num), sizeof(atom_num));
+    ifs.read(reinterpret_cast<char *>(&data_end), sizeof(data_end));
+    ifs.read(reinterpret_cast<char *>(&count), sizeof(count));
+    if (!ifs or std::memcmp(magic, index_magic, sizeof(magic)) != 0 or size != file_size or mtime != file_mtime)
+        return false;
+
+    entries.resize(count);
+    ifs.read(reinterpret_cast<char *>(entries.data()), count * sizeof(Entry));
+    if (!ifs) {
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool FrameIndex::save(const std::string &index_file) const {
+    static_assert(std::is_trivially_copyable_v<Entry>);
+
+    // write to a temporary file first, so concurrent runs never see a partial index
+    auto tmp_file = index_file + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream ofs(tmp_file, std::ios::binary);
+        if (!ofs)
+            return false;
+        std::uint64_t count = entries.size();
+        ofs.write(index_magic, sizeof(index_magic));
+        ofs.write(reinterpret_cast<const char *>(&file_size), sizeof(file_size));
+        ofs.write(reinterpret_cast<const char *>(&file_mtime), sizeof(file_mtime));
+        ofs.write(reinterpret_cast<const char *>(&atom_num), sizeof(atom_num));
+        ofs.write(reinterpret_cast<const char *>(&data_end), sizeof(data_end));
+        ofs.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        ofs.write(reinterpret_cast<const char *>(entries.data()), count * sizeof(Entry));
+        if (!ofs) {
+            ofs.close();
+            std::filesystem::remove(tmp_file);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_file, index_file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_file, ec);
+        return false;
+    }
+    return true;
+}
+
+/*
+ *  XTC frame : magic natoms step time box[9] natoms
+ *              natoms <= 9 : 3 * natoms float
+ *              otherwise   : precision minint[3] maxint[3] smallidx byte_count bytes[byte_count] (padding to 4)
+ */
+bool FrameIndex::build_xtc(const std::string &filename) {
+    XdrStream xdr(filename);
+    if (!xdr)
+        return false;
+
+    for (std::uint64_t offset = 0; offset < file_size; offset = xdr.tell()) {
+        std::int32_t magic, natoms, step, lsize;
+        Entry entry{offset, 0, 0.0f, {}};
+        if (!(xdr.read(magic) and xdr.read(natoms) and xdr.read(step) and xdr.read(entry.time)))
+            break;
+        if (magic != xtc_magic)
+            return false;
+        entry.step = step;
+        if (!xdr.read_box<float>(entry.box))
+            break; // incomplete frame at the end of file
+        if (!xdr.read(lsize))
+            break;
+
+        std::uint64_t payload;
+        if (lsize <= 9) {
+            payload = 3 * sizeof(float) * lsize;
+        } else {
+            std::int32_t byte_count;
+            if (!(xdr.skip(8 * sizeof(std::int32_t)) and xdr.read(byte_count)))
+                break;
+            payload = xdr_padding(byte_count);
+        }
+        if (xdr.tell() + payload > file_size)
+            break; // incomplete frame at the end of file
+        xdr.skip(payload);
+
+        atom_num = natoms;
+        data_end = xdr.tell();
+        entries.push_back(entry);
+    }
+    return !entries.empty();
+}
+
+/*
+ *  TRR frame : magic version_string ir_size e_size box_size vir_size pres_size top_size sym_size
+ *              x_size v_size f_size natoms step nre t lambda box vir pres x v f
+ *              t, lambda and all data blocks are double when box_size or x_size shows double precision
+ */
+bool FrameIndex::build_trr(const std::string &filename) {
+    XdrStream xdr(filename);
+    if (!xdr)
+        return false;
+
+    for (std::uint64_t offset = 0; offset < file_size; offset = xdr.tell()) {
+        std::int32_t magic, slen, len;
+        if (!(xdr.read(magic) and xdr.read(slen) and xdr.read(len)))
+            break;
+        if (magic != trr_magic)
+            return false;
+        if (!xdr.skip(xdr_padding(len)))
+            break;
+
+        std::int32_t ir_size, e_size, box_size, vir_size, pres_size, top_size, sym_size, x_size, v_size, f_size,
+            natoms, step, nre;
+        if (!(xdr.read(ir_size) and xdr.read(e_size) and xdr.read(box_size) and xdr.read(vir_size) and
+              xdr.read(pres_size) and xdr.read(top_size) and xdr.read(sym_size) and xdr.read(x_size) and
+              xdr.read(v_size) and xdr.read(f_size) and xdr.read(natoms) and xdr.read(step) and xdr.read(nre)))
+            break;
+        if (ir_size or e_size or top_size or sym_size)
+            return false;
+
+        std::size_t real_size = sizeof(float);
+        if (box_size) {
+            real_size = box_size / 9;
+        } else if (natoms > 0) {
+            for (auto block_size : {x_size, v_size, f_size}) {
+                if (block_size) {
+                    real_size = block_size / (3 * natoms);
+                    break;
+                }
+            }
+        }
+
+        Entry entry{offset, step, 0.0f, {}};
+        std::uint64_t payload = box_size + vir_size + pres_size + x_size + v_size + f_size;
+        if (real_size == sizeof(double)) {
+            double t, lambda;
+            if (!(xdr.read(t) and xdr.read(lambda)))
+                break;
+            entry.time = static_cast<float>(t);
+            if (box_size) {
+                if (!xdr.read_box<double>(entry.box))
+                    break;
+                payload -= box_size;
+            }
+        } else {
+            float lambda;
+            if (!(xdr.read(entry.time) and xdr.read(lambda)))
+                break;
+            if (box_size) {
+                if (!xdr.read_box<float>(entry.box))
+                    break;
+                payload -= box_size;
+            }
+        }
+        if (xdr.tell() + payload > file_size)
+            break; // incomplete frame at the end of file
+        xdr.skip(payload);
+
+        atom_num = natoms;
+        data_end = xdr.tell();
+        entries.push_back(entry);
+    }
+    return !entries.empty();
+}
@@ -0,0 +1,57 @@
+#ifndef TINKER_FRAMEINDEX_HPP
+#define TINKER_FRAMEINDEX_HPP
+
+#include <boost/optional.hpp>
+
+#include "utils/common.hpp"
+#include "utils/std.hpp"
+
+/*
+ *  Byte offsets, steps, times and boxes of all frames in a Gromacs XTC/TRR trajectory,
+ *  built by scanning frame headers (no decompression) and optionally cached in a sidecar file <trajectory>.idx
+ *  An up-to-date sidecar file is always used, it is rebuilt automatically when size or mtime of trajectory file
+ *  changed
+ */
+class FrameIndex {
+public:
+    struct Entry {
+        std::uint64_t offset; // byte offset of frame header
+        std::int64_t step;
+        float time;
+        std::array<float, 9> box; // nm, zero if trajectory has no box
+    };
+
+    // write_sidecar: save an index built by scanning to the sidecar file
+    [[nodiscard]] static boost::optional<FrameIndex> load_or_build(const std::string &filename, FileType type,
+                                                                   bool write_sidecar = false);
+
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+    [[nodiscard]] int natoms() const { return atom_num; }
+
+    const Entry &operator[](std::size_t i) const { return entries[i]; }
+
+    // size of frame i in bytes, including its header
+    [[nodiscard]] std::uint64_t frame_size(std::size_t i) const {
+        return (i + 1 < entries.size() ? entries[i + 1].offset : data_end) - entries[i].offset;
+    }
+
+    static std::string index_filename(const std::string &filename) { return filename + ".idx"; }
+
+private:
+    bool load(const std::string &index_file);
+
+    bool save(const std::string &index_file) const;
+
+    bool build_xtc(const std::string &filename);
+
+    bool build_trr(const std::string &filename);
+
+    std::uint64_t file_size = 0;
+    std::int64_t file_mtime = 0;
+    int atom_num = 0;
+    std::uint64_t data_end = 0; // end of the last complete frame
+    std::vector<Entry> entries;
+};
+
+#endif // TINKER_FRAMEINDEX_HPP
@@ -1,61 +1,74 @@
 
 #include "trajectory_reader/GroTrajectoryReader.hpp"
 
-#include <boost/algorithm/string.hpp>
 #include <cstring>
 
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "utils/common.hpp"
 
-bool GroTrajectoryReader::open(const std::string &file) {
-    ifs.open(file);
-    return static_cast<bool>(ifs);
-}
-
-bool GroTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
-                                           const std::vector<std::shared_ptr<Atom>> &atoms) {
-    std::string line;
-    std::getline(ifs, frame->title);
-    std::getline(ifs, line);
+bool GroTrajectoryReader::open(const std::string &file) { return gro_file.open(file); }
 
-    boost::trim(line);
+bool GroTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    auto title = gro_file.getline();
+    auto line = MappedTextFile::trim(gro_file.getline());
     if (line.empty())
         return false;
+    buffer.title = title;
 
-    auto total_atom_numbers = std::stoi(line);
-    if (total_atom_numbers != atoms.size()) {
+    auto total_atom_numbers = MappedTextFile::to_int(line);
+    if (total_atom_numbers != static_cast<int>(buffer.capacity)) {
         std::cerr << "atom number from gro file do not match topology\n";
         std::exit(EXIT_FAILURE);
     }
 
-    for (auto &atom : atoms) {
-        std::getline(ifs, line);
-        atom->x = 10 * std::stod(line.substr(20, 8));
-        atom->y = 10 * std::stod(line.substr(28, 8));
-        atom->z = 10 * std::stod(line.substr(36, 8));
+    // fixed columns %8.3f starting at column 20
+    auto wanted = buffer.subset.begin();
+    for (std::size_t i = 0; i < buffer.capacity; ++i) {
+        line = gro_file.getline();
+        if (!buffer.subset.empty()) {
+            if (wanted == buffer.subset.end() or *wanted != i)
+                continue;
+            ++wanted;
+        }
+        if (line.size() < 44) {
+            std::cerr << "atom line from gro file is too short\n";
+            std::exit(EXIT_FAILURE);
+        }
+        buffer.x[3 * i] = 10 * MappedTextFile::to_double(MappedTextFile::trim(line.substr(20, 8)));
+        buffer.x[3 * i + 1] = 10 * MappedTextFile::to_double(MappedTextFile::trim(line.substr(28, 8)));
+        buffer.x[3 * i + 2] = 10 * MappedTextFile::to_double(MappedTextFile::trim(line.substr(36, 8)));
     }
-    std::getline(ifs, line);
+    buffer.natoms = buffer.capacity;
+    line = gro_file.getline();
 
-    auto fields = split(line);
+    double fields[9];
+    std::size_t nfields = 0;
+    for (auto f = MappedTextFile::next_field(line); !f.empty() and nfields < 9; f = MappedTextFile::next_field(line)) {
+        fields[nfields++] = MappedTextFile::to_double(f);
+    }
+    if (nfields < 3) {
+        std::cerr << "box line from gro file is invalid\n";
+        std::exit(EXIT_FAILURE);
+    }
     gmx::matrix box;
     std::memset(box, 0, 9 * sizeof(gmx::real));
 
-    box[0][0] = std::stod(fields[0]);
-    box[1][1] = std::stod(fields[1]);
-    box[2][2] = std::stod(fields[2]);
+    box[0][0] = fields[0];
+    box[1][1] = fields[1];
+    box[2][2] = fields[2];
 
     // v1(x) v2(y) v3(z) v1(y) v1(z) v2(x) v2(z) v3(x) v3(y);
-    if (fields.size() > 3) {
-        box[0][1] = std::stod(fields[3]);
-        box[0][2] = std::stod(fields[4]);
-        box[1][0] = std::stod(fields[5]);
-        box[1][2] = std::stod(fields[6]);
-        box[2][0] = std::stod(fields[7]);
-        box[2][1] = std::stod(fields[8]);
+    if (nfields == 9) {
+        box[0][1] = fields[3];
+        box[0][2] = fields[4];
+        box[1][0] = fields[5];
+        box[1][2] = fields[6];
+        box[2][0] = fields[7];
+        box[2][1] = fields[8];
     }
-    frame->box = PBCBox(box);
+    buffer.box = PBCBox(box);
     return true;
 }
 
-void GroTrajectoryReader::close() { ifs.close(); }
+void GroTrajectoryReader::close() { gro_file.close(); }
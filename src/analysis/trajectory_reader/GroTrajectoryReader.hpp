@@ -1,8 +1,7 @@
 #ifndef TINKER_GROTRAJECTORYREADER_HPP
 #define TINKER_GROTRAJECTORYREADER_HPP
 
-#include <fstream>
-
+#include "MappedTextFile.hpp"
 #include "TrajectoryInterface.hpp"
 
 class GroTrajectoryReader : public TrajectoryInterface {
@@ -12,9 +11,9 @@ public:
     void close() override;
 
 protected:
-    bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
 
-    std::ifstream ifs;
+    MappedTextFile gro_file;
 };
 
 #endif  // TINKER_GROTRAJECTORYREADER_HPP
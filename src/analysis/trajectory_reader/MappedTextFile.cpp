@@ -0,0 +1,107 @@
+#include "MappedTextFile.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <sys/mman.h>
+
+bool MappedTextFile::open(const std::string &filename) {
+    close();
+    try {
+        file.open(filename);
+    } catch (std::exception &) {
+        return false;
+    }
+    pos = file.data();
+    end = pos + file.size();
+    if (file.size()) {
+        // trajectories are read once from the beginning to the end
+        ::posix_madvise(const_cast<char *>(file.data()), file.size(), POSIX_MADV_SEQUENTIAL);
+    }
+    return true;
+}
+
+void MappedTextFile::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    pos = end = nullptr;
+}
+
+std::string_view MappedTextFile::getline() {
+    if (pos == end)
+        return {};
+    auto first = pos;
+    auto last = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+    if (last) {
+        pos = last + 1;
+    } else {
+        pos = last = end;
+    }
+    if (last != first and *(last - 1) == '\r') {
+        --last;
+    }
+    return {first, static_cast<std::size_t>(last - first)};
+}
+
+bool MappedTextFile::skiplines(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (eof())
+            return false;
+        getline();
+    }
+    return true;
+}
+
+namespace {
+inline bool is_space(char c) { return c == ' ' or c == '\t' or c == '\r' or c == '\n' or c == '\v' or c == '\f'; }
+} // namespace
+
+std::string_view MappedTextFile::next_field(std::string_view &line) {
+    std::size_t i = 0;
+    while (i < line.size() and is_space(line[i])) ++i;
+    std::size_t j = i;
+    while (j < line.size() and !is_space(line[j])) ++j;
+    auto field = line.substr(i, j - i);
+    line.remove_prefix(j);
+    return field;
+}
+
+std::string_view MappedTextFile::trim(std::string_view str) {
+    while (!str.empty() and is_space(str.front())) str.remove_prefix(1);
+    while (!str.empty() and is_space(str.back())) str.remove_suffix(1);
+    return str;
+}
+
+double MappedTextFile::to_double(std::string_view field) {
+    if (!field.empty() and field.front() == '+') {
+        field.remove_prefix(1);
+    }
+    double value;
+    auto last = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), last, value);
+    if (ec != std::errc()) {
+        throw std::invalid_argument("invalid floating-point number <" + std::string(field) + ">");
+    }
+    if (ptr != last and (*ptr == 'D' or *ptr == 'd')) {
+        // Fortran exponent, parse again from a copy on the stack with E
+        char str[64];
+        if (field.size() >= sizeof(str)) {
+            throw std::invalid_argument("invalid floating-point number <" + std::string(field) + ">");
+        }
+        std::memcpy(str, field.data(), field.size());
+        str[ptr - field.data()] = 'E';
+        std::from_chars(str, str + field.size(), value);
+    }
+    return value;
+}
+
+int MappedTextFile::to_int(std::string_view field) {
+    if (!field.empty() and field.front() == '+') {
+        field.remove_prefix(1);
+    }
+    int value;
+    if (std::from_chars(field.data(), field.data() + field.size(), value).ec != std::errc()) {
+        throw std::invalid_argument("invalid integer <" + std::string(field) + ">");
+    }
+    return value;
+}
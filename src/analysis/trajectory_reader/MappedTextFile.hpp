@@ -0,0 +1,45 @@
+#ifndef TINKER_MAPPEDTEXTFILE_HPP
+#define TINKER_MAPPEDTEXTFILE_HPP
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <string_view>
+
+#include "utils/std.hpp"
+
+/*
+ *  Line-by-line scanner over a memory-mapped text file, lines and fields are views into the mapping,
+ *  so parsing a frame does not allocate. Numbers are parsed with std::from_chars
+ */
+class MappedTextFile {
+public:
+    bool open(const std::string &filename);
+
+    void close();
+
+    [[nodiscard]] bool is_open() const { return file.is_open(); }
+
+    [[nodiscard]] bool eof() const { return pos == end; }
+
+    // next line without line terminator, empty view at end of file
+    std::string_view getline();
+
+    // skip n lines, return false if end of file reached before
+    bool skiplines(std::size_t n);
+
+    // next whitespace delimited field, removed from the front of line; empty view if none left
+    static std::string_view next_field(std::string_view &line);
+
+    static std::string_view trim(std::string_view str);
+
+    // accept Fortran double precision exponent (1.0D-03) too; throw std::invalid_argument as std::stod
+    static double to_double(std::string_view field);
+
+    static int to_int(std::string_view field);
+
+private:
+    boost::iostreams::mapped_file_source file;
+    const char *pos = nullptr;
+    const char *end = nullptr;
+};
+
+#endif // TINKER_MAPPEDTEXTFILE_HPP
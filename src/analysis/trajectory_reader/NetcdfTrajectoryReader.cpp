@@ -3,39 +3,164 @@
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 
+namespace {
+// upper bound of coordinates read with one request
+constexpr std::size_t max_block_bytes = 32 * 1024 * 1024;
+constexpr std::size_t max_block_frames = 64;
+} // namespace
+
 bool NetcdfTrajectoryReader::open(const std::string &file) {
     NC = std::make_unique<struct AmberNetcdf>();
     if (netcdfLoad(NC.get(), file.c_str())) {
         std::cerr << "error open NETCDF file: " << file << std::endl;
         return false;
     }
+    next_frame = 0;
+    has_last_frame = false;
+    block_size = 0;
+    runs_capacity = 0;
+    atom_runs.clear();
     return true;
 }
 
-bool NetcdfTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
-                                              const std::vector<std::shared_ptr<Atom>> &atoms) {
-    auto coord = std::make_unique<double[]>(NC->ncatom3);
-    double box[6];
-    if (!netcdfGetNextFrame(NC.get(), coord.get(), box))
-        return false;
-
+bool NetcdfTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
     static bool has_Warning_d = false;
-    if (!has_Warning_d and NC->ncatom != static_cast<int>(atoms.size())) {
-        std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") % atoms.size() %
+    if (!has_Warning_d and NC->ncatom != static_cast<int>(buffer.capacity)) {
+        std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") % buffer.capacity %
                          NC->ncatom;
         has_Warning_d = true;
     }
+    if (NC->isNCrestart)
+        return readRestart(buffer);
+
+    if (next_frame >= static_cast<std::size_t>(NC->ncframe))
+        return false;
+
+    updateAtomRuns(buffer);
+    if (atom_runs.empty())
+        return false;
+
+    if (next_frame < block_first or next_frame >= block_first + block_size * block_stride or
+        (next_frame - block_first) % block_stride) {
+        auto stride = has_last_frame and next_frame > last_frame ? next_frame - last_frame : 1;
+        if (!readBlock(next_frame, stride))
+            return false;
+    }
 
-    for (auto i : boost::irange(NC->ncatom)) {
-        auto &atom = atoms[i];
-        atom->x = coord[3 * i];
-        atom->y = coord[3 * i + 1];
-        atom->z = coord[3 * i + 2];
+    auto k = (next_frame - block_first) / block_stride;
+    const float *src = block.data() + 3 * run_atoms * k;
+    for (const auto &run : atom_runs) {
+        for (int j = 0; j < run.count; ++j) {
+            auto i = 3 * static_cast<std::size_t>(run.start + j * run.stride);
+            buffer.x[i] = src[0];
+            buffer.x[i + 1] = src[1];
+            buffer.x[i + 2] = src[2];
+            src += 3;
+        }
     }
-    frame->box = PBCBox(box[0], box[1], box[2], box[3], box[4], box[5]);
+    buffer.natoms = std::min<std::size_t>(NC->ncatom, buffer.capacity);
+    if (NC->cellLengthVID != -1) {
+        const double *length = block_box.data() + 3 * k;
+        const double *angle = block_box.data() + 3 * (block_size + k);
+        buffer.box = PBCBox(length[0], length[1], length[2], angle[0], angle[1], angle[2]);
+    }
+    last_frame = next_frame++;
+    has_last_frame = true;
     return true;
 }
 
+bool NetcdfTrajectoryReader::readRestart(FrameBuffer &buffer) {
+    coord.resize(NC->ncatom3);
+    double box[6];
+    if (!netcdfGetNextFrame(NC.get(), coord.data(), box))
+        return false;
+
+    buffer.natoms = std::min<std::size_t>(NC->ncatom, buffer.capacity);
+    std::copy_n(coord.begin(), 3 * buffer.natoms, buffer.x.begin());
+    if (NC->cellLengthVID != -1) {
+        buffer.box = PBCBox(box[0], box[1], box[2], box[3], box[4], box[5]);
+    }
+    return true;
+}
+
+// split atoms wanted by buffer into arithmetic runs, a contiguous selection is a single run
+void NetcdfTrajectoryReader::updateAtomRuns(const FrameBuffer &buffer) {
+    if (runs_capacity == buffer.capacity and runs_subset == buffer.subset)
+        return;
+    runs_capacity = buffer.capacity;
+    runs_subset = buffer.subset;
+    atom_runs.clear();
+    block_size = 0;
+
+    const auto natoms = std::min<std::size_t>(NC->ncatom, buffer.capacity);
+    if (buffer.subset.empty()) {
+        if (natoms)
+            atom_runs.push_back({0, static_cast<int>(natoms), 1});
+    } else {
+        const auto &subset = buffer.subset;
+        const auto n = std::lower_bound(subset.begin(), subset.end(), natoms) - subset.begin();
+        for (std::ptrdiff_t p = 0; p < n;) {
+            AtomRun run{static_cast<int>(subset[p]), 1, 1};
+            if (p + 1 < n) {
+                run.stride = static_cast<int>(subset[p + 1] - subset[p]);
+                while (p + run.count < n and
+                       subset[p + run.count] - subset[p + run.count - 1] == static_cast<std::size_t>(run.stride)) {
+                    ++run.count;
+                }
+            }
+            atom_runs.push_back(run);
+            p += run.count;
+        }
+    }
+    run_atoms = 0;
+    for (const auto &run : atom_runs) {
+        run_atoms += run.count;
+    }
+}
+
+// read frames first, first + stride, ... into block, one hyperslab request per atom run
+bool NetcdfTrajectoryReader::readBlock(std::size_t first, std::size_t stride) {
+    auto frames = std::clamp<std::size_t>(max_block_bytes / (sizeof(float) * 3 * run_atoms), 1, max_block_frames);
+    frames = std::min(frames, (NC->ncframe - first - 1) / stride + 1);
+
+    block.resize(3 * run_atoms * frames);
+    block_box.resize(6 * frames);
+    block_size = 0;
+
+    // coordinates of a run are read as [frame][atom][3], rearrange to [frame][run atoms][3]
+    std::size_t offset = 0;
+    for (const auto &run : atom_runs) {
+        float *dest = block.data();
+        if (atom_runs.size() > 1) {
+            block_scratch.resize(3 * run.count * frames);
+            dest = block_scratch.data();
+        }
+        if (netcdfGetFrameBlock(NC.get(), first, frames, stride, run.start, run.count, run.stride, dest,
+                                offset == 0 ? block_box.data() : nullptr)) {
+            return false;
+        }
+        if (atom_runs.size() > 1) {
+            for (std::size_t k = 0; k < frames; ++k) {
+                std::copy_n(block_scratch.begin() + 3 * run.count * k, 3 * run.count,
+                            block.begin() + 3 * (run_atoms * k + offset));
+            }
+        }
+        offset += run.count;
+    }
+    block_first = first;
+    block_stride = stride;
+    block_size = frames;
+    return true;
+}
+
+std::size_t NetcdfTrajectoryReader::skipFrames(std::size_t n, FrameBuffer &buffer) {
+    if (NC->isNCrestart)
+        return TrajectoryInterface::skipFrames(n, buffer);
+    auto skipped = std::min<std::size_t>(n, NC->ncframe - std::min<std::size_t>(next_frame, NC->ncframe));
+    next_frame += skipped;
+    return skipped;
+}
+
 void NetcdfTrajectoryReader::close() {
     if (NC) {
         netcdfClose(NC.get());
@@ -10,13 +10,45 @@ public:
 
     void close() override;
 
+    std::size_t skipFrames(std::size_t n, FrameBuffer &buffer) override;
+
     ~NetcdfTrajectoryReader() override;
 
 protected:
-    bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
 
 private:
+    // atoms start, start + stride, ... start + (count - 1) * stride, read with one hyperslab request
+    struct AtomRun {
+        int start;
+        int count;
+        int stride;
+    };
+
+    bool readRestart(FrameBuffer &buffer);
+
+    void updateAtomRuns(const FrameBuffer &buffer);
+
+    bool readBlock(std::size_t first, std::size_t stride);
+
     std::unique_ptr<struct AmberNetcdf> NC;
+
+    std::size_t next_frame = 0;
+    std::size_t last_frame = 0; // last frame returned, its distance to next one predicts the stride of next block
+    bool has_last_frame = false;
+
+    std::size_t runs_capacity = 0;
+    std::vector<std::size_t> runs_subset;
+    std::vector<AtomRun> atom_runs;
+    std::size_t run_atoms = 0; // atoms per frame in block
+
+    // persistent storage for a block of frames
+    std::vector<float> block;
+    std::vector<float> block_scratch; // one atom run of the block while there are several runs
+    std::vector<double> block_box;
+    std::size_t block_first = 0, block_stride = 1, block_size = 0;
+
+    std::vector<double> coord; // restart file only
 };
 
 #endif // TINKER_NETCDFTRAJECTORYREADER_HPP
@@ -2,6 +2,7 @@
 #include "trajectory_reader/ReaderFactory.hpp"
 
 #include "trajectory_reader/ArcTrajectoryReader.hpp"
+#include "trajectory_reader/CacheTrajectoryReader.hpp"
 #include "trajectory_reader/GroTrajectoryReader.hpp"
 #include "trajectory_reader/Mol2Reader.hpp"
 #include "trajectory_reader/NetcdfTrajectoryReader.hpp"
@@ -27,7 +28,8 @@ std::shared_ptr<TrajectoryInterface> ReaderFactory::getTrajectory(const std::str
         {FileType::TRR, [] { return std::make_shared<TrrTrajectoryReader>(); }},
         {FileType::XTC, [] { return std::make_shared<XtcTrajectoryReader>(); }},
         {FileType::ARC, [] { return std::make_shared<ArcTrajectoryReader>(); }},
-        {FileType::GRO, [] { return std::make_shared<GroTrajectoryReader>(); }}};
+        {FileType::GRO, [] { return std::make_shared<GroTrajectoryReader>(); }},
+        {FileType::CACHE, [] { return std::make_shared<CacheTrajectoryReader>(); }}};
     auto it = mapping.find(getFileType(filename));
     return it != std::end(mapping) ? it->second.operator()() : std::shared_ptr<TrajectoryInterface>{};
 }
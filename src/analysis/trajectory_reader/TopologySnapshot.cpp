@@ -0,0 +1,406 @@
+#include "TopologySnapshot.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "trajectory_reader/TrajectoryCache.hpp"
+
+/*
+ *  Snapshot file : Header AtomRecord[natoms] con[ncon] MoleculeRecord[nmolecules] molecule_atoms[nmolecule_atoms]
+ *                  BondRecord[nbonds] AngleRecord[nangles] DihedralRecord[ndihedrals + nimpropers] strings
+ *  atoms are referred by index of atom_list, except con which holds atom seq like Atom::con_list
+ *  strings are title, then atom_name, type_name, residue_name and atom_symbol (when present) of every atom,
+ *  each one stored as length followed by characters. All values are in native byte order
+ */
+namespace {
+
+constexpr char snapshot_magic[8] = {'T', 'O', 'P', 'S', 'N', 'P', '0', '1'};
+
+struct Header {
+    char magic[8];
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    std::uint64_t natoms;
+    std::uint64_t ncon;
+    std::uint64_t nmolecules;
+    std::uint64_t nmolecule_atoms;
+    std::uint64_t nbonds;
+    std::uint64_t nangles;
+    std::uint64_t ndihedrals;
+    std::uint64_t nimpropers;
+    std::uint32_t has_box;
+    std::uint32_t padding;
+    std::array<double, 6> box;
+};
+
+enum AtomFlag : std::uint32_t {
+    AT_NO = 1u << 0,
+    CHARGE = 1u << 1,
+    MASS = 1u << 2,
+    LJ_PARAM = 1u << 3,
+    RESIDUE_NAME = 1u << 4,
+    RESIDUE_NUM = 1u << 5,
+    REAL_RESIDUE_NUMBER = 1u << 6,
+    ATOM_SYMBOL = 1u << 7,
+};
+
+struct AtomRecord {
+    std::uint64_t seq;
+    std::int32_t typ;
+    std::int32_t at_no;
+    std::uint32_t flags;
+    std::uint32_t ncon;
+    std::uint32_t residue_num;
+    std::uint32_t real_residue_number;
+    double x, y, z;
+    double charge, mass, c6, c12;
+};
+
+struct MoleculeRecord {
+    std::uint32_t sequence;
+    std::uint32_t natoms;
+};
+
+struct BondRecord {
+    std::uint32_t atoms[2];
+    Frame::harmonic param;
+};
+
+struct AngleRecord {
+    std::uint32_t atoms[3];
+    Frame::harmonic param;
+};
+
+struct DihedralRecord {
+    std::uint32_t atoms[4];
+    Frame::pdihs param;
+};
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ofstream &ofs) : ofs(ofs) {}
+
+    template <typename T> void put(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        ofs.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void put(const std::string &value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        ofs.write(value.data(), value.size());
+    }
+
+private:
+    std::ofstream &ofs;
+};
+
+class SnapshotCursor {
+public:
+    SnapshotCursor(const char *begin, const char *end) : pos(begin), end(end) {}
+
+    template <typename T> bool get(T *values, std::size_t n = 1) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (static_cast<std::size_t>(end - pos) / sizeof(T) < n)
+            return false;
+        std::memcpy(values, pos, n * sizeof(T));
+        pos += n * sizeof(T);
+        return true;
+    }
+
+    bool get(std::string &value) {
+        std::uint32_t size;
+        if (!get(&size) or static_cast<std::size_t>(end - pos) < size)
+            return false;
+        value.assign(pos, size);
+        pos += size;
+        return true;
+    }
+
+    [[nodiscard]] bool at_end() const { return pos == end; }
+
+private:
+    const char *pos;
+    const char *end;
+};
+
+template <typename Record, typename Map, typename Index>
+void put_params(SnapshotWriter &writer, const Map &params, const Index &index) {
+    for (const auto &[key, param] : params) {
+        Record record{};
+        for (std::size_t i = 0; i < key.size(); ++i) {
+            record.atoms[i] = index.at(key[i].get());
+        }
+        record.param = param;
+        writer.put(record);
+    }
+}
+
+template <typename Record, typename Map>
+bool get_params(SnapshotCursor &cursor, std::size_t n, Map &params, const std::vector<std::shared_ptr<Atom>> &atoms) {
+    for (std::size_t k = 0; k < n; ++k) {
+        Record record;
+        if (!cursor.get(&record))
+            return false;
+        typename Map::key_type key;
+        for (std::size_t i = 0; i < key.size(); ++i) {
+            if (record.atoms[i] >= atoms.size())
+                return false;
+            key[i] = atoms[record.atoms[i]];
+        }
+        params.emplace(std::move(key), record.param);
+    }
+    return true;
+}
+
+} // namespace
+
+bool TopologySnapshot::is_valid(const std::string &snapshot, const std::string &topology) {
+    std::ifstream ifs(snapshot, std::ios::binary);
+    if (!ifs)
+        return false;
+    Header header;
+    if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header)) or
+        std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0)
+        return false;
+
+    std::uint64_t size;
+    std::int64_t mtime;
+    return TrajectoryCache::source_stamp(topology, size, mtime) and header.source_size == size and
+           header.source_mtime == mtime;
+}
+
+bool TopologySnapshot::save(const std::shared_ptr<Frame> &frame, const std::string &snapshot,
+                            const std::string &topology) {
+    Header header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    if (!TrajectoryCache::source_stamp(topology, header.source_size, header.source_mtime))
+        return false;
+
+    std::unordered_map<const Atom *, std::uint32_t> index;
+    index.reserve(frame->atom_list.size());
+    for (std::size_t i = 0; i < frame->atom_list.size(); ++i) {
+        index.emplace(frame->atom_list[i].get(), i);
+        header.ncon += frame->atom_list[i]->con_list.size();
+    }
+    for (const auto &mol : frame->molecule_list) {
+        header.nmolecule_atoms += mol->atom_list.size();
+    }
+    header.natoms = frame->atom_list.size();
+    header.nmolecules = frame->molecule_list.size();
+    header.nbonds = frame->f_bond_params.size();
+    header.nangles = frame->f_angle_params.size();
+    header.ndihedrals = frame->f_dihedral_params.size();
+    header.nimpropers = frame->f_improper_dihedral_params.size();
+
+    // topology readers without box information leave the box untouched
+    header.box = frame->box.getBoxParameter();
+    header.has_box = std::all_of(header.box.begin(), header.box.end(), [](double v) { return std::isfinite(v); }) and
+                     header.box[0] > 0 and header.box[1] > 0 and header.box[2] > 0;
+
+    // write to a temporary file first, so concurrent runs never see a partial snapshot
+    auto tmp_file = snapshot + ".tmp" + std::to_string(::getpid());
+    try {
+        std::ofstream ofs(tmp_file, std::ios::binary);
+        if (!ofs)
+            return false;
+        SnapshotWriter writer(ofs);
+        writer.put(header);
+        for (const auto &atom : frame->atom_list) {
+            AtomRecord record{};
+            record.seq = atom->seq;
+            record.typ = atom->typ;
+            record.ncon = atom->con_list.size();
+            record.x = atom->x;
+            record.y = atom->y;
+            record.z = atom->z;
+            if (atom->getAtNo()) {
+                record.flags |= AT_NO;
+                record.at_no = atom->getAtNo().get();
+            }
+            if (atom->charge) {
+                record.flags |= CHARGE;
+                record.charge = atom->charge.get();
+            }
+            if (atom->mass) {
+                record.flags |= MASS;
+                record.mass = atom->mass.get();
+            }
+            if (atom->lj_param) {
+                record.flags |= LJ_PARAM;
+                record.c6 = atom->lj_param->c6;
+                record.c12 = atom->lj_param->c12;
+            }
+            if (atom->residue_name) {
+                record.flags |= RESIDUE_NAME;
+            }
+            if (atom->residue_num) {
+                record.flags |= RESIDUE_NUM;
+                record.residue_num = atom->residue_num.get();
+            }
+            if (atom->real_residue_number) {
+                record.flags |= REAL_RESIDUE_NUMBER;
+                record.real_residue_number = atom->real_residue_number.get();
+            }
+            if (atom->atom_symbol) {
+                record.flags |= ATOM_SYMBOL;
+            }
+            writer.put(record);
+        }
+        for (const auto &atom : frame->atom_list) {
+            for (auto seq : atom->con_list) {
+                writer.put(static_cast<std::uint64_t>(seq));
+            }
+        }
+        for (const auto &mol : frame->molecule_list) {
+            writer.put(MoleculeRecord{mol->sequence, static_cast<std::uint32_t>(mol->atom_list.size())});
+        }
+        for (const auto &mol : frame->molecule_list) {
+            for (const auto &atom : mol->atom_list) {
+                writer.put(index.at(atom.get()));
+            }
+        }
+        put_params<BondRecord>(writer, frame->f_bond_params, index);
+        put_params<AngleRecord>(writer, frame->f_angle_params, index);
+        put_params<DihedralRecord>(writer, frame->f_dihedral_params, index);
+        put_params<DihedralRecord>(writer, frame->f_improper_dihedral_params, index);
+
+        writer.put(frame->title);
+        for (const auto &atom : frame->atom_list) {
+            writer.put(atom->atom_name);
+            writer.put(atom->type_name);
+            if (atom->residue_name)
+                writer.put(atom->residue_name.get());
+            if (atom->atom_symbol)
+                writer.put(atom->atom_symbol.get());
+        }
+        if (!ofs) {
+            ofs.close();
+            std::filesystem::remove(tmp_file);
+            return false;
+        }
+    } catch (std::out_of_range &) {
+        // parameters refer to atoms not in atom_list
+        std::error_code ec;
+        std::filesystem::remove(tmp_file, ec);
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_file, snapshot, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_file, ec);
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<Frame> TopologySnapshot::load(const std::string &snapshot) {
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(snapshot);
+    } catch (std::exception &) {
+        return {};
+    }
+    SnapshotCursor cursor(file.data(), file.data() + file.size());
+
+    Header header;
+    if (!cursor.get(&header) or std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0)
+        return {};
+
+    std::vector<AtomRecord> records(header.natoms);
+    std::vector<std::uint64_t> con(header.ncon);
+    std::vector<MoleculeRecord> molecules(header.nmolecules);
+    std::vector<std::uint32_t> molecule_atoms(header.nmolecule_atoms);
+    if (!(cursor.get(records.data(), records.size()) and cursor.get(con.data(), con.size()) and
+          cursor.get(molecules.data(), molecules.size()) and
+          cursor.get(molecule_atoms.data(), molecule_atoms.size())))
+        return {};
+
+    auto frame = std::make_shared<Frame>();
+    if (header.has_box) {
+        const auto &box = header.box;
+        frame->box = PBCBox(box[0], box[1], box[2], box[3], box[4], box[5]);
+    }
+
+    auto &atoms = frame->atom_list;
+    atoms.reserve(records.size());
+    frame->atom_map.reserve(records.size());
+    auto con_it = con.begin();
+    for (const auto &record : records) {
+        if (static_cast<std::size_t>(con.end() - con_it) < record.ncon)
+            return {};
+        auto atom = std::make_shared<Atom>();
+        atom->seq = record.seq;
+        atom->typ = record.typ;
+        atom->x = record.x;
+        atom->y = record.y;
+        atom->z = record.z;
+        if (record.flags & AT_NO)
+            atom->setAtNo(record.at_no);
+        if (record.flags & CHARGE)
+            atom->charge = record.charge;
+        if (record.flags & MASS)
+            atom->mass = record.mass;
+        if (record.flags & LJ_PARAM)
+            atom->lj_param = lj_t{record.c6, record.c12};
+        if (record.flags & RESIDUE_NUM)
+            atom->residue_num = record.residue_num;
+        if (record.flags & REAL_RESIDUE_NUMBER)
+            atom->real_residue_number = record.real_residue_number;
+        atom->con_list.assign(con_it, con_it + record.ncon);
+        con_it += record.ncon;
+        frame->atom_map[atom->seq] = atom;
+        atoms.push_back(std::move(atom));
+    }
+
+    auto mol_atom_it = molecule_atoms.begin();
+    frame->molecule_list.reserve(molecules.size());
+    for (const auto &record : molecules) {
+        if (static_cast<std::size_t>(molecule_atoms.end() - mol_atom_it) < record.natoms)
+            return {};
+        auto mol = std::make_shared<Molecule>();
+        mol->sequence = record.sequence;
+        for (std::uint32_t i = 0; i < record.natoms; ++i, ++mol_atom_it) {
+            if (*mol_atom_it >= atoms.size())
+                return {};
+            const auto &atom = atoms[*mol_atom_it];
+            mol->atom_list.push_back(atom);
+            atom->molecule = mol;
+        }
+        frame->molecule_list.push_back(std::move(mol));
+    }
+
+    if (!(get_params<BondRecord>(cursor, header.nbonds, frame->f_bond_params, atoms) and
+          get_params<AngleRecord>(cursor, header.nangles, frame->f_angle_params, atoms) and
+          get_params<DihedralRecord>(cursor, header.ndihedrals, frame->f_dihedral_params, atoms) and
+          get_params<DihedralRecord>(cursor, header.nimpropers, frame->f_improper_dihedral_params, atoms)))
+        return {};
+
+    if (!cursor.get(frame->title))
+        return {};
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        auto &atom = atoms[i];
+        if (!(cursor.get(atom->atom_name) and cursor.get(atom->type_name)))
+            return {};
+        std::string value;
+        if (records[i].flags & RESIDUE_NAME) {
+            if (!cursor.get(value))
+                return {};
+            atom->residue_name = value;
+        }
+        if (records[i].flags & ATOM_SYMBOL) {
+            if (!cursor.get(value))
+                return {};
+            atom->atom_symbol = value;
+        }
+    }
+    if (!cursor.at_end())
+        return {};
+
+    frame->build_graph();
+    return frame;
+}
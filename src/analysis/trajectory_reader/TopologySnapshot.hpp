@@ -0,0 +1,28 @@
+#ifndef TINKER_TOPOLOGYSNAPSHOT_HPP
+#define TINKER_TOPOLOGYSNAPSHOT_HPP
+
+#include <memory>
+#include <string>
+
+class Frame;
+
+/*
+ *  Binary snapshot of a fully built topology (atoms, residues, molecules, connectivity, charges, masses,
+ *  LJ and bonded parameters) cached in a sidecar file <topology>.snapshot
+ *  Loading the snapshot from a memory-mapped file skips parsing and molecule assignment of the topology file,
+ *  the snapshot is rebuilt automatically when size or mtime of topology file changed
+ */
+class TopologySnapshot {
+public:
+    static std::string snapshot_filename(const std::string &topology) { return topology + ".snapshot"; }
+
+    // snapshot file is complete and made from current version of topology
+    [[nodiscard]] static bool is_valid(const std::string &snapshot, const std::string &topology);
+
+    static bool save(const std::shared_ptr<Frame> &frame, const std::string &snapshot, const std::string &topology);
+
+    // return nullptr if snapshot is broken
+    [[nodiscard]] static std::shared_ptr<Frame> load(const std::string &snapshot);
+};
+
+#endif // TINKER_TOPOLOGYSNAPSHOT_HPP
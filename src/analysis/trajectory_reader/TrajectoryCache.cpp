@@ -0,0 +1,109 @@
+#include "TrajectoryCache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+#include "utils/ThrowAssert.hpp"
+
+bool TrajectoryCache::source_stamp(const std::string &source, std::uint64_t &size, std::int64_t &mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(source, ec);
+    if (ec)
+        return false;
+    auto time = std::filesystem::last_write_time(source, ec);
+    if (ec)
+        return false;
+    mtime = time.time_since_epoch().count();
+    return true;
+}
+
+bool TrajectoryCache::is_valid(const std::string &cache, const std::string &source, std::size_t natoms) {
+    std::ifstream ifs(cache, std::ios::binary);
+    if (!ifs)
+        return false;
+    Header header;
+    if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header)) or
+        std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+        return false;
+
+    std::uint64_t size;
+    std::int64_t mtime;
+    if (!source_stamp(source, size, mtime) or header.source_size != size or header.source_mtime != mtime)
+        return false;
+
+    std::error_code ec;
+    auto cache_size = std::filesystem::file_size(cache, ec);
+    return !ec and header.natoms >= natoms and
+           header.table_offset + header.nframes * sizeof(FrameEntry) == cache_size;
+}
+
+void TrajectoryCacheWriter::open(const std::string &filename, std::size_t natoms, const std::string &source) {
+    throw_assert(!ofs.is_open(), "trajectory cache file not close");
+    this->filename = filename;
+    temp_filename = filename + ".tmp" + std::to_string(getpid());
+    ofs.open(temp_filename, std::ios::binary | std::ios::trunc);
+    throw_assert(ofs.is_open(), "trajectory cache file open error");
+
+    header = {};
+    std::memcpy(header.magic, TrajectoryCache::magic, sizeof(header.magic));
+    header.natoms = natoms;
+    if (!source.empty()) {
+        TrajectoryCache::source_stamp(source, header.source_size, header.source_mtime);
+    }
+    entries.clear();
+    block.resize(3 * natoms);
+    // patched when closed
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void TrajectoryCacheWriter::write(const FrameBuffer &buffer) {
+    throw_assert(ofs.is_open(), "trajectory cache file handle invalid");
+    throw_assert(buffer.natoms == header.natoms, "atom number of frame does not match trajectory cache");
+    const auto n = header.natoms;
+    for (std::size_t i = 0; i < n; ++i) {
+        block[i] = buffer.x[3 * i];
+        block[n + i] = buffer.x[3 * i + 1];
+        block[2 * n + i] = buffer.x[3 * i + 2];
+    }
+
+    TrajectoryCache::FrameEntry entry{};
+    entry.offset = ofs.tellp();
+    if (buffer.time) {
+        entry.time = buffer.time.value();
+        entry.has_time = 1;
+    }
+    if (buffer.box) {
+        entry.box = buffer.box->getBoxParameter();
+        entry.has_box = 1;
+    }
+    entries.push_back(entry);
+    ofs.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(float));
+}
+
+void TrajectoryCacheWriter::close() {
+    if (!ofs.is_open())
+        return;
+    static_assert(std::is_trivially_copyable_v<TrajectoryCache::FrameEntry>);
+    header.nframes = entries.size();
+    header.table_offset = ofs.tellp();
+    ofs.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(TrajectoryCache::FrameEntry));
+    ofs.seekp(0);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.close();
+    if (!ofs) {
+        std::filesystem::remove(temp_filename);
+        throw std::runtime_error("error write trajectory cache file " + filename);
+    }
+    std::filesystem::rename(temp_filename, filename);
+}
+
+void TrajectoryCacheWriter::discard() {
+    if (!ofs.is_open())
+        return;
+    ofs.close();
+    std::error_code ec;
+    std::filesystem::remove(temp_filename, ec);
+}
+
+TrajectoryCacheWriter::~TrajectoryCacheWriter() { discard(); }
@@ -0,0 +1,73 @@
+#ifndef TINKER_TRAJECTORYCACHE_HPP
+#define TINKER_TRAJECTORYCACHE_HPP
+
+#include <fstream>
+
+#include "FrameBuffer.hpp"
+#include "utils/std.hpp"
+
+/*
+ *  Trajectory cache format (*.cache), designed to be memory-mapped and read without decoding
+ *
+ *  Header | frame 0 | frame 1 | ... | FrameEntry table
+ *
+ *  every frame is a structure-of-arrays block of float32 coordinates in Angstrom,
+ *  x[natoms] y[natoms] z[natoms]. The table after the last frame holds offset, time and box of all frames.
+ *  All values are in native byte order
+ */
+struct TrajectoryCache {
+    struct Header {
+        char magic[8];
+        std::uint64_t natoms;
+        std::uint64_t nframes;
+        std::uint64_t table_offset;
+        std::uint64_t source_size; // size and mtime of the trajectory the cache made from, zero if none
+        std::int64_t source_mtime;
+    };
+
+    struct FrameEntry {
+        std::uint64_t offset;
+        double time;
+        std::array<double, 6> box; // a b c alpha beta gamma
+        std::uint32_t has_time;
+        std::uint32_t has_box;
+    };
+
+    static constexpr char magic[8] = {'C', 'A', 'C', 'T', 'R', 'J', '0', '1'};
+
+    static std::string cache_filename(const std::string &source) { return source + ".cache"; }
+
+    // cache file is complete, made from current version of source and holds at least natoms atoms
+    static bool is_valid(const std::string &cache, const std::string &source, std::size_t natoms);
+
+    static bool source_stamp(const std::string &source, std::uint64_t &size, std::int64_t &mtime);
+};
+
+class TrajectoryCacheWriter {
+public:
+    /*
+     *  the cache is written to a temporary file, which is renamed to filename when closed,
+     *  so an interrupted run never leaves a partial cache behind
+     */
+    void open(const std::string &filename, std::size_t natoms, const std::string &source = "");
+
+    [[nodiscard]] bool is_open() const { return ofs.is_open(); }
+
+    void write(const FrameBuffer &buffer);
+
+    void close();
+
+    // remove temporary file instead
+    void discard();
+
+    ~TrajectoryCacheWriter();
+
+private:
+    std::string filename, temp_filename;
+    std::ofstream ofs;
+    TrajectoryCache::Header header{};
+    std::vector<TrajectoryCache::FrameEntry> entries;
+    std::vector<float> block;
+};
+
+#endif // TINKER_TRAJECTORYCACHE_HPP
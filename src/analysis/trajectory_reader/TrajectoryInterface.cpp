@@ -4,7 +4,26 @@
 
 
 bool TrajectoryInterface::readOneFrame(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) {
-    frame->has_velocity = false;
-    auto ok = readOneFrameImpl(frame, atoms);
+    buffer.enable_bound = frame->enable_bound;
+    if (buffer.capacity != atoms.size()) {
+        buffer.reserve(atoms.size());
+    }
+    auto ok = readOneFrame(buffer);
+    if (ok) {
+        buffer.apply(frame, atoms);
+    }
     return ok;
 }
+
+bool TrajectoryInterface::readOneFrame(FrameBuffer &buffer) {
+    buffer.reset();
+    return readOneFrameImpl(buffer);
+}
+
+std::size_t TrajectoryInterface::skipFrames(std::size_t n, FrameBuffer &buffer) {
+    std::size_t skipped = 0;
+    while (skipped < n and readOneFrame(buffer)) {
+        ++skipped;
+    }
+    return skipped;
+}
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <fstream>
 
+#include "FrameBuffer.hpp"
 #include "TopologyInterface.hpp"
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
@@ -16,13 +17,45 @@ public:
 
     bool readOneFrame(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms);
 
+    /*
+     *  decode next frame into buffer only, the Atom objects of topology are not touched
+     *  buffer.capacity and buffer.enable_bound must be set by caller
+     */
+    bool readOneFrame(FrameBuffer &buffer);
+
+    /*
+     *  skip next n frames, return the number of frames actually skipped (less than n at the end of file)
+     *  buffer may be used as scratch space by readers that can not seek
+     */
+    virtual std::size_t skipFrames(std::size_t n, FrameBuffer &buffer);
+
+    /*
+     *  decompress up to frames frames at a time on the TBB pool, frames are still returned in order
+     *  readers that can not decode frames independently ignore it
+     */
+    virtual void setParallelDecode([[maybe_unused]] std::size_t frames) {}
+
+    /*
+     *  the caller reads every stride-th frame and skips the others, so a parallel batch decodes only those.
+     *  A hint, any other read pattern still works
+     */
+    virtual void setDecodeStride([[maybe_unused]] std::size_t stride) {}
+
+    /*
+     *  save a frame index built by the reader next to the trajectory (<file>.idx), so later runs skip the scan.
+     *  readers without frame index ignore it
+     */
+    virtual void setWriteIndex([[maybe_unused]] bool enable) {}
+
     virtual void close() = 0;
 
     virtual ~TrajectoryInterface() = default;
 
 protected:
-    virtual bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) = 0;
+    virtual bool readOneFrameImpl(FrameBuffer &buffer) = 0;
 
+private:
+    FrameBuffer buffer;
 };
 
 #endif  // TINKER_TRAJECTORYINTERFACE_HPP
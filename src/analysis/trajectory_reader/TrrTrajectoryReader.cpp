@@ -7,68 +7,105 @@
 
 namespace gmx {
 
+#include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/trnio.h"
 
 }
 
 bool TrrTrajectoryReader::open(const std::string &file) {
+    filename = file;
+    index.reset();
+    index_tried = false;
+    need_seek = false;
+    next_frame = 0;
     fio = gmx::open_trn(file.c_str(), "r");
     return fio != nullptr;
 }
 
-bool TrrTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
-                                           const std::vector<std::shared_ptr<Atom>> &atoms) {
+bool TrrTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    if (!seekToNextFrame())
+        return false;
     gmx::t_trnheader trnheader;
     gmx::gmx_bool bOK;
     gmx::rvec box[3];
     std::unique_ptr<gmx::rvec[]> coord;
     std::unique_ptr<gmx::rvec[]> velocities;
     if (gmx::fread_trnheader(fio, &trnheader, &bOK)) {
-        frame->setCurrentTime(trnheader.t);
+        buffer.time = trnheader.t;
         if (bOK) {
             coord = std::make_unique<gmx::rvec[]>(trnheader.natoms);
             if (trnheader.v_size) {
                 velocities = std::make_unique<gmx::rvec[]>(trnheader.natoms);
-                frame->has_velocity = true;
+                buffer.has_velocity = true;
             } else if (enable_read_velocity) {
                 std::cerr << "ERROR!! Gromacs TRR Trajectory file does not have velocities !\n";
                 exit(4);
             }
             if (trnheader.box_size) {
                 gmx::fread_htrn(fio, &trnheader, box, coord.get(), velocities.get(), nullptr);
-                frame->box = PBCBox(box);
+                buffer.box = PBCBox(box);
             } else {
-                if (frame->enable_bound) {
+                if (buffer.enable_bound) {
                     std::cerr << "ERROR !! trr trajectory does not  have PBC enabled" << std::endl;
                     exit(1);
                 }
-                frame->enable_bound = false;
                 gmx::fread_htrn(fio, &trnheader, nullptr, coord.get(), velocities.get(), nullptr);
             }
             static bool has_Warning_d = false;
-            if (!has_Warning_d and trnheader.natoms != static_cast<int>(atoms.size())) {
+            if (!has_Warning_d and trnheader.natoms != static_cast<int>(buffer.capacity)) {
                 std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") %
-                                 atoms.size() % trnheader.natoms;
+                                 buffer.capacity % trnheader.natoms;
                 has_Warning_d = true;
             }
-            for (auto i : boost::irange(trnheader.natoms)) {
-                auto &atom = atoms[i];
-                atom->x = coord[i][0] * 10;
-                atom->y = coord[i][1] * 10;
-                atom->z = coord[i][2] * 10;
-                if (velocities) {
-                    atom->vx = velocities[i][0] * 10;
-                    atom->vy = velocities[i][1] * 10;
-                    atom->vz = velocities[i][2] * 10;
-                }
+            buffer.natoms = std::min<std::size_t>(trnheader.natoms, buffer.capacity);
+            buffer.for_each_atom([&](std::size_t i) {
+                buffer.x[3 * i] = coord[i][0] * 10;
+                buffer.x[3 * i + 1] = coord[i][1] * 10;
+                buffer.x[3 * i + 2] = coord[i][2] * 10;
+            });
+            if (velocities) {
+                buffer.v.resize(buffer.x.size());
+                buffer.for_each_atom([&](std::size_t i) {
+                    buffer.v[3 * i] = velocities[i][0] * 10;
+                    buffer.v[3 * i + 1] = velocities[i][1] * 10;
+                    buffer.v[3 * i + 2] = velocities[i][2] * 10;
+                });
             }
-
+            ++next_frame;
             return true;
         }
     }
     return false;
 }
 
+void TrrTrajectoryReader::setWriteIndex(bool enable) { write_index = enable; }
+
+std::size_t TrrTrajectoryReader::skipFrames(std::size_t n, FrameBuffer &buffer) {
+    if (!index_tried) {
+        index = FrameIndex::load_or_build(filename, FileType::TRR, write_index);
+        index_tried = true;
+    }
+    if (!index)
+        return TrajectoryInterface::skipFrames(n, buffer);
+
+    auto skipped = std::min(n, index->size() - std::min(next_frame, index->size()));
+    if (skipped) {
+        next_frame += skipped;
+        need_seek = true;
+    }
+    return skipped;
+}
+
+bool TrrTrajectoryReader::seekToNextFrame() {
+    if (need_seek) {
+        if (next_frame >= index->size())
+            return false;
+        gmx::gmx_fio_seek(fio, (*index)[next_frame].offset);
+        need_seek = false;
+    }
+    return true;
+}
+
 void TrrTrajectoryReader::close() {
     if (fio) {
         gmx::close_trn(fio);
@@ -1,6 +1,7 @@
 #ifndef TINKER_TRRTRAJECTORYREADER_HPP
 #define TINKER_TRRTRAJECTORYREADER_HPP
 
+#include "FrameIndex.hpp"
 #include "TrajectoryInterface.hpp"
 
 namespace gmx {
@@ -16,13 +17,26 @@ public:
 
     void close() override;
 
+    std::size_t skipFrames(std::size_t n, FrameBuffer &buffer) override;
+
+    void setWriteIndex(bool enable) override;
+
     ~TrrTrajectoryReader() override;
 
 protected:
-    bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
 
 private:
+    bool seekToNextFrame();
+
     gmx::t_fileio *fio = nullptr;
+
+    std::string filename;
+    boost::optional<FrameIndex> index; // built on first skip
+    bool index_tried = false;
+    bool write_index = false;
+    bool need_seek = false;
+    std::size_t next_frame = 0;
 };
 
 #endif  // TINKER_TRRTRAJECTORYREADER_HPP
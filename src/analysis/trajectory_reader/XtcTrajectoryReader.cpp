@@ -1,17 +1,41 @@
-
 #include "XtcTrajectoryReader.hpp"
 
+#include <atomic>
+#include <tbb/parallel_for.h>
+
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "utils/common.hpp"
 
+namespace gmx {
+
+#include "gromacs/fileio/gmxfio.h"
+
+}
+
 bool XtcTrajectoryReader::open(const std::string &file) {
+    filename = file;
+    index.reset();
+    index_tried = false;
+    need_seek = false;
+    next_frame = 0;
+    batch_first = batch_size = 0;
     fio = gmx::open_xtc(file.c_str(), "r");
     return fio != nullptr;
 }
 
-bool XtcTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
-                                           const std::vector<std::shared_ptr<Atom>> &atoms) {
+void XtcTrajectoryReader::setParallelDecode(std::size_t frames) { decode_batch = frames; }
+
+void XtcTrajectoryReader::setDecodeStride(std::size_t stride) { decode_stride = std::max<std::size_t>(stride, 1); }
+
+void XtcTrajectoryReader::setWriteIndex(bool enable) { write_index = enable; }
+
+bool XtcTrajectoryReader::readOneFrameImpl(FrameBuffer &buffer) {
+    if (decode_batch > 1 and ensureIndex())
+        return readOneFrameParallel(buffer);
+
+    if (!seekToNextFrame())
+        return false;
     gmx::matrix box;
     gmx::gmx_bool bOK;
 
@@ -25,28 +49,131 @@ bool XtcTrajectoryReader::readOneFrameImpl(std::shared_ptr<Frame> &frame,
         return false;
 
     if (bOK) {
-        static bool has_Warning_d = false;
-        if (!has_Warning_d and natoms != static_cast<int>(atoms.size())) {
-            std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") % atoms.size() %
-                             natoms;
-            has_Warning_d = true;
-        }
-        if (frame->enable_bound) {
-            frame->box = PBCBox(box);
-        }
-        for (auto i : boost::irange(natoms)) {
-            auto &atom = atoms[i];
-            atom->x = x[i][0] * 10;
-            atom->y = x[i][1] * 10;
-            atom->z = x[i][2] * 10;
-        }
+        fillBuffer(buffer, natoms, box, x);
+        ++next_frame;
         return true;
     }
     std::cerr << "\nWARNING: Incomplete frame at time " << std::scientific << time << std::defaultfloat << "\n";
     return false;
 }
 
+void XtcTrajectoryReader::fillBuffer(FrameBuffer &buffer, int natoms, gmx::matrix box, const gmx::rvec *x) {
+    static std::atomic_bool has_Warning_d = false;
+    if (natoms != static_cast<int>(buffer.capacity) and !has_Warning_d.exchange(true)) {
+        std::cerr << boost::format("WARNING: topology has %d atoms, whereas trajectory has %d\n") % buffer.capacity %
+                         natoms;
+    }
+    if (buffer.enable_bound) {
+        buffer.box = PBCBox(box);
+    }
+    buffer.natoms = std::min<std::size_t>(natoms, buffer.capacity);
+    buffer.for_each_atom([&](std::size_t i) {
+        buffer.x[3 * i] = x[i][0] * 10;
+        buffer.x[3 * i + 1] = x[i][1] * 10;
+        buffer.x[3 * i + 2] = x[i][2] * 10;
+    });
+}
+
+bool XtcTrajectoryReader::readOneFrameParallel(FrameBuffer &buffer) {
+    const bool in_batch = next_frame >= batch_first and (next_frame - batch_first) % batch_stride == 0 and
+                          (next_frame - batch_first) / batch_stride < batch_size;
+    if (!in_batch) {
+        if (next_frame >= index->size())
+            return false;
+        decodeBatch(next_frame, buffer);
+    }
+    auto &slot = decode_slots[(next_frame - batch_first) / batch_stride];
+    if (!slot.ok) {
+        std::cerr << "\nWARNING: Incomplete frame at time " << std::scientific << (*index)[next_frame].time
+                  << std::defaultfloat << "\n";
+        return false;
+    }
+    // hand over the decoded coordinates without copying, the slot takes the old storage of buffer
+    std::swap(buffer.x, slot.buffer.x);
+    buffer.natoms = slot.buffer.natoms;
+    buffer.box = slot.buffer.box;
+    ++next_frame;
+    return true;
+}
+
+void XtcTrajectoryReader::decodeBatch(std::size_t first, const FrameBuffer &buffer) {
+    if (decode_slots.size() != decode_batch) {
+        for (auto &slot : decode_slots) {
+            if (slot.fio)
+                gmx::close_xtc(slot.fio);
+        }
+        decode_slots = std::vector<DecodeSlot>(decode_batch);
+    }
+    const auto atom_num = index->natoms();
+    batch_first = first;
+    batch_stride = decode_stride;
+    batch_size = std::min(decode_batch, (index->size() - first + batch_stride - 1) / batch_stride);
+    tbb::parallel_for(std::size_t(0), batch_size, [&](std::size_t i) {
+        auto &slot = decode_slots[i];
+        if (!slot.fio) {
+            slot.fio = gmx::open_xtc(filename.c_str(), "r");
+            slot.x = std::make_unique<gmx::rvec[]>(atom_num);
+        }
+        slot.buffer.enable_bound = buffer.enable_bound;
+        if (slot.buffer.subset != buffer.subset) {
+            slot.buffer.subset = buffer.subset;
+        }
+        if (slot.buffer.capacity != buffer.capacity or slot.buffer.x.size() != buffer.x.size()) {
+            slot.buffer.reserve(buffer.capacity);
+        }
+        slot.buffer.reset();
+
+        int slot_step;
+        gmx::real slot_time, slot_prec;
+        gmx::matrix box;
+        gmx::gmx_bool bOK;
+        gmx::gmx_fio_seek(slot.fio, (*index)[first + i * batch_stride].offset);
+        slot.ok = gmx::read_next_xtc(slot.fio, atom_num, &slot_step, &slot_time, box, slot.x.get(), &slot_prec,
+                                     &bOK) and
+                  bOK;
+        if (slot.ok) {
+            fillBuffer(slot.buffer, atom_num, box, slot.x.get());
+        }
+    });
+}
+
+std::size_t XtcTrajectoryReader::skipFrames(std::size_t n, FrameBuffer &buffer) {
+    if (!ensureIndex())
+        return TrajectoryInterface::skipFrames(n, buffer);
+
+    auto skipped = std::min(n, index->size() - std::min(next_frame, index->size()));
+    if (skipped) {
+        next_frame += skipped;
+        need_seek = true;
+    }
+    return skipped;
+}
+
+bool XtcTrajectoryReader::ensureIndex() {
+    if (!index_tried) {
+        index = FrameIndex::load_or_build(filename, FileType::XTC, write_index);
+        index_tried = true;
+    }
+    return index.has_value();
+}
+
+bool XtcTrajectoryReader::seekToNextFrame() {
+    if (need_seek) {
+        if (next_frame >= index->size())
+            return false;
+        gmx::gmx_fio_seek(fio, (*index)[next_frame].offset);
+        need_seek = false;
+    }
+    return true;
+}
+
 void XtcTrajectoryReader::close() {
+    for (auto &slot : decode_slots) {
+        if (slot.fio)
+            gmx::close_xtc(slot.fio);
+    }
+    decode_slots.clear();
+    batch_first = batch_size = 0;
     if (x) {
         gmx::sfree(x);
         x = nullptr;
@@ -1,6 +1,7 @@
 #ifndef TINKER_XTCTRAJECTORYREADER_HPP
 #define TINKER_XTCTRAJECTORYREADER_HPP
 
+#include "FrameIndex.hpp"
 #include "TrajectoryInterface.hpp"
 
 namespace gmx {
@@ -16,14 +17,53 @@ public:
 
     void close() override;
 
+    std::size_t skipFrames(std::size_t n, FrameBuffer &buffer) override;
+
+    void setParallelDecode(std::size_t frames) override;
+
+    void setDecodeStride(std::size_t stride) override;
+
+    void setWriteIndex(bool enable) override;
+
     ~XtcTrajectoryReader() override;
 
 protected:
-    bool readOneFrameImpl(std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+    bool readOneFrameImpl(FrameBuffer &buffer) override;
 
 private:
+    // one independent file handle per frame of a batch, so frames can be decompressed concurrently
+    struct DecodeSlot {
+        gmx::t_fileio *fio = nullptr;
+        std::unique_ptr<gmx::rvec[]> x;
+        FrameBuffer buffer;
+        bool ok = false;
+    };
+
+    bool ensureIndex();
+
+    bool seekToNextFrame();
+
+    bool readOneFrameParallel(FrameBuffer &buffer);
+
+    void decodeBatch(std::size_t first, const FrameBuffer &buffer);
+
+    static void fillBuffer(FrameBuffer &buffer, int natoms, gmx::matrix box, const gmx::rvec *x);
+
     gmx::t_fileio *fio = nullptr;
 
+    std::string filename;
+    boost::optional<FrameIndex> index; // built on first skip or parallel read
+    bool index_tried = false;
+    bool write_index = false;
+    bool need_seek = false;
+    std::size_t next_frame = 0;
+
+    std::size_t decode_batch = 0; // frames decompressed at a time on the TBB pool, 0 or 1 for serial
+    std::size_t decode_stride = 1;
+    std::vector<DecodeSlot> decode_slots;
+    // the batch holds frames batch_first + i * batch_stride, i < batch_size
+    std::size_t batch_first = 0, batch_size = 0, batch_stride = 1;
+
     int natoms, step;
     gmx::rvec *x = nullptr;
     gmx::real prec, time;
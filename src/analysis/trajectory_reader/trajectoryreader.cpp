@@ -8,8 +8,12 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <tbb/tbb_exception.h>
 
+#include "CacheTrajectoryReader.hpp"
+#include "CachingTrajectoryReader.hpp"
 #include "ReaderFactory.hpp"
+#include "TopologySnapshot.hpp"
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
@@ -54,6 +58,14 @@ bool TrajectoryReader::TrajectoryFile::is_end(uint pos) const {
     }
 }
 
+boost::optional<uint> TrajectoryReader::TrajectoryFile::next_in_range(uint pos) const {
+    for (auto next = pos + 1; !is_end(next); ++next) {
+        if (is_in_range(next))
+            return next;
+    }
+    return {};
+}
+
 TrajectoryReader::TrajectoryFile::Ranges
 TrajectoryReader::TrajectoryFile::parse_range(const std::string &range_string) {
     using namespace boost::spirit;
@@ -104,32 +116,119 @@ void TrajectoryReader::set_mask(std::string mask_string) {
         mask = AmberMaskAST::parse_atoms(mask_string, true);
     }
 }
+void TrajectoryReader::set_required_atoms(std::vector<AmberMask> masks) { required_masks = std::move(masks); }
+
+TrajectoryReader::~TrajectoryReader() { stopPrefetch(); }
+
+void TrajectoryReader::set_prefetch(std::size_t depth) { prefetch_depth = depth; }
+
+void TrajectoryReader::set_parallel_decode(std::size_t frames) { parallel_decode = frames; }
+
+void TrajectoryReader::set_cache(bool enable) { enable_cache = enable; }
+
+void TrajectoryReader::set_frame_selection(uint start, uint end, uint step) {
+    selection_start = start;
+    selection_end = end;
+    selection_step = step;
+    next_frame_number = start;
+}
+
 std::shared_ptr<Frame> TrajectoryReader::readOneFrame() {
     if (!frame) {
         readTopology();
-        atoms_for_readtraj = isBlank(mask) ? frame->atom_list : PBCUtils::find_atoms(mask, frame);
     }
+    if (!atoms_for_readtraj) {
+        selectAtoms();
+    }
+    if (prefetch_depth == 0) {
+        if (!readNextFrame(sync_slot))
+            return {};
+        sync_slot.buffer.apply(frame, *sync_slot.atoms);
+        current_frame_number = sync_slot.frame_number;
+        return frame;
+    }
+
+    if (prefetch_finished)
+        return {};
+    if (!prefetch_thread.joinable())
+        startPrefetch();
+
+    FrameSlot *slot;
+    ready_slots.pop(slot);
+    if (!slot) {
+        stopPrefetch();
+        prefetch_finished = true;
+        if (prefetch_exception)
+            std::rethrow_exception(prefetch_exception);
+        return {};
+    }
+    slot->buffer.apply(frame, *slot->atoms);
+    current_frame_number = slot->frame_number;
+    free_slots.push(slot);
+    return frame;
+}
+
+// evaluated on the first read, so properties assigned to the topology frame before (force field) are seen by masks
+void TrajectoryReader::selectAtoms() {
+    atoms_for_readtraj =
+        std::make_shared<const AtomList>(isBlank(mask) ? frame->atom_list : PBCUtils::find_atoms(mask, frame));
+    for (const auto &required_mask : required_masks) {
+        for (const auto &atom : PBCUtils::find_atoms(required_mask, frame)) {
+            if (auto mol = atom->molecule.lock()) {
+                required_atoms.insert(mol->atom_list.begin(), mol->atom_list.end());
+            } else {
+                required_atoms.insert(atom);
+            }
+        }
+    }
+    subset_for_readtraj = find_subset(*atoms_for_readtraj);
+    if (!subset_for_readtraj->empty()) {
+        std::cout << boost::format("Only %d of %d atoms are read from trajectory for selected tasks\n") %
+                         subset_for_readtraj->size() % atoms_for_readtraj->size();
+    }
+}
+
+bool TrajectoryReader::readNextFrame(FrameSlot &slot) {
+    if (selection_end != 0 and next_frame_number > selection_end)
+        return false;
     for (;;) {
         if (!traj_reader) {
             if (traj_filenames.empty())
-                return {};
+                return false;
             current_trajectory_file = std::move(traj_filenames.front());
             traj_filenames.pop();
             current_frame_pos = 0;
-            traj_reader = ReaderFactory::getTrajectory(current_trajectory_file);
-            traj_reader->open(current_trajectory_file);
-            if (isBlank(mask)) {
-                atoms_for_readtraj = isBlank(current_trajectory_file.mask)
-                                         ? frame->atom_list
-                                         : PBCUtils::find_atoms(current_trajectory_file.mask, frame);
+            if (isBlank(mask) and !isBlank(current_trajectory_file.mask)) {
+                atoms_for_current_file =
+                    std::make_shared<const AtomList>(PBCUtils::find_atoms(current_trajectory_file.mask, frame));
+                subset_for_current_file = find_subset(*atoms_for_current_file);
+            } else {
+                atoms_for_current_file = atoms_for_readtraj;
+                subset_for_current_file = subset_for_readtraj;
             }
+            openTrajectory(current_trajectory_file, atoms_for_current_file->size());
+            // frames of a range are picked by the range, not by the selection step
+            traj_reader->setDecodeStride(current_trajectory_file.range.empty() ? selection_step : 1);
         }
-        while (traj_reader->readOneFrame(frame, atoms_for_readtraj)) {
-            ++current_frame_pos;
-            if (current_trajectory_file.is_in_range(current_frame_pos)) {
-                return frame;
-            } else if (current_trajectory_file.is_end(current_frame_pos)) {
-                break;
+        slot.atoms = atoms_for_current_file;
+        if (slot.subset != subset_for_current_file) {
+            slot.subset = subset_for_current_file;
+            slot.buffer.subset = *slot.subset;
+        }
+        slot.buffer.enable_bound = frame->enable_bound;
+        if (slot.buffer.capacity != slot.atoms->size()) {
+            slot.buffer.reserve(slot.atoms->size());
+        }
+        if (skipToSelectedFrame(slot.buffer)) {
+            while (traj_reader->readOneFrame(slot.buffer)) {
+                ++current_frame_pos;
+                if (current_trajectory_file.is_in_range(current_frame_pos)) {
+                    slot.frame_number = ++passed_frames;
+                    next_frame_number += selection_step;
+                    return true;
+                } else if (current_trajectory_file.is_end(current_frame_pos)) {
+                    break;
+                }
             }
         }
         traj_reader->close();
@@ -137,6 +236,120 @@ std::shared_ptr<Frame> TrajectoryReader::readOneFrame() {
     }
 }
 
+// with cache enabled, read up-to-date <file>.cache instead of file, or write it while reading file
+void TrajectoryReader::openTrajectory(const std::string &filename, std::size_t natoms) {
+    traj_reader = ReaderFactory::getTrajectory(filename);
+    if (!traj_reader) {
+        throw std::runtime_error("unsupported trajectory file " + filename);
+    }
+    if (enable_cache and getFileType(filename) != FileType::CACHE and !enable_read_velocity) {
+        auto cache = TrajectoryCache::cache_filename(filename);
+        if (TrajectoryCache::is_valid(cache, filename, natoms)) {
+            auto cache_reader = std::make_shared<CacheTrajectoryReader>();
+            if (cache_reader->open(cache)) {
+                LOG("read trajectory cache ", cache, " for ", filename, '\n');
+                traj_reader = std::move(cache_reader);
+                return;
+            }
+            LOG("can not open trajectory cache ", cache, ", rebuild it from ", filename, '\n');
+        }
+        traj_reader = std::make_shared<CachingTrajectoryReader>(traj_reader, cache);
+    }
+    traj_reader->setParallelDecode(parallel_decode);
+    traj_reader->setWriteIndex(enable_cache);
+    traj_reader->open(filename);
+}
+
+// positions of required atoms in atoms, empty if all atoms are required
+std::shared_ptr<const std::vector<std::size_t>> TrajectoryReader::find_subset(const AtomList &atoms) const {
+    auto subset = std::make_shared<std::vector<std::size_t>>();
+    if (!required_atoms.empty()) {
+        for (std::size_t i = 0; i < atoms.size(); ++i) {
+            if (required_atoms.contains(atoms[i])) {
+                subset->push_back(i);
+            }
+        }
+        if (subset->size() == atoms.size()) {
+            subset->clear();
+        }
+    }
+    return subset;
+}
+
+// position current trajectory file so that the next decoded frame is the next selected one
+bool TrajectoryReader::skipToSelectedFrame(FrameBuffer &buffer) {
+    for (;;) {
+        uint n;                 // frames to skip in file
+        uint selected_skip = 0; // frames within range among them
+        if (current_trajectory_file.range.empty()) {
+            n = selected_skip = next_frame_number - passed_frames - 1;
+        } else {
+            auto target = current_trajectory_file.next_in_range(current_frame_pos);
+            if (!target)
+                return false;
+            n = target.get() - current_frame_pos - 1;
+            if (passed_frames + 1 < next_frame_number) {
+                ++n;
+                selected_skip = 1;
+            }
+        }
+        if (n == 0)
+            return true;
+
+        auto skipped = traj_reader->skipFrames(n, buffer);
+        current_frame_pos += skipped;
+        if (skipped < n) {
+            if (current_trajectory_file.range.empty())
+                passed_frames += skipped;
+            return false;
+        }
+        passed_frames += selected_skip;
+        if (current_trajectory_file.range.empty())
+            return true;
+    }
+}
+
+void TrajectoryReader::startPrefetch() {
+    prefetch_slots.clear();
+    free_slots.clear();
+    ready_slots.clear();
+    for (std::size_t i = 0; i < prefetch_depth; ++i) {
+        free_slots.push(prefetch_slots.emplace_back(std::make_unique<FrameSlot>()).get());
+    }
+    stop_prefetch.store(false, std::memory_order_release);
+    prefetch_thread = std::thread(&TrajectoryReader::prefetchLoop, this);
+}
+
+void TrajectoryReader::stopPrefetch() {
+    if (prefetch_thread.joinable()) {
+        // the flag stops a thread busy reading before its next pop, nullptr wakes one blocked in pop
+        stop_prefetch.store(true, std::memory_order_release);
+        free_slots.push(nullptr);
+        prefetch_thread.join();
+    }
+}
+
+void TrajectoryReader::prefetchLoop() {
+    try {
+        for (;;) {
+            if (stop_prefetch.load(std::memory_order_acquire))
+                return;
+            FrameSlot *slot;
+            free_slots.pop(slot);
+            if (!slot)
+                return;
+            if (!readNextFrame(*slot)) {
+                ready_slots.push(nullptr);
+                return;
+            }
+            ready_slots.push(slot);
+        }
+    } catch (...) {
+        prefetch_exception = std::current_exception();
+        ready_slots.push(nullptr);
+    }
+}
+
 std::shared_ptr<Frame> TrajectoryReader::readTopology() {
     std::string file;
     if (topology_filename)
@@ -150,7 +363,25 @@ std::shared_ptr<Frame> TrajectoryReader::readTopology() {
         }
     }
 
+    // a snapshot is kept with the cache option only.
+    // an ARC topology is the first frame of trajectory, nothing to save by a snapshot
+    const bool use_snapshot = enable_cache and getFileType(file) != FileType::ARC;
+    const auto snapshot = TopologySnapshot::snapshot_filename(file);
+    if (use_snapshot and TopologySnapshot::is_valid(snapshot, file)) {
+        frame = TopologySnapshot::load(snapshot);
+        if (frame) {
+            LOG("load topology snapshot from ", snapshot, '\n');
+            frame->enable_bound = true;
+            frame->index_atoms();
+            return frame;
+        }
+    }
+
     auto reader = ReaderFactory::getTopology(file);
+    if (!reader) {
+        std::cerr << "Unsupported topology file: " << file << '\n';
+        std::exit(EXIT_FAILURE);
+    }
     frame = reader->read(file);
     frame->enable_bound = true; // TODO: detect PBC condtion
     for (const auto &element : frame->molecule_list | boost::adaptors::indexed(1)) {
@@ -173,5 +404,9 @@ std::shared_ptr<Frame> TrajectoryReader::readTopology() {
             atom->real_residue_number = current_real_residue_number;
         }
     }
+    if (use_snapshot and !TopologySnapshot::save(frame, snapshot, file)) {
+        LOG("can not write topology snapshot file ", snapshot, '\n');
+    }
+    frame->index_atoms();
     return frame;
 }
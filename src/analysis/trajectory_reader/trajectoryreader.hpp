@@ -5,7 +5,12 @@
 #ifndef TINKER_TRAJECTORYREADER_HPP
 #define TINKER_TRAJECTORYREADER_HPP
 
+#include <tbb/concurrent_queue.h>
+
+#include <atomic>
+
 #include "data_structure/atom.hpp"
+#include "trajectory_reader/FrameBuffer.hpp"
 #include "trajectory_reader/TopologyInterface.hpp"
 #include "trajectory_reader/TrajectoryInterface.hpp"
 #include <boost/fusion/sequence.hpp>
@@ -13,16 +18,56 @@
 
 class TrajectoryReader {
 public:
+    ~TrajectoryReader();
+
     void add_trajectoy_file(const std::string &filename);
 
     void set_topology(const std::string &filename);
 
     std::shared_ptr<Frame> readOneFrame();
 
+    /*
+     *  the frame readOneFrame fills. Atom properties set on it before the first readOneFrame (force field types,
+     *  residue names, elements) are seen by the mask and the required atoms
+     */
     std::shared_ptr<Frame> readTopology();
 
     void set_mask(std::string mask_string);
 
+    /*
+     *  only atoms matched by one of masks, together with the other atoms of their molecules, are read from
+     *  trajectory files, coordinates of the other atoms are left untouched
+     */
+    void set_required_atoms(std::vector<AmberMask> masks);
+
+    /*
+     *  decode up to depth frames ahead on a dedicated reader thread,
+     *  while the caller processes the current frame. depth = 0 disable prefetch
+     */
+    void set_prefetch(std::size_t depth);
+
+    /*
+     *  decompress up to frames frames at a time on the TBB pool for formats with independent frames (XTC),
+     *  frames = 0 disable parallel decoding
+     */
+    void set_parallel_decode(std::size_t frames);
+
+    /*
+     *  the first full pass over foo.xtc writes foo.xtc.cache, later passes read the cache without decoding.
+     *  the cache is rebuilt when foo.xtc changed. Only when it is enabled, the frame index foo.xtc.idx is saved
+     *  and the topology snapshot is saved and used
+     */
+    void set_cache(bool enable);
+
+    /*
+     *  only frames start, start + step, start + 2 * step ... up to end (0 for all) are returned,
+     *  frames are numbered from 1 over all trajectory files after their own ranges are applied.
+     *  the other frames are skipped without decoding when the reader can seek
+     */
+    void set_frame_selection(uint start, uint end, uint step);
+
+    [[nodiscard]] uint frame_number() const { return current_frame_number; }
+
 private:
     class TrajectoryFile {
     public:
@@ -52,14 +97,66 @@ private:
 
         bool is_end(uint pos) const;
 
+        boost::optional<uint> next_in_range(uint pos) const;
+
         static Ranges parse_range(const std::string &range_string);
     };
 
+    using AtomList = std::vector<std::shared_ptr<Atom>>;
+
+    struct FrameSlot {
+        FrameBuffer buffer;
+        std::shared_ptr<const AtomList> atoms; // atoms of the trajectory file this frame comes from
+        std::shared_ptr<const std::vector<std::size_t>> subset;
+        uint frame_number = 0;
+    };
+
+    void selectAtoms();
+
+    bool readNextFrame(FrameSlot &slot);
+
+    void openTrajectory(const std::string &filename, std::size_t natoms);
+
+    std::shared_ptr<const std::vector<std::size_t>> find_subset(const AtomList &atoms) const;
+
+    bool skipToSelectedFrame(FrameBuffer &buffer);
+
+    void startPrefetch();
+
+    void stopPrefetch();
+
+    void prefetchLoop();
+
     TrajectoryFile current_trajectory_file;
     uint current_frame_pos;
 
+    uint selection_start = 1, selection_end = 0, selection_step = 1;
+    uint next_frame_number = 1; // number of the next selected frame
+    uint passed_frames = 0;     // frames skipped or read so far, counted over all trajectory files
+    uint current_frame_number = 0;
+
     AmberMask mask;
-    std::vector<std::shared_ptr<Atom>> atoms_for_readtraj;
+    std::shared_ptr<const AtomList> atoms_for_readtraj;
+    std::shared_ptr<const AtomList> atoms_for_current_file;
+
+    std::vector<AmberMask> required_masks;
+    std::unordered_set<std::shared_ptr<Atom>> required_atoms; // empty for all atoms
+    std::shared_ptr<const std::vector<std::size_t>> subset_for_readtraj;
+    std::shared_ptr<const std::vector<std::size_t>> subset_for_current_file;
+
+    FrameSlot sync_slot;
+
+    std::size_t parallel_decode = 0;
+    bool enable_cache = false;
+
+    std::size_t prefetch_depth = 0;
+    bool prefetch_finished = false;
+    std::vector<std::unique_ptr<FrameSlot>> prefetch_slots;
+    tbb::concurrent_bounded_queue<FrameSlot *> free_slots;
+    tbb::concurrent_bounded_queue<FrameSlot *> ready_slots; // nullptr marks the end of trajectories
+    std::exception_ptr prefetch_exception;
+    std::atomic<bool> stop_prefetch = false; // consumer stop reading before the end of trajectories
+    std::thread prefetch_thread;
 
     boost::optional<std::string> topology_filename;
     std::queue<TrajectoryFile> traj_filenames; // the continuous trajectory files
@@ -1035,6 +1035,71 @@ int netcdfGetNextFrame(struct AmberNetcdf *A, double *X, double *box) {
     return 1;
 }
 
+// netcdfGetFrameBlock()
+/** Get nframe frames of amber netcdf trajectory with one hyperslab request,
+ * starting at frame set with a stride of fstride frames. Only natom atoms
+ * starting at atom astart with a stride of astride atoms are read.
+ * Coords are single precision, frame after frame, each of format
+ * X1,Y1,Z1,X2,Y2,Z2,... for the selected atoms (nframe * natom * 3 floats).
+ * Box is read if present and box is not NULL: cell lengths of all frames
+ * followed by cell angles of all frames (nframe * 6 doubles).
+ * currentFrame is not changed.
+ * \return 0 on success, 1 on error.
+ */
+int netcdfGetFrameBlock(struct AmberNetcdf *A, int set, int nframe, int fstride, int astart, int natom, int astride,
+                        float *X, double *box) {
+    size_t start[3], count[3];
+    ptrdiff_t stride[3];
+
+    if (A == NULL) {
+        fprintf(stderr, "Error: netcdfGetFrameBlock: AmberNetcdf structure not allocated.\n");
+        return 1;
+    }
+    if (A->ncid == -1) {
+        fprintf(stderr, "Error: netcdfGetFrameBlock: AmberNetcdf file not open.\n");
+        return 1;
+    }
+    if (A->isNCrestart) {
+        fprintf(stderr, "Error: netcdfGetFrameBlock: not supported for netcdf restart; use netcdfGetFrame instead.\n");
+        return 1;
+    }
+    if (X == NULL) {
+        fprintf(stderr, "Error: netcdfGetFrameBlock: Memory for coords not allocated.\n");
+        return 1;
+    }
+    // Bounds check
+    if (nframe <= 0 || fstride <= 0 || set < 0 || set + (nframe - 1) * fstride >= A->ncframe) return 1;
+    if (natom <= 0 || astride <= 0 || astart < 0 || astart + (natom - 1) * astride >= A->ncatom) return 1;
+
+    // Read Coords
+    start[0] = set;
+    start[1] = astart;
+    start[2] = 0;
+    count[0] = nframe;
+    count[1] = natom;
+    count[2] = 3;
+    stride[0] = fstride;
+    stride[1] = astride;
+    stride[2] = 1;
+    if (checkNCerr(nc_get_vars_float(A->ncid, A->coordVID, start, count, stride, X), "Getting frames %i-%i", set,
+                   set + (nframe - 1) * fstride) != 0)
+        return 1;
+
+    // Read box info
+    if (box != NULL && A->cellLengthVID != -1) {
+        start[1] = 0;
+        count[1] = 3;
+        stride[1] = 1;
+        if (checkNCerr(nc_get_vars_double(A->ncid, A->cellLengthVID, start, count, stride, box),
+                       "Getting cell lengths.") != 0)
+            return 1;
+        if (checkNCerr(nc_get_vars_double(A->ncid, A->cellAngleVID, start, count, stride, box + 3 * nframe),
+                       "Getting cell angles.") != 0)
+            return 1;
+    }
+    return 0;
+}
+
 // netcdfWriteFrame()
 /** Write coords (and box if specified) to netcdf trajectory file.
  * \return 0 on success, 1 on error.
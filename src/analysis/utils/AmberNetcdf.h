@@ -67,6 +67,8 @@ int netcdfGetFrame(struct AmberNetcdf *, int, double *, double *);
 
 int netcdfGetNextFrame(struct AmberNetcdf *, double *, double *);
 
+int netcdfGetFrameBlock(struct AmberNetcdf *, int, int, int, int, int, int, float *, double *);
+
 int netcdfWriteFrame(struct AmberNetcdf *, int, double *, double *);
 
 int netcdfWriteNextFrame(struct AmberNetcdf *, double *, double *);
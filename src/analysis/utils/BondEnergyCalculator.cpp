@@ -1,9 +1,10 @@
-
 #include "BondEnergyCalculator.hpp"
 #include "data_structure/frame.hpp"
 #include "utils/PBCUtils.hpp"
 #include "utils/common.hpp"
 #include <boost/range/algorithm.hpp>
+#include <numeric>
+#include <tbb/tbb.h>
 
 namespace {
 
@@ -14,95 +15,166 @@ template <typename T, typename U> bool all_in_set(const T &sequecne, const std::
     }
     return true;
 }
+
+struct Vec {
+    double x, y, z;
+};
+
+// imaged vector from atom i to atom j
+inline Vec displacement(const Frame &frame, std::uint32_t i, std::uint32_t j) {
+    Vec r{frame.x[j] - frame.x[i], frame.y[j] - frame.y[i], frame.z[j] - frame.z[i]};
+    frame.image(r.x, r.y, r.z);
+    return r;
+}
+
+inline double dot(const Vec &a, const Vec &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+inline Vec cross(const Vec &a, const Vec &b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+// angle in degree between two vectors, the same as atom_angle and atom_dihedral
+inline double angle(const Vec &a, const Vec &b) {
+    auto cos = dot(a, b) / std::sqrt(dot(a, a) * dot(b, b));
+    return radian * std::acos(std::clamp(cos, -1.0, 1.0));
+}
+
+// terms are spread over blocks of the table, results go to table.energy
+template <typename Table, typename Kernel> void for_each_term(Table &table, Kernel kernel) {
+    table.energy.resize(table.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, table.size(), 1024), [&](const auto &range) {
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            table.energy[i] = kernel(i);
+        }
+    });
+}
+
+template <typename Table> double sum(const Table &table) {
+    return std::accumulate(table.energy.begin(), table.energy.end(), 0.0);
+}
+
+// every atom of a term takes the same share of its energy
+template <std::size_t N, typename Table, typename Member>
+void spread(const Table &table, std::vector<BondEnergyCalculator::Term> &terms, Member member) {
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        const auto share = table.energy[i] / N;
+        for (std::size_t j = 0; j < N; ++j) {
+            terms[table.residues[j][i]].*member += share;
+        }
+    }
+}
+
 } // namespace
 
 BondEnergyCalculator::BondEnergyCalculator(const std::vector<std::shared_ptr<Atom>> &atoms,
                                            const std::shared_ptr<Frame> &frame) {
-
     std::set atoms_set(std::begin(atoms), std::end(atoms));
 
-    for (const auto &bond : frame->f_bond_params) {
-        if (all_in_set(bond.first, atoms_set)) {
-            bonds.push_back(std::cref(bond));
+    for (const auto &atom : atoms) {
+        if (atom->residue_num) {
+            residue_numbers.push_back(atom->residue_num.get());
         }
     }
-    for (const auto &angle : frame->f_angle_params) {
-        if (all_in_set(angle.first, atoms_set)) {
-            angles.push_back(std::cref(angle));
+    boost::sort(residue_numbers);
+    residue_numbers.erase(std::unique(residue_numbers.begin(), residue_numbers.end()), residue_numbers.end());
+    residue_in_terms.resize(residue_numbers.size());
+
+    compile(bonds, frame->f_bond_params, atoms_set);
+    compile(angles, frame->f_angle_params, atoms_set);
+    compile(dihedrals, frame->f_dihedral_params, atoms_set);
+    compile(improper_dihedrals, frame->f_improper_dihedral_params, atoms_set);
+}
+
+BondEnergyCalculator::BondEnergyCalculator(const AmberMask &mask, const std::shared_ptr<Frame> &frame)
+    : BondEnergyCalculator(PBCUtils::find_atoms(mask, frame), frame) {}
+
+template <std::size_t N, typename Params>
+void BondEnergyCalculator::compile(TermTable<N> &table, const Params &params,
+                                   const std::set<std::shared_ptr<Atom>> &atoms_set) {
+    std::vector<typename Params::const_pointer> selected;
+    for (const auto &term : params) {
+        if (all_in_set(term.first, atoms_set)) {
+            selected.push_back(&term);
         }
     }
-    for (const auto &dihedral : frame->f_dihedral_params) {
-        if (all_in_set(dihedral.first, atoms_set)) {
-            dihedrals.push_back(std::cref(dihedral));
+    boost::stable_sort(selected, [](auto lhs, auto rhs) { return lhs->first[0]->index < rhs->first[0]->index; });
+
+    for (const auto term : selected) {
+        const auto &[atoms, param] = *term;
+        for (std::size_t j = 0; j < N; ++j) {
+            table.atoms[j].push_back(atoms[j]->index);
+            std::uint32_t slot = 0;
+            if (atoms[j]->residue_num) {
+                slot = boost::lower_bound(residue_numbers, static_cast<int>(atoms[j]->residue_num.get())) -
+                       residue_numbers.begin();
+                residue_in_terms[slot] = true;
+            } else {
+                has_residues = false;
+            }
+            table.residues[j].push_back(slot);
         }
-    }
-    for (const auto &improper : frame->f_improper_dihedral_params) {
-        if (all_in_set(improper.first, atoms_set)) {
-            improper_dihedrals.push_back(std::cref(improper));
+        if constexpr (std::is_same_v<std::decay_t<decltype(param)>, Frame::harmonic>) {
+            table.k.push_back(param.krA);
+            table.r0.push_back(param.rA);
+        } else {
+            table.k.push_back(param.cpA);
+            table.r0.push_back(param.phiA);
+            table.mult.push_back(param.mult);
         }
     }
 }
 
-BondEnergyCalculator::BondEnergyCalculator(const AmberMask &mask, const std::shared_ptr<Frame> &frame)
-    : BondEnergyCalculator(PBCUtils::find_atoms(mask, frame), frame) {}
+void BondEnergyCalculator::evaluate(const Frame &frame) {
+    for_each_term(bonds, [&](std::size_t i) {
+        auto r = displacement(frame, bonds.atoms[0][i], bonds.atoms[1][i]);
+        auto dr = std::sqrt(dot(r, r)) - bonds.r0[i];
+        return 0.5 * bonds.k[i] * dr * dr;
+    });
+    for_each_term(angles, [&](std::size_t i) {
+        auto v2_1 = displacement(frame, angles.atoms[1][i], angles.atoms[0][i]);
+        auto v2_3 = displacement(frame, angles.atoms[1][i], angles.atoms[2][i]);
+        auto theta = (angle(v2_1, v2_3) - angles.r0[i]) * degree;
+        return 0.5 * angles.k[i] * theta * theta;
+    });
+    auto torsion = [&frame](TermTable<4> &table) {
+        for_each_term(table, [&](std::size_t i) {
+            auto v1_2 = displacement(frame, table.atoms[0][i], table.atoms[1][i]);
+            auto v2_3 = displacement(frame, table.atoms[1][i], table.atoms[2][i]);
+            auto v3_4 = displacement(frame, table.atoms[2][i], table.atoms[3][i]);
+            auto phi = angle(cross(v1_2, v2_3), cross(v2_3, v3_4));
+            return table.k[i] * (1 + std::cos((phi * table.mult[i] - table.r0[i]) * degree));
+        });
+    };
+    torsion(dihedrals);
+    torsion(improper_dihedrals);
+}
 
 BondEnergyCalculator::Term BondEnergyCalculator::energy(const std::shared_ptr<Frame> &frame) {
+    evaluate(*frame);
+    return {.bond = sum(bonds), .angle = sum(angles), .dihedral = sum(dihedrals), .improper = sum(improper_dihedrals)};
+}
 
-    Term term{};
-    for (auto it = bonds.begin(); it != bonds.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto r = atom_distance(atoms, frame) - param.rA;
-        term.bond += 0.5 * param.krA * r * r;
-    }
-    for (auto it = angles.begin(); it != angles.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto theta = (atom_angle(atoms, frame) - param.rA) * degree;
-        term.angle += 0.5 * param.krA * theta * theta;
-    }
-    for (auto it = dihedrals.begin(); it != dihedrals.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto cos = std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree);
-        term.dihedral += param.cpA * (1 + cos);
-    }
-    for (auto it = improper_dihedrals.begin(); it != improper_dihedrals.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto cos = std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree);
-        term.improper += param.cpA * (1 + cos);
+const std::vector<BondEnergyCalculator::Term> &
+BondEnergyCalculator::energy_per_residue(const std::shared_ptr<Frame> &frame) {
+    if (!has_residues) {
+        throw std::runtime_error("residue decomposition needs residue numbers of all atoms");
     }
-    return term;
+    evaluate(*frame);
+    residue_terms.assign(residue_numbers.size(), Term{});
+    spread<2>(bonds, residue_terms, &Term::bond);
+    spread<3>(angles, residue_terms, &Term::angle);
+    spread<4>(dihedrals, residue_terms, &Term::dihedral);
+    spread<4>(improper_dihedrals, residue_terms, &Term::improper);
+    return residue_terms;
 }
 
 std::map<int, BondEnergyCalculator::Term>
 BondEnergyCalculator::energy_with_residue_rank(const std::shared_ptr<Frame> &frame) {
-
+    const auto &terms = energy_per_residue(frame);
     std::map<int, Term> terms_map;
-    for (auto it = bonds.begin(); it != bonds.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto r = atom_distance(atoms, frame) - param.rA;
-        auto half_bond = 0.25 * param.krA * r * r;
-        for (auto &atom : atoms)
-            terms_map[atom->residue_num.get()].bond += half_bond;
-    }
-    for (auto it = angles.begin(); it != angles.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto theta = (atom_angle(atoms, frame) - param.rA) * degree;
-        auto angle = 1 / 3.0 * 0.5 * param.krA * theta * theta;
-        for (auto &atom : atoms)
-            terms_map[atom->residue_num.get()].angle += angle;
-    }
-    for (auto it = dihedrals.begin(); it != dihedrals.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto cos = std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree);
-        auto dihedral = 0.25 * param.cpA * (1 + cos);
-        for (auto &atom : atoms)
-            terms_map[atom->residue_num.get()].dihedral += dihedral;
-    }
-    for (auto it = improper_dihedrals.begin(); it != improper_dihedrals.end(); ++it) {
-        const auto &[atoms, param] = it->get();
-        auto cos = std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree);
-        auto improper = 0.25 * param.cpA * (1 + cos);
-        for (auto &atom : atoms)
-            terms_map[atom->residue_num.get()].improper += improper;
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        if (residue_in_terms[i])
+            terms_map.emplace_hint(terms_map.end(), residue_numbers[i], terms[i]);
     }
     return terms_map;
-}
\ No newline at end of file
+}
@@ -5,7 +5,9 @@
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include <nlohmann/json.hpp>
+#include <set>
 #include <string_view>
+#include <vector>
 
 class BondEnergyCalculator {
 public:
@@ -29,15 +31,40 @@ public:
         return calculator.energy(frame);
     }
 
+    // per residue terms in a dense array, in the order of residues() (all residues of the selected atoms)
+    const std::vector<Term> &energy_per_residue(const std::shared_ptr<Frame> &frame);
+
+    [[nodiscard]] const std::vector<int> &residues() const { return residue_numbers; }
+
 private:
-    std::vector<std::reference_wrapper<const std::pair<const std::array<std::shared_ptr<Atom>, 2>, Frame::harmonic>>>
-        bonds;
-    std::vector<std::reference_wrapper<const std::pair<const std::array<std::shared_ptr<Atom>, 3>, Frame::harmonic>>>
-        angles;
-    std::vector<std::reference_wrapper<const std::pair<const std::array<std::shared_ptr<Atom>, 4>, Frame::pdihs>>>
-        dihedrals;
-    std::vector<std::reference_wrapper<const std::pair<const std::array<std::shared_ptr<Atom>, 4>, Frame::pdihs>>>
-        improper_dihedrals;
+    /*
+     *  bonded terms compiled into flat structure-of-arrays tables : Atom::index of every term atom, the dense
+     *  residue slot of that atom and the force field parameters, sorted by first atom
+     */
+    template <std::size_t N> struct TermTable {
+        std::array<std::vector<std::uint32_t>, N> atoms;
+        std::array<std::vector<std::uint32_t>, N> residues;
+        std::vector<double> k, r0;  // krA and rA, or cpA and phiA for dihedrals
+        std::vector<int> mult;      // dihedrals only
+        std::vector<double> energy; // per term energy of the current frame
+
+        [[nodiscard]] std::size_t size() const { return k.size(); }
+    };
+
+    template <std::size_t N, typename Params> void compile(TermTable<N> &table, const Params &params,
+                                                           const std::set<std::shared_ptr<Atom>> &atoms_set);
+
+    void evaluate(const Frame &frame);
+
+    TermTable<2> bonds;
+    TermTable<3> angles;
+    TermTable<4> dihedrals;
+    TermTable<4> improper_dihedrals;
+
+    bool has_residues = true;
+    std::vector<int> residue_numbers;
+    std::vector<bool> residue_in_terms;
+    std::vector<Term> residue_terms;
 };
 
 inline void to_json(nlohmann::json &j, const BondEnergyCalculator::Term &term) {
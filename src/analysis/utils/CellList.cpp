@@ -0,0 +1,246 @@
+#include "CellList.hpp"
+
+#include <tbb/tbb.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+#include "data_structure/atom_group.hpp"
+#include "data_structure/frame.hpp"
+
+namespace {
+
+// atoms of the first set searched by one task
+constexpr std::size_t block_size = 256;
+
+std::array<double, 3> cross(const std::array<double, 3> &u, const std::array<double, 3> &v) {
+    return {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+}
+
+double norm(const std::array<double, 3> &u) { return std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]); }
+
+// coordinates of the atoms at indices, in the precision of the search
+template <typename Real>
+void gather(const Frame &frame, std::span<const std::size_t> indices, std::vector<Real> &xs, std::vector<Real> &ys,
+            std::vector<Real> &zs) {
+    xs.resize(indices.size());
+    ys.resize(indices.size());
+    zs.resize(indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        xs[i] = static_cast<Real>(frame.x[indices[i]]);
+        ys[i] = static_cast<Real>(frame.y[indices[i]]);
+        zs[i] = static_cast<Real>(frame.z[indices[i]]);
+    }
+}
+
+} // namespace
+
+template <typename Real> BasicCellList<Real>::BasicCellList(double cutoff) { set_cutoff(cutoff); }
+
+template <typename Real> void BasicCellList<Real>::set_cutoff(double cutoff) {
+    if (!(cutoff > 0)) {
+        throw std::runtime_error("cutoff of cell list must large than zero");
+    }
+    cutoff_distance = cutoff;
+}
+
+template <typename Real> void BasicCellList<Real>::build_grid(const Frame &frame) {
+    periodic = frame.enable_bound;
+    std::array<double, 3> widths{};
+    if (periodic) {
+        const auto &box = frame.box.getBoxVectors();
+        const double volume = box[0][0] * box[1][1] * box[2][2];
+        // distance between opposite faces of the cell
+        widths = {volume / norm(cross(box[1], box[2])), volume / norm(cross(box[2], box[0])),
+                  volume / norm(cross(box[0], box[1]))};
+
+        // lower triangular, so is the inverse
+        inverse_box = {};
+        inverse_box[0][0] = 1.0 / box[0][0];
+        inverse_box[1][1] = 1.0 / box[1][1];
+        inverse_box[2][2] = 1.0 / box[2][2];
+        inverse_box[1][0] = -box[1][0] * inverse_box[0][0] * inverse_box[1][1];
+        inverse_box[2][1] = -box[2][1] * inverse_box[1][1] * inverse_box[2][2];
+        inverse_box[2][0] = -(box[2][0] * inverse_box[0][0] + box[2][1] * inverse_box[1][0]) * inverse_box[2][2];
+    } else {
+        std::array<double, 3> lower{}, upper{};
+        bool first = true;
+        for (const auto &[xs, ys, zs] : {std::tie(xa, ya, za), std::tie(xb, yb, zb)}) {
+            for (std::size_t n = 0; n < xs.size(); ++n) {
+                const std::array<double, 3> r{xs[n], ys[n], zs[n]};
+                for (int d = 0; d < 3; ++d) {
+                    lower[d] = first ? r[d] : std::min(lower[d], r[d]);
+                    upper[d] = first ? r[d] : std::max(upper[d], r[d]);
+                }
+                first = false;
+            }
+        }
+        origin = lower;
+        for (int d = 0; d < 3; ++d) {
+            widths[d] = upper[d] - lower[d];
+        }
+    }
+
+    for (int d = 0; d < 3; ++d) {
+        cell_count[d] = std::max(1, int(widths[d] / cutoff_distance));
+    }
+    // sparse second set: bigger cells, never more cells than needed to hold a few atoms each
+    const double max_cells = 2.0 * xb.size() + 27;
+    const double cells = double(cell_count[0]) * cell_count[1] * cell_count[2];
+    if (cells > max_cells) {
+        const double scale = std::cbrt(max_cells / cells);
+        for (int d = 0; d < 3; ++d) {
+            cell_count[d] = std::max(1, int(cell_count[d] * scale));
+        }
+    }
+    if (!periodic) {
+        for (int d = 0; d < 3; ++d) {
+            inverse_width[d] = widths[d] > 0 ? cell_count[d] / widths[d] : 0.0;
+        }
+    }
+
+    // counting sort of the second set by cell, stable so atoms keep their order within a cell
+    const std::size_t total = flat(0, 0, cell_count[2]);
+    cell_start.assign(total + 1, 0);
+    cell_of_entry.resize(xb.size());
+    for (std::size_t j = 0; j < xb.size(); ++j) {
+        const auto [ci, cj, ck] = cell_of(xb[j], yb[j], zb[j]);
+        cell_of_entry[j] = flat(ci, cj, ck);
+        ++cell_start[cell_of_entry[j] + 1];
+    }
+    for (std::size_t c = 0; c < total; ++c) {
+        cell_start[c + 1] += cell_start[c];
+    }
+    entries.resize(xb.size());
+    for (std::size_t j = 0; j < xb.size(); ++j) {
+        entries[cell_start[cell_of_entry[j]]++] = {xb[j], yb[j], zb[j], static_cast<std::uint32_t>(j)};
+    }
+    for (std::size_t c = total; c > 0; --c) {
+        cell_start[c] = cell_start[c - 1];
+    }
+    cell_start[0] = 0;
+}
+
+template <typename Real> std::array<int, 3> BasicCellList<Real>::cell_of(double x, double y, double z) const {
+    std::array<int, 3> cell;
+    if (periodic) {
+        const std::array<double, 3> s{x * inverse_box[0][0] + y * inverse_box[1][0] + z * inverse_box[2][0],
+                                      y * inverse_box[1][1] + z * inverse_box[2][1], z * inverse_box[2][2]};
+        for (int d = 0; d < 3; ++d) {
+            cell[d] = std::min(cell_count[d] - 1, int((s[d] - std::floor(s[d])) * cell_count[d]));
+        }
+    } else {
+        const std::array<double, 3> r{x, y, z};
+        for (int d = 0; d < 3; ++d) {
+            cell[d] = std::clamp(int((r[d] - origin[d]) * inverse_width[d]), 0, cell_count[d] - 1);
+        }
+    }
+    return cell;
+}
+
+template <typename Real> int BasicCellList<Real>::neighbor_cells(int cell, int d, std::array<int, 3> &cells) const {
+    const int n = cell_count[d];
+    if (periodic and n >= 3) {
+        cells = {(cell + n - 1) % n, cell, (cell + 1) % n};
+        return 3;
+    }
+    if (periodic) {
+        cells = {0, 1, 0};
+        return n;
+    }
+    int count = 0;
+    for (int c = std::max(0, cell - 1); c <= std::min(n - 1, cell + 1); ++c) {
+        cells[count++] = c;
+    }
+    return count;
+}
+
+template <typename Real>
+const std::vector<CellListPair> &BasicCellList<Real>::search(const Frame &frame, std::span<const std::size_t> a,
+                                                             std::span<const std::size_t> b) {
+    gather(frame, a, xa, ya, za);
+    gather(frame, b, xb, yb, zb);
+    return search_gathered(frame);
+}
+
+template <typename Real>
+const std::vector<CellListPair> &BasicCellList<Real>::search(const Frame &frame, const AtomGroup &a,
+                                                             const AtomGroup &b) {
+    a.gather(frame, xa, ya, za);
+    b.gather(frame, xb, yb, zb);
+    return search_gathered(frame);
+}
+
+template <typename Real> const std::vector<CellListPair> &BasicCellList<Real>::search_gathered(const Frame &frame) {
+    if (cutoff_distance <= 0) {
+        throw std::runtime_error("cutoff of cell list is not set");
+    }
+    result.clear();
+    if (xa.empty() or xb.empty()) return result;
+    build_grid(frame);
+
+    const auto cutoff2 = static_cast<Real>(cutoff_distance * cutoff_distance);
+    const std::size_t count = xa.size();
+    const std::size_t blocks = (count + block_size - 1) / block_size;
+    if (block_pairs.size() < blocks) block_pairs.resize(blocks);
+
+    auto search_block = [&](std::size_t block) {
+        auto &out = block_pairs[block];
+        out.clear();
+        const std::size_t last = std::min(count, (block + 1) * block_size);
+        for (std::size_t i = block * block_size; i < last; ++i) {
+            const Real x = xa[i], y = ya[i], z = za[i];
+            const auto cell = cell_of(x, y, z);
+            std::array<int, 3> cx, cy, cz;
+            const int nx = neighbor_cells(cell[0], 0, cx);
+            const int ny = neighbor_cells(cell[1], 1, cy);
+            const int nz = neighbor_cells(cell[2], 2, cz);
+
+            const std::size_t begin = out.size();
+            for (int k = 0; k < nz; ++k) {
+                for (int j = 0; j < ny; ++j) {
+                    for (int l = 0; l < nx; ++l) {
+                        const auto c = flat(cx[l], cy[j], cz[k]);
+                        for (auto e = cell_start[c]; e < cell_start[c + 1]; ++e) {
+                            const auto &entry = entries[e];
+                            Real dx = entry.x - x;
+                            Real dy = entry.y - y;
+                            Real dz = entry.z - z;
+                            if (periodic) frame.box.image(dx, dy, dz);
+                            const Real d2 = dx * dx + dy * dy + dz * dz;
+                            if (d2 <= cutoff2) {
+                                out.push_back({static_cast<std::uint32_t>(i), entry.j, d2});
+                            }
+                        }
+                    }
+                }
+            }
+            std::sort(out.begin() + begin, out.end(), [](const Pair &p1, const Pair &p2) { return p1.j < p2.j; });
+        }
+    };
+
+    if (blocks == 1) {
+        search_block(0);
+    } else {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, blocks), [&](const tbb::blocked_range<std::size_t> &r) {
+            for (auto block = r.begin(); block != r.end(); ++block) {
+                search_block(block);
+            }
+        });
+    }
+    std::size_t total = 0;
+    for (std::size_t block = 0; block < blocks; ++block) {
+        total += block_pairs[block].size();
+    }
+    // headroom, so a frame with a few more pairs than the ones before does not reallocate
+    if (result.capacity() < total) result.reserve(total + total / 2);
+    for (std::size_t block = 0; block < blocks; ++block) {
+        result.insert(result.end(), block_pairs[block].begin(), block_pairs[block].end());
+    }
+    return result;
+}
+
+template class BasicCellList<float>;
+template class BasicCellList<double>;
@@ -0,0 +1,98 @@
+#ifndef TINKER_CELLLIST_HPP
+#define TINKER_CELLLIST_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "utils/precision.hpp"
+
+class Frame;
+
+class AtomGroup;
+
+// a pair found by a cell list search, i and j are positions in the two index sets
+struct CellListPair {
+    std::uint32_t i;
+    std::uint32_t j;
+    double distance2;
+};
+
+/*
+ *  cell list neighbor search between two sets of atoms (Atom::index into the coordinate arrays of a frame).
+ *  Atoms of the second set are binned into a grid of cells no thinner than the cutoff, along the box vectors
+ *  when the frame is periodic (orthogonal or triclinic) and over the bounding box otherwise, so only the 27
+ *  cells around an atom of the first set hold candidates. The grid is rebuilt on every search in O(N + M);
+ *  buffers are kept between searches, so a frame loop does not allocate once they have grown.
+ *
+ *  coordinates are gathered into Real and the distances are computed in Real, CellList is the one of coord_real.
+ *  pairs hold positions in the two index sets and the squared minimum image distance, distance2 <= cutoff^2.
+ *  They are ordered by i, then by j, the same order as the nested loop they replace
+ */
+template <typename Real> class BasicCellList {
+public:
+    using Pair = CellListPair;
+
+    BasicCellList() = default;
+
+    explicit BasicCellList(double cutoff);
+
+    [[nodiscard]] double cutoff() const { return cutoff_distance; }
+
+    void set_cutoff(double cutoff);
+
+    const std::vector<Pair> &search(const Frame &frame, std::span<const std::size_t> a,
+                                    std::span<const std::size_t> b);
+
+    const std::vector<Pair> &search(const Frame &frame, const AtomGroup &a, const AtomGroup &b);
+
+    [[nodiscard]] const std::vector<Pair> &pairs() const { return result; }
+
+private:
+    struct Entry {
+        Real x, y, z;
+        std::uint32_t j;
+    };
+
+    // search on the gathered coordinates xa, ya, za and xb, yb, zb
+    const std::vector<Pair> &search_gathered(const Frame &frame);
+
+    void build_grid(const Frame &frame);
+
+    [[nodiscard]] std::array<int, 3> cell_of(double x, double y, double z) const;
+
+    // distinct cells next to cell along dimension d, at most 3
+    int neighbor_cells(int cell, int d, std::array<int, 3> &cells) const;
+
+    [[nodiscard]] std::size_t flat(int i, int j, int k) const {
+        return (std::size_t(k) * cell_count[1] + j) * cell_count[0] + i;
+    }
+
+    double cutoff_distance = 0.0;
+
+    bool periodic = false;
+    std::array<int, 3> cell_count{1, 1, 1};
+
+    // periodic: fractional coordinate of (x, y, z) is inverse_box applied to it; otherwise origin and cell width
+    std::array<std::array<double, 3>, 3> inverse_box{};
+    std::array<double, 3> origin{};
+    std::array<double, 3> inverse_width{};
+
+    std::vector<Real> xa, ya, za, xb, yb, zb;
+
+    std::vector<std::uint32_t> cell_start;
+    std::vector<std::uint32_t> cell_of_entry;
+    std::vector<Entry> entries;
+
+    std::vector<std::vector<Pair>> block_pairs;
+    std::vector<Pair> result;
+};
+
+extern template class BasicCellList<float>;
+extern template class BasicCellList<double>;
+
+using CellList = BasicCellList<coord_real>;
+
+#endif // TINKER_CELLLIST_HPP
@@ -0,0 +1,41 @@
+#include "CompactSeries.hpp"
+
+#include <cmath>
+
+namespace {
+
+constexpr float quantum = 32767.0f;
+
+float sign(float value) { return value < 0.0f ? -1.0f : 1.0f; }
+
+} // namespace
+
+PackedUnitVector::PackedUnitVector(const std::tuple<double, double, double> &unit_vector) {
+    auto [x, y, z] = unit_vector;
+    const double l1 = std::abs(x) + std::abs(y) + std::abs(z);
+    float pu = x / l1;
+    float pv = y / l1;
+    if (z < 0) {
+        // fold the lower hemisphere onto the corners of the square
+        const float fu = (1.0f - std::abs(pv)) * sign(pu);
+        const float fv = (1.0f - std::abs(pu)) * sign(pv);
+        pu = fu;
+        pv = fv;
+    }
+    u = static_cast<std::int16_t>(std::lround(pu * quantum));
+    v = static_cast<std::int16_t>(std::lround(pv * quantum));
+}
+
+std::array<float, 3> PackedUnitVector::unpack() const {
+    float x = u / quantum;
+    float y = v / quantum;
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0) {
+        const float fx = (1.0f - std::abs(y)) * sign(x);
+        const float fy = (1.0f - std::abs(x)) * sign(y);
+        x = fx;
+        y = fy;
+    }
+    const float norm = std::sqrt(x * x + y * y + z * z);
+    return {x / norm, y / norm, z / norm};
+}
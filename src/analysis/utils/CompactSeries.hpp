@@ -0,0 +1,85 @@
+#ifndef TINKER_COMPACTSERIES_HPP
+#define TINKER_COMPACTSERIES_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+/*
+ *  storage for per-frame time series that grow over the whole trajectory. Values go into fixed size chunks,
+ *  so appending never copies the history already stored and never needs twice its memory while growing
+ */
+template <typename T, std::size_t ChunkBits = 10> class ChunkedArray {
+public:
+    static constexpr std::size_t chunk_size = std::size_t(1) << ChunkBits;
+
+    void push_back(const T &value) {
+        if (count == chunks.size() * chunk_size) {
+            chunks.emplace_back(new T[chunk_size]);
+        }
+        (*this)[count++] = value;
+    }
+
+    [[nodiscard]] T &operator[](std::size_t i) { return chunks[i >> ChunkBits][i & (chunk_size - 1)]; }
+
+    [[nodiscard]] const T &operator[](std::size_t i) const { return chunks[i >> ChunkBits][i & (chunk_size - 1)]; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    void clear() {
+        chunks.clear();
+        count = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> chunks;
+    std::size_t count = 0;
+};
+
+// one bit per frame, e.g. whether a pair is within a cutoff
+class BitSeries {
+public:
+    void push_back(bool value) {
+        if ((count & 63) == 0) words.push_back(0);
+        if (value) words.back() |= std::uint64_t(1) << (count & 63);
+        ++count;
+    }
+
+    [[nodiscard]] bool operator[](std::size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    void clear() {
+        words.clear();
+        count = 0;
+    }
+
+private:
+    std::vector<std::uint64_t> words;
+    std::size_t count = 0;
+};
+
+/*
+ *  unit vector in 4 bytes, the octahedral projection of the sphere quantized to two 16 bit integers.
+ *  The direction is kept within 1E-4 rad
+ */
+class PackedUnitVector {
+public:
+    PackedUnitVector() = default;
+
+    explicit PackedUnitVector(const std::tuple<double, double, double> &unit_vector);
+
+    [[nodiscard]] std::array<float, 3> unpack() const;
+
+private:
+    std::int16_t u = 0;
+    std::int16_t v = 0;
+};
+
+#endif // TINKER_COMPACTSERIES_HPP
@@ -0,0 +1,93 @@
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "data_structure/frame.hpp"
+#include "utils/common.hpp"
+
+namespace {
+
+constexpr std::size_t block_size = 256;
+
+struct Vectors {
+    std::array<double, block_size> x, y, z;
+};
+
+// imaged vectors from atom `from` to atom `to` of the tuples [begin, begin + n)
+template <std::size_t N>
+void difference(const Frame &frame, std::span<const std::array<std::size_t, N>> items, std::size_t begin,
+                std::size_t n, std::size_t from, std::size_t to, Vectors &d) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto &item = items[begin + i];
+        d.x[i] = frame.x[item[to]] - frame.x[item[from]];
+        d.y[i] = frame.y[item[to]] - frame.y[item[from]];
+        d.z[i] = frame.z[item[to]] - frame.z[item[from]];
+    }
+    frame.image(std::span(d.x.data(), n), std::span(d.y.data(), n), std::span(d.z.data(), n));
+}
+
+template <std::size_t N, typename Kernel>
+void for_each_block(std::span<const std::array<std::size_t, N>> items, Kernel kernel) {
+    for (std::size_t begin = 0; begin < items.size(); begin += block_size) {
+        kernel(begin, std::min(block_size, items.size() - begin));
+    }
+}
+
+double clamped_angle(double cos) { return radian * std::acos(std::clamp(cos, -1.0, 1.0)); }
+
+} // namespace
+
+void atom_distances2(const Frame &frame, std::span<const std::array<std::size_t, 2>> pairs, std::span<double> out) {
+    Vectors d;
+    for_each_block(pairs, [&](std::size_t begin, std::size_t n) {
+        difference(frame, pairs, begin, n, 0, 1, d);
+        for (std::size_t i = 0; i < n; ++i) {
+            out[begin + i] = d.x[i] * d.x[i] + d.y[i] * d.y[i] + d.z[i] * d.z[i];
+        }
+    });
+}
+
+void atom_distances(const Frame &frame, std::span<const std::array<std::size_t, 2>> pairs, std::span<double> out) {
+    atom_distances2(frame, pairs, out);
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+        out[i] = std::sqrt(out[i]);
+    }
+}
+
+void atom_angles(const Frame &frame, std::span<const std::array<std::size_t, 3>> triplets, std::span<double> out) {
+    Vectors a, b;
+    for_each_block(triplets, [&](std::size_t begin, std::size_t n) {
+        difference(frame, triplets, begin, n, 1, 0, a);
+        difference(frame, triplets, begin, n, 1, 2, b);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double dot = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+            const double a2 = a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i];
+            const double b2 = b.x[i] * b.x[i] + b.y[i] * b.y[i] + b.z[i] * b.z[i];
+            out[begin + i] = clamped_angle(dot / std::sqrt(a2 * b2));
+        }
+    });
+}
+
+void atom_dihedrals(const Frame &frame, std::span<const std::array<std::size_t, 4>> quadruplets,
+                    std::span<double> out) {
+    Vectors b1, b2, b3;
+    for_each_block(quadruplets, [&](std::size_t begin, std::size_t n) {
+        difference(frame, quadruplets, begin, n, 0, 1, b1);
+        difference(frame, quadruplets, begin, n, 1, 2, b2);
+        difference(frame, quadruplets, begin, n, 2, 3, b3);
+        for (std::size_t i = 0; i < n; ++i) {
+            // normals of the two planes
+            const double c1x = b1.y[i] * b2.z[i] - b1.z[i] * b2.y[i];
+            const double c1y = b1.z[i] * b2.x[i] - b1.x[i] * b2.z[i];
+            const double c1z = b1.x[i] * b2.y[i] - b1.y[i] * b2.x[i];
+            const double c2x = b2.y[i] * b3.z[i] - b2.z[i] * b3.y[i];
+            const double c2y = b2.z[i] * b3.x[i] - b2.x[i] * b3.z[i];
+            const double c2z = b2.x[i] * b3.y[i] - b2.y[i] * b3.x[i];
+            const double dot = c1x * c2x + c1y * c2y + c1z * c2z;
+            const double n1 = c1x * c1x + c1y * c1y + c1z * c1z;
+            const double n2 = c2x * c2x + c2y * c2y + c2z * c2z;
+            out[begin + i] = clamped_angle(dot / std::sqrt(n1 * n2));
+        }
+    });
+}
@@ -0,0 +1,27 @@
+#ifndef TINKER_GEOMETRY_HPP
+#define TINKER_GEOMETRY_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+class Frame;
+
+/*
+ *  batched geometry over atom indices (Atom::index) into the coordinate arrays of a frame, minimum image aware.
+ *  out holds one value per index tuple. Difference vectors are gathered block by block into local arrays, imaged
+ *  together and reduced in plain loops the compiler vectorizes. Angles and dihedrals are in degree, the same as
+ *  atom_angle and atom_dihedral
+ */
+void atom_distances(const Frame &frame, std::span<const std::array<std::size_t, 2>> pairs, std::span<double> out);
+
+void atom_distances2(const Frame &frame, std::span<const std::array<std::size_t, 2>> pairs, std::span<double> out);
+
+// angle at the middle atom
+void atom_angles(const Frame &frame, std::span<const std::array<std::size_t, 3>> triplets, std::span<double> out);
+
+// angle between the planes 1-2-3 and 2-3-4, within [0, 180]
+void atom_dihedrals(const Frame &frame, std::span<const std::array<std::size_t, 4>> quadruplets,
+                    std::span<double> out);
+
+#endif // TINKER_GEOMETRY_HPP
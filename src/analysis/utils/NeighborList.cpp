@@ -0,0 +1,159 @@
+#include "NeighborList.hpp"
+
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "data_structure/frame.hpp"
+
+namespace {
+
+using Matrix = std::array<std::array<double, 3>, 3>;
+
+constexpr Matrix identity{{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}};
+
+// box vectors are rows of a lower triangular matrix, so is the inverse
+Matrix inverse_lower(const Matrix &box) {
+    Matrix inverse{};
+    inverse[0][0] = 1.0 / box[0][0];
+    inverse[1][1] = 1.0 / box[1][1];
+    inverse[2][2] = 1.0 / box[2][2];
+    inverse[1][0] = -box[1][0] * inverse[0][0] * inverse[1][1];
+    inverse[2][1] = -box[2][1] * inverse[1][1] * inverse[2][2];
+    inverse[2][0] = -(box[2][0] * inverse[0][0] + box[2][1] * inverse[1][0]) * inverse[2][2];
+    return inverse;
+}
+
+Matrix multiply(const Matrix &lhs, const Matrix &rhs) {
+    Matrix product{};
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            for (int k = 0; k < 3; ++k) {
+                product[r][c] += lhs[r][k] * rhs[k][c];
+            }
+        }
+    }
+    return product;
+}
+
+} // namespace
+
+NeighborList::NeighborList(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff, double skin)
+    : atoms_a(std::move(a)), atoms_b(std::move(b)), cutoff_distance(cutoff), skin_distance(skin) {
+    if (!(cutoff > 0)) {
+        throw std::runtime_error("cutoff of neighbor list must large than zero");
+    }
+    if (skin < 0) {
+        throw std::runtime_error("skin of neighbor list can not be negative");
+    }
+    cell_list.set_cutoff(cutoff_distance + skin_distance);
+}
+
+std::shared_ptr<NeighborList> NeighborList::shared(const std::vector<std::size_t> &a,
+                                                   const std::vector<std::size_t> &b, double cutoff) {
+    using Key = std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, double>;
+    static std::map<Key, std::weak_ptr<NeighborList>> lists;
+    static std::mutex lists_mutex;
+
+    std::lock_guard lock(lists_mutex);
+    // lists no task holds any more are dropped, the map does not grow with every analysis run
+    std::erase_if(lists, [](const auto &item) { return item.second.expired(); });
+    auto &entry = lists[Key{a, b, cutoff}];
+    auto list = entry.lock();
+    if (!list) {
+        list = std::make_shared<NeighborList>(a, b, cutoff);
+        entry = list;
+    }
+    return list;
+}
+
+const std::vector<CellList::Pair> &NeighborList::search(const Frame &frame) {
+    std::lock_guard lock(mutex);
+    const auto version = frame.coordinate_version();
+    if (version == filtered_version) return result;
+    if (need_rebuild(frame)) rebuild(frame);
+    filter(frame);
+    filtered_version = version;
+    return result;
+}
+
+bool NeighborList::need_rebuild(const Frame &frame) const {
+    if (!built or periodic != frame.enable_bound) return true;
+
+    // the old positions carried along with the box, r0 * box0^-1 * box as row vectors
+    Matrix deformation = identity;
+    double stretch = 0.0;
+    if (periodic and box0 != frame.box.getBoxVectors()) {
+        deformation = multiply(inverse_lower(box0), frame.box.getBoxVectors());
+        double norm2 = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                const double d = deformation[r][c] - identity[r][c];
+                norm2 += d * d;
+            }
+        }
+        // a candidate pair distance of cutoff + skin changes by at most this, half of it falls on each atom
+        stretch = 0.5 * std::sqrt(norm2) * (cutoff_distance + skin_distance);
+    }
+    const double limit = 0.5 * skin_distance - stretch;
+    if (limit <= 0) return true;
+
+    const double limit2 = limit * limit;
+    const bool deformed = deformation != identity;
+    std::size_t n = 0;
+    for (const auto *indices : {&atoms_a, &atoms_b}) {
+        for (auto index : *indices) {
+            double x = x0[n], y = y0[n], z = z0[n];
+            if (deformed) {
+                x = x0[n] * deformation[0][0] + y0[n] * deformation[1][0] + z0[n] * deformation[2][0];
+                y = x0[n] * deformation[0][1] + y0[n] * deformation[1][1] + z0[n] * deformation[2][1];
+                z = x0[n] * deformation[0][2] + y0[n] * deformation[1][2] + z0[n] * deformation[2][2];
+            }
+            double dx = frame.x[index] - x;
+            double dy = frame.y[index] - y;
+            double dz = frame.z[index] - z;
+            frame.image(dx, dy, dz);
+            if (dx * dx + dy * dy + dz * dz > limit2) return true;
+            ++n;
+        }
+    }
+    return false;
+}
+
+void NeighborList::rebuild(const Frame &frame) {
+    candidates = cell_list.search(frame, atoms_a, atoms_b);
+
+    x0.clear();
+    y0.clear();
+    z0.clear();
+    for (const auto *indices : {&atoms_a, &atoms_b}) {
+        for (auto index : *indices) {
+            x0.push_back(frame.x[index]);
+            y0.push_back(frame.y[index]);
+            z0.push_back(frame.z[index]);
+        }
+    }
+    periodic = frame.enable_bound;
+    box0 = frame.box.getBoxVectors();
+    built = true;
+    ++rebuilds;
+}
+
+void NeighborList::filter(const Frame &frame) {
+    // in coord_real like the cell list, so both give the same pairs
+    const auto cutoff2 = static_cast<coord_real>(cutoff_distance * cutoff_distance);
+    result.clear();
+    for (const auto &candidate : candidates) {
+        const auto i = atoms_a[candidate.i];
+        const auto j = atoms_b[candidate.j];
+        coord_real dx = static_cast<coord_real>(frame.x[j]) - static_cast<coord_real>(frame.x[i]);
+        coord_real dy = static_cast<coord_real>(frame.y[j]) - static_cast<coord_real>(frame.y[i]);
+        coord_real dz = static_cast<coord_real>(frame.z[j]) - static_cast<coord_real>(frame.z[i]);
+        frame.image(dx, dy, dz);
+        const coord_real d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 <= cutoff2) {
+            result.push_back({candidate.i, candidate.j, d2});
+        }
+    }
+}
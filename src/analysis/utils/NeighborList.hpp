@@ -0,0 +1,73 @@
+#ifndef TINKER_NEIGHBORLIST_HPP
+#define TINKER_NEIGHBORLIST_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/CellList.hpp"
+
+class Frame;
+
+/*
+ *  Verlet list between two sets of atoms (Atom::index) reused over frames and shared by tasks.
+ *  The cell list is searched with cutoff + skin, and the pairs found are kept as candidates. A change of the box
+ *  is taken as a deformation of the old positions, which stretches a pair distance of cutoff + skin by at most
+ *  the norm of the deformation times that distance. While half of this plus the largest move of an atom of either
+ *  set away from its deformed position stays within half the skin, no pair beyond the candidates can be within
+ *  cutoff, so a frame only recomputes the distances of the candidates. Slowly scaling boxes (NPT) keep the list.
+ *
+ *  pairs are the ones CellList::search would give with cutoff, in the same order. Tasks asking for the same
+ *  sets and cutoff get one instance through shared, and a frame is filtered once for all of them
+ */
+class NeighborList {
+public:
+    // Ang, wide enough for liquids at usual output frequency to skip most searches
+    static constexpr double default_skin = 1.0;
+
+    NeighborList(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff, double skin = default_skin);
+
+    // the instance of these sets and cutoff in use by any task, a new one if none
+    static std::shared_ptr<NeighborList> shared(const std::vector<std::size_t> &a, const std::vector<std::size_t> &b,
+                                                double cutoff);
+
+    [[nodiscard]] double cutoff() const { return cutoff_distance; }
+
+    [[nodiscard]] double skin() const { return skin_distance; }
+
+    const std::vector<CellList::Pair> &search(const Frame &frame);
+
+    // searches of the cell list so far
+    [[nodiscard]] std::size_t rebuild_count() const { return rebuilds; }
+
+private:
+    [[nodiscard]] bool need_rebuild(const Frame &frame) const;
+
+    void rebuild(const Frame &frame);
+
+    void filter(const Frame &frame);
+
+    std::vector<std::size_t> atoms_a;
+    std::vector<std::size_t> atoms_b;
+    double cutoff_distance;
+    double skin_distance;
+
+    CellList cell_list;
+    std::vector<CellList::Pair> candidates;
+    std::vector<CellList::Pair> result;
+
+    // coordinates of atoms_a then atoms_b, and the box, at the last search of the cell list
+    std::vector<double> x0, y0, z0;
+    bool built = false;
+    bool periodic = false;
+    std::array<std::array<double, 3>, 3> box0{};
+
+    std::uint64_t filtered_version = 0;
+    std::size_t rebuilds = 0;
+    std::mutex mutex;
+};
+
+#endif // TINKER_NEIGHBORLIST_HPP
@@ -1,6 +1,7 @@
 
 #include <boost/format.hpp>
 #include <cmath>
+#include <cstring>
 
 #include "common.hpp"
 #include "PBCBox.hpp"
@@ -17,12 +18,52 @@ void PBCBox::check_box_type() {
     }
 }
 
+namespace {
+
+// the last box built on this thread; at constant volume every frame brings the same box and reuses it
+template <typename Key> struct BoxCache {
+    Key key{};
+    PBCBox box;
+    bool valid = false;
+};
+
+} // namespace
+
 PBCBox::PBCBox(double xbox, double ybox, double zbox, double alpha, double beta, double gamma)
     : axis{xbox, ybox, zbox}, angles{alpha, beta, gamma} {
+    static thread_local BoxCache<std::array<double, 6>> cache;
+    const std::array<double, 6> key{xbox, ybox, zbox, alpha, beta, gamma};
+    if (cache.valid and cache.key == key) {
+        *this = cache.box;
+        return;
+    }
+
     check_box_type();
+    box = {};
+    box[0][0] = axis[0];
+    box[1][1] = axis[1];
+    box[2][2] = axis[2];
+    if (box_type != Type::orthogonal) {
+        box[1][0] = axis[1] * std::cos(angles[2] / radian);
+        box[1][1] = axis[1] * std::sin(angles[2] / radian);
+
+        box[2][0] = axis[2] * std::cos(angles[1] / radian);
+        box[2][1] = (axis[1] * axis[2] * std::cos(angles[0] / radian) - box[1][0] * box[2][0]) / box[1][1];
+        box[2][2] = std::sqrt(axis[2] * axis[2] - box[2][0] * box[2][0] - box[2][1] * box[2][1]);
+    }
+    set_lattice();
+    cache = {key, *this, true};
 }
 
 PBCBox::PBCBox(gmx::matrix box) {
+    static thread_local BoxCache<std::array<gmx::real, 9>> cache;
+    std::array<gmx::real, 9> key;
+    std::memcpy(key.data(), box, sizeof(key));
+    if (cache.valid and cache.key == key) {
+        *this = cache.box;
+        return;
+    }
+
     const auto &[v1x, v1y, v1z] = box[0];
     const auto &[v2x, v2y, v2z] = box[1];
     const auto &[v3x, v3y, v3z] = box[2];
@@ -46,67 +87,55 @@ PBCBox::PBCBox(gmx::matrix box) {
             this->box[i][j] = 10 * box[i][j];
         }
     }
-    gmx::set_pbc(&pbc, -1, this->box);
-    dirty = false;
+    set_lattice();
+    cache = {key, *this, true};
 }
 
-void PBCBox::getBoxParameter(gmx::matrix box) const {
-    if (dirty) {
-        box[0][0] = axis[0];
-        box[0][1] = 0.0;
-        box[0][2] = 0.0;
-
-        box[1][0] = axis[1] * std::cos(angles[2] / radian);
-        box[1][1] = axis[1] * std::sin(angles[2] / radian);
-        box[1][2] = 0.0;
-
-        box[2][0] = axis[2] * std::cos(angles[1] / radian);
-        box[2][1] = (axis[1] * axis[2] * std::cos(angles[0] / radian) - box[1][0] * box[2][0]) / box[1][1];
-        box[2][2] = std::sqrt(axis[2] * axis[2] - box[2][0] * box[2][0] - box[2][1] * box[2][1]);
+void PBCBox::set_lattice() {
+    for (int i = 0; i < 3; ++i) {
+        inverse_diagonal[i] = 1.0 / box[i][i];
+    }
 
-        box[0][0] *= 0.1;
-        box[1][0] *= 0.1;
-        box[1][1] *= 0.1;
-        box[2][0] *= 0.1;
-        box[2][1] *= 0.1;
-        box[2][2] *= 0.1;
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                this->box[i][j] = 10 * box[i][j];
-            }
-        }
-        gmx::set_pbc(&pbc, -1, this->box);
-        dirty = false;
-    } else {
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                box[i][j] = 0.1 * this->box[i][j];
+    /*
+     *  a reduced vector is no longer than half the diagonal of the brick, so a shift can only shorten it when it is
+     *  shorter than the whole diagonal
+     */
+    const double diagonal2 = box[0][0] * box[0][0] + box[1][1] * box[1][1] + box[2][2] * box[2][2];
+    shift_count = 0;
+    if (box_type == Type::orthogonal) return;
+    for (int i = -1; i <= 1; ++i) {
+        for (int j = -1; j <= 1; ++j) {
+            for (int k = -1; k <= 1; ++k) {
+                if (i == 0 and j == 0 and k == 0) continue;
+                std::array<double, 3> shift;
+                for (int d = 0; d < 3; ++d) {
+                    shift[d] = i * box[0][d] + j * box[1][d] + k * box[2][d];
+                }
+                if (shift[0] * shift[0] + shift[1] * shift[1] + shift[2] * shift[2] < diagonal2) {
+                    shifts[shift_count++] = shift;
+                }
             }
         }
     }
 }
 
-void PBCBox::image(double &xr, double &yr, double &zr) const {
-    if (dirty) {
-        gmx::matrix box;
-        getBoxParameter(box);
+void PBCBox::getBoxParameter(gmx::matrix box) const {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            box[i][j] = 0.1 * this->box[i][j];
+        }
     }
+}
 
-    if (box_type == Type::orthogonal) {
-        while (std::abs(xr) > 0.5 * axis[0])
-            xr -= sign(axis[0], xr);
-        while (std::abs(yr) > 0.5 * axis[1])
-            yr -= sign(axis[1], yr);
-        while (std::abs(zr) > 0.5 * axis[2])
-            zr -= sign(axis[2], zr);
+void PBCBox::image(std::span<double> xr, std::span<double> yr, std::span<double> zr) const {
+    if (shift_count == 0) {
+        for (std::size_t i = 0; i < xr.size(); ++i) {
+            reduce(xr[i], yr[i], zr[i]);
+        }
     } else {
-        gmx::rvec x1 = {static_cast<gmx::real>(xr), static_cast<gmx::real>(yr), static_cast<gmx::real>(zr)};
-        gmx::rvec x2 = {0, 0, 0};
-        gmx::rvec dx;
-        gmx::pbc_dx(&pbc, x1, x2, dx);
-        xr = dx[0];
-        yr = dx[1];
-        zr = dx[2];
+        for (std::size_t i = 0; i < xr.size(); ++i) {
+            image(xr[i], yr[i], zr[i]);
+        }
     }
 }
 
@@ -114,6 +143,5 @@ double PBCBox::volume() const {
     if (box_type == Type::orthogonal)
         return axis[0] * axis[1] * axis[2];
 
-    const auto factor = 4.0 * std::sqrt(3) / 9.0;
-    return factor * std::pow(axis[0], 3);
+    return box[0][0] * box[1][1] * box[2][2];
 }
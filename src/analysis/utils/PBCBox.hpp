@@ -2,11 +2,12 @@
 #define TINKER_PBCBOX_HPP
 
 #include <array>
+#include <cmath>
+#include <span>
 
 namespace gmx {
 
 #include "gromacs/math/vectypes.h"
-#include "gromacs/pbcutil/pbc.h"
 
 }  // namespace gmx
 
@@ -30,8 +31,17 @@ public:
 
     void getBoxParameter(gmx::matrix box) const;
 
+    // box vectors a, b, c (Ang) as rows, lower triangular
+    const std::array<std::array<double, 3>, 3> &getBoxVectors() const { return box; }
+
     void image(double &xr, double &yr, double &zr) const;
 
+    // single precision kernels, see coord_real. The image is still taken in double
+    void image(float &xr, float &yr, float &zr) const;
+
+    // minimum image of many difference vectors, no data dependent branches so the loop vectorizes
+    void image(std::span<double> xr, std::span<double> yr, std::span<double> zr) const;
+
     double volume() const;
 
     Type get_box_type() { return box_type; }
@@ -43,14 +53,65 @@ private:
 
     void check_box_type();
 
-    Type box_type;
-    std::array<double, 3> axis;
-    std::array<double, 3> angles;
+    void set_lattice();
+
+    // the difference vector reduced into the brick of the box diagonal, c first, then b, then a
+    void reduce(double &xr, double &yr, double &zr) const {
+        double s = std::floor(zr * inverse_diagonal[2] + 0.5);
+        xr -= s * box[2][0];
+        yr -= s * box[2][1];
+        zr -= s * box[2][2];
+        s = std::floor(yr * inverse_diagonal[1] + 0.5);
+        xr -= s * box[1][0];
+        yr -= s * box[1][1];
+        s = std::floor(xr * inverse_diagonal[0] + 0.5);
+        xr -= s * box[0][0];
+    }
+
+    Type box_type = Type::orthogonal;
+    std::array<double, 3> axis{};
+    std::array<double, 3> angles{};
 
     friend class PBCUtils;
-    mutable gmx::matrix box;
-    mutable gmx::t_pbc pbc;
-    mutable bool dirty = true;
+
+    /*
+     *  box vectors a, b, c (Ang) as rows, a along x and b in the xy plane. inverse_diagonal and shifts are derived
+     *  once per box: after reducing a vector into the brick of the diagonal, only the lattice shifts in the list can
+     *  still make it shorter. The list is empty for orthogonal boxes
+     */
+    std::array<std::array<double, 3>, 3> box{};
+    std::array<double, 3> inverse_diagonal{};
+    std::array<std::array<double, 3>, 26> shifts{};
+    int shift_count = 0;
 };
 
+inline void PBCBox::image(double &xr, double &yr, double &zr) const {
+    reduce(xr, yr, zr);
+
+    double best = xr * xr + yr * yr + zr * zr;
+    double bx = xr, by = yr, bz = zr;
+    for (int i = 0; i < shift_count; i++) {
+        const double cx = xr + shifts[i][0];
+        const double cy = yr + shifts[i][1];
+        const double cz = zr + shifts[i][2];
+        const double d2 = cx * cx + cy * cy + cz * cz;
+        const bool shorter = d2 < best;
+        best = shorter ? d2 : best;
+        bx = shorter ? cx : bx;
+        by = shorter ? cy : by;
+        bz = shorter ? cz : bz;
+    }
+    xr = bx;
+    yr = by;
+    zr = bz;
+}
+
+inline void PBCBox::image(float &xr, float &yr, float &zr) const {
+    double x = xr, y = yr, z = zr;
+    image(x, y, z);
+    xr = x;
+    yr = y;
+    zr = z;
+}
+
 #endif  // TINKER_PBCBOX_HPP
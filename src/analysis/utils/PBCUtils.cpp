@@ -1,46 +1,44 @@
 
 #include "PBCUtils.hpp"
 
-#include <boost/graph/breadth_first_search.hpp>
-#include <boost/graph/prim_minimum_spanning_tree.hpp>
 #include <boost/range/numeric.hpp>
+#include <limits>
 
 #include "data_structure/atom.hpp"
 #include "data_structure/frame.hpp"
 #include "data_structure/molecule.hpp"
+#include "dsl/AmberMaskIndex.hpp"
 
 std::shared_ptr<Atom> PBCUtils::find_atom(const AmberMask &mask, const std::shared_ptr<Frame> &frame) {
     std::shared_ptr<Atom> ret;
-    for (auto &atom : frame->atom_list) {
-        if (is_match(atom, mask)) {
-            if (ret) {
-                throw std::runtime_error("More then one atom selected");
-            }
-            ret = atom;
+    auto selection = AmberMaskIndex::select(mask, frame);
+    for (auto i = selection->find_first(); i != AmberMaskIndex::Selection::npos; i = selection->find_next(i)) {
+        if (ret) {
+            throw std::runtime_error("More then one atom selected");
         }
+        ret = frame->atom_list[i];
     }
     return ret;
 }
 
 std::vector<std::shared_ptr<Atom>> PBCUtils::find_atoms(const AmberMask &mask, const std::shared_ptr<Frame> &frame) {
     std::vector<std::shared_ptr<Atom>> ret;
-    for (auto &atom : frame->atom_list) {
-        if (is_match(atom, mask)) {
-            ret.push_back(atom);
-        }
+    auto selection = AmberMaskIndex::select(mask, frame);
+    for (auto i = selection->find_first(); i != AmberMaskIndex::Selection::npos; i = selection->find_next(i)) {
+        ret.push_back(frame->atom_list[i]);
     }
     return ret;
 }
 
 std::shared_ptr<Molecule> PBCUtils::find_molecule(const AmberMask &mask, const std::shared_ptr<Frame> &frame) {
     std::shared_ptr<Molecule> ret;
-    for (auto &atom : frame->atom_list) {
-        if (is_match(atom, mask)) {
-            if (ret and ret != atom->molecule.lock()) {
-                throw std::runtime_error("More then one moleule selected");
-            }
-            ret = atom->molecule.lock();
+    auto selection = AmberMaskIndex::select(mask, frame);
+    for (auto i = selection->find_first(); i != AmberMaskIndex::Selection::npos; i = selection->find_next(i)) {
+        const auto &atom = frame->atom_list[i];
+        if (ret and ret != atom->molecule.lock()) {
+            throw std::runtime_error("More then one moleule selected");
         }
+        ret = atom->molecule.lock();
     }
     return ret;
 }
@@ -72,8 +70,8 @@ void PBCUtils::do_move_center_basedto_atom_group(const AmberMask &mask, const st
             mols_set.insert(atom->molecule.lock());
         }
     }
-    auto mol_seq = calculate_intermol_imp(mols_set, frame);
-    move(mols_set, mol_seq, frame);
+    calculate_intermol_imp(mols_set, mols_seq, frame);
+    move(mols_set, mols_seq, frame);
     auto center = boost::accumulate(selected_atoms, std::tuple<double, double, double>{},
                                     [](auto sum, auto &atom) { return sum + atom->getCoordinate(); }) /
                   selected_atoms.size();
@@ -143,6 +141,9 @@ void PBCUtils::doPBC(Trajconv::PBCType pbc_mode, const AmberMask &mask, const st
         do_move_center_basedto_atom_group(mask, frame);
         break;
     }
+    if (pbc_mode != Trajconv::PBCType::None) {
+        frame->sync_atoms();
+    }
 }
 
 void PBCUtils::move(std::set<std::shared_ptr<Molecule>> &mols_set,
@@ -159,53 +160,60 @@ void PBCUtils::move(std::set<std::shared_ptr<Molecule>> &mols_set,
         r -= old;
         for (auto &atom : target->atom_list) {
             std::tie(atom->x, atom->y, atom->z) += r;
+            frame->sync_atom(*atom);
         }
         target->inplace_geometry_center += r;
     }
+    frame->coordinates_changed();
 }
 
-std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>>
-PBCUtils::calculate_intermol_imp(const std::set<std::shared_ptr<Molecule>> &mols_set,
-                                 const std::shared_ptr<Frame> &frame) {
+void PBCUtils::calculate_intermol_imp(
+    const std::set<std::shared_ptr<Molecule>> &mols_set,
+    std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> &mole_seq,
+    const std::shared_ptr<Frame> &frame) {
+    // dense Prim over the complete graph of molecule centers, scratch arrays are reused between frames
+    thread_local std::vector<const std::shared_ptr<Molecule> *> mols;
+    thread_local std::vector<double> distance2;
+    thread_local std::vector<std::size_t> parent;
+    thread_local std::vector<char> in_tree;
+
+    mole_seq.clear();
+    mols.clear();
     for (auto &mol : mols_set) {
         mol->do_aggregate(frame);
         mol->calc_geom_center_inplace();
-    }
-    std::vector<std::shared_ptr<Molecule>> mols(std::begin(mols_set), std::end(mols_set));
-    Graph g;
-    for (auto &mol : mols)
-        mol->vertex_descriptor = boost::add_vertex(g);
-
-    using namespace boost;
-    for (auto it1 = mols.begin(); it1 != --mols.end(); ++it1) {
-        auto center1 = (*it1)->inplace_geometry_center;
-        auto it2 = it1;
-        for (++it2; it2 != mols.end(); ++it2) {
-            auto center2 = (*it2)->inplace_geometry_center;
-            auto r = center2 - center1;
+        mols.push_back(&mol);
+    }
+    const auto n = mols.size();
+    if (n < 2)
+        return;
+    distance2.assign(n, std::numeric_limits<double>::max());
+    parent.assign(n, 0);
+    in_tree.assign(n, false);
+
+    std::size_t current = 0;
+    in_tree[current] = true;
+    for (std::size_t added = 1; added < n; ++added) {
+        const auto center = (*mols[current])->inplace_geometry_center;
+        std::size_t next = n;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (in_tree[i])
+                continue;
+            auto r = (*mols[i])->inplace_geometry_center - center;
             frame->image(r);
-            auto d2 = vector_norm2(r);
-            add_edge((*it1)->vertex_descriptor, (*it2)->vertex_descriptor, d2, g);
+            if (auto d2 = vector_norm2(r); d2 < distance2[i]) {
+                distance2[i] = d2;
+                parent[i] = current;
+            }
+            if (next == n or distance2[i] < distance2[next])
+                next = i;
         }
+        in_tree[next] = true;
+        mole_seq.emplace_back(*mols[parent[next]], *mols[next]);
+        current = next;
     }
-
-    std::vector<graph_traits<Graph>::vertex_descriptor> p(num_vertices(g));
-    prim_minimum_spanning_tree(g, p.data());
-
-    std::vector<std::pair<std::size_t, std::size_t>> edges;
-    std::size_t root = 0;
-    for (std::size_t i = 0; i != p.size(); ++i)
-        if (p[i] != i)
-            edges.emplace_back(p[i], i);
-        else
-            root = i;
-
-    adjacency_list<vecS, vecS, directedS> tg(edges.begin(), edges.end(), p.size());
-    std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> mole_seq;
-    Visitor vis(mols, mole_seq);
-    breadth_first_search(tg, root, boost::visitor(vis));
-    return mole_seq;
 }
+
 std::tuple<double, double, double> PBCUtils::cal_box_center_shift(const std::shared_ptr<Frame> &frame) {
     return 0.5 * (std::make_tuple(frame->box.box[0][0], frame->box.box[0][1], frame->box.box[0][2]) +
                   std::make_tuple(frame->box.box[1][0], frame->box.box[1][1], frame->box.box[1][2]) +
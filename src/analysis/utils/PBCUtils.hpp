@@ -13,24 +13,6 @@
 
 class Frame;
 
-class Visitor : public boost::default_bfs_visitor {
-public:
-    explicit Visitor(std::vector<std::shared_ptr<Molecule>> &mols,
-                     std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> &mole_seq)
-        : mols(mols), mole_seq(mole_seq){};
-
-    template <typename Edge, typename Graph>
-    void tree_edge(Edge e, const Graph &g) {
-        auto source = boost::source(e, g);
-        auto target = boost::target(e, g);
-        mole_seq.emplace_back(mols[source], mols[target]);
-    }
-
-private:
-    std::vector<std::shared_ptr<Molecule>> &mols;
-    std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> &mole_seq;
-};
-
 class AggregateVisitor : public boost::default_bfs_visitor {
 public:
     explicit AggregateVisitor(const std::shared_ptr<Frame> &frame) : frame(frame){};
@@ -73,11 +55,12 @@ public:
 
     template <typename Iterator>
     static MolPair calculate_intermol(Iterator &&atoms, const std::shared_ptr<Frame> &frame) {
-        std::set<std::shared_ptr<Molecule>> mols_set;
+        MolPair mols;
         for (auto &atom : atoms) {
-            mols_set.insert(atom->molecule.lock());
+            mols.first.insert(atom->molecule.lock());
         }
-        return {mols_set, calculate_intermol_imp(mols_set, frame)};
+        calculate_intermol_imp(mols.first, mols.second, frame);
+        return mols;
     }
 
     static void move(std::set<std::shared_ptr<Molecule>> &mols_set,
@@ -87,14 +70,19 @@ public:
     static void move(MolPair &mols, const std::shared_ptr<Frame> &frame) { move(mols.first, mols.second, frame); };
 
 private:
-    static std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> calculate_intermol_imp(
-        const std::set<std::shared_ptr<Molecule>> &mols_set, const std::shared_ptr<Frame> &frame);
+    // order of molecule pairs (source, target) along a minimum spanning tree of molecule centers, so that every
+    // target follows its source when moved one after another
+    static void calculate_intermol_imp(
+        const std::set<std::shared_ptr<Molecule>> &mols_set,
+        std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> &mole_seq,
+        const std::shared_ptr<Frame> &frame);
 
     static std::tuple<double, double, double> cal_box_center_shift(const std::shared_ptr<Frame> &frame);
 
     mutable std::vector<std::shared_ptr<Atom>> selected_atoms;
     mutable std::shared_ptr<Molecule> selected_molecule;
     mutable std::set<std::shared_ptr<Molecule>> mols_set;
+    mutable std::vector<std::pair<std::shared_ptr<Molecule>, std::shared_ptr<Molecule>>> mols_seq;
 };
 
 #endif  // TINKER_PBCUTILS_HPP
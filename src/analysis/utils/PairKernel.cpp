@@ -0,0 +1,97 @@
+#include "PairKernel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace {
+
+// pairs handed to every kernel of a traversal before moving on
+constexpr std::size_t block_size = 4096;
+
+} // namespace
+
+PairKernel::PairKernel(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff)
+    : atoms_a(std::move(a)), atoms_b(std::move(b)), cutoff_distance(cutoff) {}
+
+void PairKernel::process(const Frame &frame) {
+    if (in_driver) return;
+    if (!neighbor_list) neighbor_list = NeighborList::shared(atoms_a, atoms_b, cutoff_distance);
+    accumulate(neighbor_list->search(frame));
+}
+
+void PairKernelDriver::add(std::shared_ptr<PairKernel> kernel) {
+    kernel->in_driver = true;
+    kernel->neighbor_list.reset();
+    const auto &second = kernel->second();
+    const bool ascending = std::adjacent_find(second.begin(), second.end(), std::greater_equal<>()) == second.end();
+    auto it = std::find_if(traversals.begin(), traversals.end(), [&](const Traversal &traversal) {
+        return traversal.first == kernel->first() and
+               ((traversal.merged and ascending) or traversal.second == kernel->second());
+    });
+    if (it == traversals.end()) {
+        traversals.push_back({kernel->first(), second, ascending});
+        it = std::prev(traversals.end());
+    } else if (it->merged) {
+        std::vector<std::size_t> merged;
+        std::set_union(it->second.begin(), it->second.end(), second.begin(), second.end(),
+                       std::back_inserter(merged));
+        it->second = std::move(merged);
+    }
+    it->kernels.push_back(std::move(kernel));
+    it->neighbor_list.reset();
+}
+
+void PairKernelDriver::prepare(Traversal &traversal) {
+    double cutoff = 0.0;
+    traversal.positions.resize(traversal.kernels.size());
+    traversal.buffers.resize(traversal.kernels.size());
+    for (std::size_t k = 0; k < traversal.kernels.size(); ++k) {
+        const auto &kernel = *traversal.kernels[k];
+        cutoff = std::max(cutoff, kernel.cutoff());
+        auto &positions = traversal.positions[k];
+        positions.clear();
+        if (kernel.second() == traversal.second) continue;
+        // both ascending, so one pass
+        positions.assign(traversal.second.size(), npos);
+        std::size_t u = 0;
+        for (std::size_t j = 0; j < kernel.second().size(); ++j) {
+            while (traversal.second[u] != kernel.second()[j]) ++u;
+            positions[u] = j;
+        }
+        traversal.buffers[k].reserve(block_size);
+    }
+    traversal.neighbor_list = NeighborList::shared(traversal.first, traversal.second, cutoff);
+}
+
+void PairKernelDriver::run(const Frame &frame) {
+    for (auto &traversal : traversals) {
+        if (!traversal.neighbor_list) prepare(traversal);
+        const std::span<const CellList::Pair> pairs = traversal.neighbor_list->search(frame);
+        for (std::size_t begin = 0; begin < pairs.size(); begin += block_size) {
+            const auto block = pairs.subspan(begin, std::min(block_size, pairs.size() - begin));
+            for (std::size_t k = 0; k < traversal.kernels.size(); ++k) {
+                const auto &positions = traversal.positions[k];
+                if (positions.empty()) {
+                    traversal.kernels[k]->accumulate(block);
+                    continue;
+                }
+                auto &buffer = traversal.buffers[k];
+                buffer.clear();
+                for (const auto &pair : block) {
+                    if (const auto j = positions[pair.j]; j != npos) buffer.push_back({pair.i, j, pair.distance2});
+                }
+                if (!buffer.empty()) traversal.kernels[k]->accumulate(buffer);
+            }
+        }
+    }
+}
+
+void PairKernelDriver::clear() {
+    for (auto &traversal : traversals) {
+        for (auto &kernel : traversal.kernels) {
+            kernel->in_driver = false;
+        }
+    }
+    traversals.clear();
+}
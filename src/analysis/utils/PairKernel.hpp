@@ -0,0 +1,125 @@
+#ifndef TINKER_PAIRKERNEL_HPP
+#define TINKER_PAIRKERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "utils/NeighborList.hpp"
+
+class Frame;
+
+/*
+ *  per-pair work of a task over two atom sets (Atom::index) within a cutoff.
+ *  A task makes its kernels with make_pair_kernel on the first frame and registers them with a PairKernelDriver,
+ *  which walks the pairs of all kernels over the same sets once per frame. A kernel no driver took runs over its
+ *  own neighbor list when the task calls process, so tasks work the same with or without a driver
+ */
+class PairKernel {
+public:
+    PairKernel(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff);
+
+    virtual ~PairKernel() = default;
+
+    [[nodiscard]] const std::vector<std::size_t> &first() const { return atoms_a; }
+
+    [[nodiscard]] const std::vector<std::size_t> &second() const { return atoms_b; }
+
+    [[nodiscard]] double cutoff() const { return cutoff_distance; }
+
+    [[nodiscard]] bool fused() const { return in_driver; }
+
+    // pairs of frame, unless a driver already gave them
+    void process(const Frame &frame);
+
+    /*
+     *  pairs of the two sets ordered like CellList::search, found with this cutoff or a larger one.
+     *  Called with consecutive blocks of the pairs of a frame
+     */
+    virtual void accumulate(std::span<const CellList::Pair> pairs) = 0;
+
+private:
+    friend class PairKernelDriver;
+
+    std::vector<std::size_t> atoms_a;
+    std::vector<std::size_t> atoms_b;
+    double cutoff_distance;
+    bool in_driver = false;
+
+    std::shared_ptr<NeighborList> neighbor_list;
+};
+
+// the callback is a template parameter, so it is inlined into the loop over a block of pairs
+template <typename Callback>
+class CallbackPairKernel : public PairKernel {
+public:
+    CallbackPairKernel(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff, Callback callback)
+        : PairKernel(std::move(a), std::move(b), cutoff), callback(std::move(callback)),
+          cutoff2(static_cast<coord_real>(cutoff * cutoff)) {}
+
+    void accumulate(std::span<const CellList::Pair> pairs) override {
+        for (const auto &pair : pairs) {
+            if (pair.distance2 <= cutoff2) callback(pair);
+        }
+    }
+
+private:
+    Callback callback;
+    double cutoff2; // rounded like the bound of the neighbor list
+};
+
+template <typename Callback>
+std::shared_ptr<PairKernel> make_pair_kernel(std::vector<std::size_t> a, std::vector<std::size_t> b, double cutoff,
+                                             Callback callback) {
+    return std::make_shared<CallbackPairKernel<Callback>>(std::move(a), std::move(b), cutoff, std::move(callback));
+}
+
+/*
+ *  kernels over the same first set share one neighbor list at the largest of their cutoffs, over the union of
+ *  their second sets. Every frame its pairs are read once and handed to the kernels block by block, while the block
+ *  is still in cache; a kernel over a part of the union gets the pairs of its atoms, renumbered to its own second
+ *  set. Only ascending second sets are merged, so the pairs keep their order; any other one shares a traversal only
+ *  with kernels over exactly the same sets
+ *
+ *  run is called once per frame before any task processes the frame, so kernels see the coordinates as read. Atoms
+ *  moved by a task in process (unwrap, centering) do not reach the kernels of tasks after it, as they would if those
+ *  kernels ran by themselves, so such a task moves the atoms of a copy of the frame
+ */
+class PairKernelDriver {
+public:
+    void add(std::shared_ptr<PairKernel> kernel);
+
+    void run(const Frame &frame);
+
+    // release all kernels, they run by themselves again
+    void clear();
+
+    [[nodiscard]] std::size_t traversal_count() const { return traversals.size(); }
+
+private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    struct Traversal {
+        std::vector<std::size_t> first;
+        std::vector<std::size_t> second; // union of the second sets of the kernels
+        bool merged = false;             // second sets are ascending, more may join
+
+        std::vector<std::shared_ptr<PairKernel>> kernels;
+        // per kernel, position in its second set of every atom of second, npos if absent; empty if the same set
+        std::vector<std::vector<std::uint32_t>> positions;
+        std::vector<std::vector<CellList::Pair>> buffers; // per kernel, its pairs of the current block
+
+        std::shared_ptr<NeighborList> neighbor_list;
+    };
+
+    // neighbor list and renumbering of a traversal, made again whenever a kernel joins
+    static void prepare(Traversal &traversal);
+
+    std::vector<Traversal> traversals;
+};
+
+#endif // TINKER_PAIRKERNEL_HPP
@@ -52,6 +52,10 @@ void ProgramConfiguration::load_config(const boost::filesystem::path &config_fil
         const auto &root = doc.child("cac-ana");
         vector_size = root.child("vector-size").attribute("value").as_ullong();
         nthreads = root.child("nthreads").attribute("value").as_int();
+        prefetch = root.child("prefetch").attribute("value").as_int();
+        parallel_decode = root.child("parallel-decode").attribute("value").as_int();
+        cache = root.child("cache").attribute("value").as_bool();
+        async_write = root.child("async-write").attribute("value").as_int();
 
         for (const auto &mask : root.children("macro")) {
             macro_mask.emplace_back(boost::trim_copy(std::string(mask.attribute("name").as_string())),
@@ -22,6 +22,14 @@ public:
 
     auto get_nthreads() { return nthreads; }
 
+    auto get_prefetch() { return prefetch; }
+
+    auto get_parallel_decode() { return parallel_decode; }
+
+    auto get_cache() { return cache; }
+
+    auto get_async_write() { return async_write; }
+
     const auto &get_macro_mask() { return macro_mask; }
 
 private:
@@ -29,6 +37,10 @@ private:
 
     std::size_t vector_size = 0;
     int nthreads = 0;
+    int prefetch = 0;
+    int parallel_decode = 0;
+    bool cache = false;
+    int async_write = 0;
 
     std::vector<std::pair<std::string, AmberMask>> macro_mask;
 };
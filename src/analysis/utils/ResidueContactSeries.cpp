@@ -0,0 +1,108 @@
+#include "ResidueContactSeries.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/topology.hpp"
+
+std::uint32_t ResidueContactSeries::key(const std::string &label) {
+    auto [it, inserted] = label_keys.emplace(label, labels.size());
+    if (inserted) {
+        labels.push_back(label);
+        frame_distance.push_back(-1.0);
+        touched.reserve(labels.size());
+    }
+    return it->second;
+}
+
+std::vector<std::uint32_t> ResidueContactSeries::residue_keys(const Frame &frame, std::span<const std::size_t> atoms,
+                                                             const std::string &separator) {
+    const auto &topology = *frame.topology;
+    std::vector<std::uint32_t> residue_key(topology.residue_count(), Topology::npos);
+    std::vector<std::uint32_t> keys;
+    keys.reserve(atoms.size());
+    for (auto i : atoms) {
+        const auto r = topology.residue_of(i);
+        if (r == Topology::npos) {
+            throw std::runtime_error("atom " + std::to_string(frame.atom_list[i]->seq) + " has no residue");
+        }
+        if (residue_key[r] == Topology::npos) {
+            const auto &first = frame.atom_list[topology.residue_atoms(r).first];
+            residue_key[r] = key(first->residue_name.value() + separator + std::to_string(topology.residue_number(r)));
+        }
+        keys.push_back(residue_key[r]);
+    }
+    return keys;
+}
+
+void ResidueContactSeries::reserve(std::size_t frames) {
+    frame_offsets.reserve(frame_offsets.size() + frames);
+    records.reserve(records.size() + std::min(frames * key_count(), max_reserved_records));
+}
+
+void ResidueContactSeries::begin_frame() { touched.clear(); }
+
+void ResidueContactSeries::end_frame() {
+    std::sort(touched.begin(), touched.end());
+    for (auto key : touched) {
+        records.push_back({key, frame_distance[key]});
+        frame_distance[key] = -1.0;
+    }
+    frame_offsets.push_back(records.size());
+}
+
+const ResidueContactSeries::Record *ResidueContactSeries::find(std::size_t i, std::uint32_t key) const {
+    const auto records_of_frame = frame(i);
+    auto it = std::lower_bound(records_of_frame.begin(), records_of_frame.end(), key,
+                               [](const Record &record, std::uint32_t k) { return record.key < k; });
+    return it != records_of_frame.end() and it->key == key ? &*it : nullptr;
+}
+
+std::vector<std::pair<std::uint32_t, std::size_t>> ResidueContactSeries::frequencies() const {
+    std::vector<std::size_t> counts(key_count());
+    for (const auto &record : records) {
+        ++counts[record.key];
+    }
+    std::vector<std::pair<std::uint32_t, std::size_t>> result;
+    for (std::uint32_t key = 0; key < counts.size(); ++key) {
+        if (counts[key]) {
+            result.emplace_back(key, counts[key]);
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [this](const auto &lhs, const auto &rhs) { return labels[lhs.first] < labels[rhs.first]; });
+    std::stable_sort(result.begin(), result.end(),
+                     [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
+    return result;
+}
+
+void ResidueContactSeries::print_distance_table(std::ostream &os) const {
+    const auto counter = frequencies();
+
+    os << "#Frame ";
+    for (const auto &[key, count] : counter) {
+        os << std::setw(15) << labels[key];
+    }
+    os << '\n';
+    os << std::string(7 + 15 * counter.size(), '#') << '\n';
+    os << "# Count";
+    for (const auto &[key, count] : counter) {
+        os << std::setw(15) << count;
+    }
+    os << '\n';
+    os << std::string(7 + 15 * counter.size(), '#') << '\n';
+
+    for (std::size_t i = 0; i < frames(); ++i) {
+        os << std::setw(7) << i + 1;
+        for (const auto &[key, count] : counter) {
+            if (auto record = find(i, key)) {
+                os << std::setw(15) << record->distance;
+            } else {
+                os << std::setw(15) << "";
+            }
+        }
+        os << '\n';
+    }
+}
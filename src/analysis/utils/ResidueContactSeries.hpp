@@ -0,0 +1,88 @@
+#ifndef TINKER_RESIDUECONTACTSERIES_HPP
+#define TINKER_RESIDUECONTACTSERIES_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Frame;
+
+/*
+ *  per frame the residues in contact and their shortest contact distance. Residue labels get integer keys
+ *  before the first frame, a frame collects keys in reused scratch arrays and appends them to one flat record
+ *  array, so the frame loop does not build maps or strings
+ */
+class ResidueContactSeries {
+public:
+    struct Record {
+        std::uint32_t key;
+        double distance;
+    };
+
+    // key of a residue label, the same label always gets the same key
+    std::uint32_t key(const std::string &label);
+
+    /*
+     *  keys of the residues of atoms (Atom::index), found in the residue table of frame. The label of a residue,
+     *  name separator number, is made once per residue, residues with the same label share a key
+     */
+    std::vector<std::uint32_t> residue_keys(const Frame &frame, std::span<const std::size_t> atoms,
+                                            const std::string &separator = "");
+
+    [[nodiscard]] const std::string &label(std::uint32_t key) const { return labels[key]; }
+
+    [[nodiscard]] std::size_t key_count() const { return labels.size(); }
+
+    /*
+     *  room for frames more frames. Records are reserved for every residue in contact in every frame, but for
+     *  no more than max_reserved_records, beyond that the record array grows geometrically
+     */
+    void reserve(std::size_t frames);
+
+    static constexpr std::size_t max_reserved_records = std::size_t(1) << 20;
+
+    void begin_frame();
+
+    // keeps the shortest distance of key within the current frame
+    void record(std::uint32_t key, double distance) {
+        if (frame_distance[key] < 0) {
+            touched.push_back(key);
+            frame_distance[key] = distance;
+        } else if (distance < frame_distance[key]) {
+            frame_distance[key] = distance;
+        }
+    }
+
+    void end_frame();
+
+    [[nodiscard]] std::size_t frames() const { return frame_offsets.size() - 1; }
+
+    // records of frame i sorted by key
+    [[nodiscard]] std::span<const Record> frame(std::size_t i) const {
+        return {records.data() + frame_offsets[i], records.data() + frame_offsets[i + 1]};
+    }
+
+    // record of key in frame i, nullptr when the residue is not in contact
+    [[nodiscard]] const Record *find(std::size_t i, std::uint32_t key) const;
+
+    // keys that appear in any frame with the number of frames, most frequent first
+    [[nodiscard]] std::vector<std::pair<std::uint32_t, std::size_t>> frequencies() const;
+
+    // the frame by residue table of shortest distances, residues ordered by frequency
+    void print_distance_table(std::ostream &os) const;
+
+private:
+    std::vector<std::string> labels;
+    std::unordered_map<std::string, std::uint32_t> label_keys;
+
+    std::vector<double> frame_distance; // scratch, negative for keys not in contact
+    std::vector<std::uint32_t> touched; // scratch
+
+    std::vector<Record> records;
+    std::vector<std::size_t> frame_offsets{0};
+};
+
+#endif // TINKER_RESIDUECONTACTSERIES_HPP
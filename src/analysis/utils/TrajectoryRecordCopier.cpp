@@ -0,0 +1,126 @@
+#include "TrajectoryRecordCopier.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+#include <fstream>
+
+#include "trajectory_reader/FrameIndex.hpp"
+#include "utils/common.hpp"
+
+namespace {
+
+constexpr std::uint64_t xdr_padding(std::uint64_t bytes) { return (bytes + 3) / 4 * 4; }
+
+std::int32_t get_int(const char *p) {
+    std::uint32_t raw;
+    std::memcpy(&raw, p, sizeof(raw));
+    return static_cast<std::int32_t>(boost::endian::big_to_native(raw));
+}
+
+template <typename T> void put_big_endian(char *p, T value) {
+    using Raw = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    Raw raw;
+    std::memcpy(&raw, &value, sizeof(raw));
+    raw = boost::endian::native_to_big(raw);
+    std::memcpy(p, &raw, sizeof(raw));
+}
+
+// XTC frame : magic natoms step time ...
+bool renumber_xtc(std::vector<char> &record, std::int32_t step) {
+    if (record.size() < 4 * sizeof(std::int32_t))
+        return false;
+    put_big_endian(&record[8], step);
+    put_big_endian(&record[12], static_cast<float>(step));
+    return true;
+}
+
+// TRR frame : magic version_string ir_size e_size box_size ... natoms step nre t lambda ...
+bool renumber_trr(std::vector<char> &record, std::int32_t step) {
+    if (record.size() < 3 * sizeof(std::int32_t))
+        return false;
+    const auto header = 3 * sizeof(std::int32_t) + xdr_padding(get_int(&record[8]));
+    const auto time = header + 13 * sizeof(std::int32_t);
+    if (record.size() < time + sizeof(float))
+        return false;
+
+    const char *sizes = &record[header];
+    const auto box_size = get_int(sizes + 2 * sizeof(std::int32_t));
+    const auto natoms = get_int(sizes + 10 * sizeof(std::int32_t));
+    std::size_t real_size = sizeof(float);
+    if (box_size) {
+        real_size = box_size / 9;
+    } else if (natoms > 0) {
+        for (auto i : {7, 8, 9}) { // x_size v_size f_size
+            if (auto block_size = get_int(sizes + i * sizeof(std::int32_t))) {
+                real_size = block_size / (3 * natoms);
+                break;
+            }
+        }
+    }
+    put_big_endian(&record[header + 11 * sizeof(std::int32_t)], step);
+    if (real_size == sizeof(double)) {
+        if (record.size() < time + sizeof(double))
+            return false;
+        put_big_endian(&record[time], static_cast<double>(step));
+    } else {
+        put_big_endian(&record[time], static_cast<float>(step));
+    }
+    return true;
+}
+
+} // namespace
+
+TrajectoryRecordCopier::TrajectoryRecordCopier(uint start, uint end, uint step, bool write_index)
+    : start(std::max(start, 1u)), end(end), step(std::max(step, 1u)), write_index(write_index) {}
+
+boost::optional<std::size_t> TrajectoryRecordCopier::copy(const std::vector<std::string> &inputs,
+                                                          const std::string &target) const {
+    const auto type = getFileType(target);
+    if (inputs.empty() or (type != FileType::XTC and type != FileType::TRR))
+        return {};
+
+    std::vector<FrameIndex> indexes;
+    for (const auto &input : inputs) {
+        if (getFileType(input) != type)
+            return {};
+        auto index = FrameIndex::load_or_build(input, type, write_index);
+        if (!index or (!indexes.empty() and index->natoms() != indexes.front().natoms()))
+            return {};
+        indexes.push_back(std::move(index.get()));
+    }
+
+    std::ofstream ofs(target, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+        throw std::runtime_error("can not open " + target);
+    }
+    std::vector<char> buffer;
+    std::size_t written = 0;
+    uint next = start; // number of the next selected frame, counted over all inputs
+    uint passed = 0;   // frames of the inputs before current one
+    for (std::size_t i = 0; i < inputs.size() and (end == 0 or next <= end); ++i) {
+        const auto &index = indexes[i];
+        std::ifstream ifs(inputs[i], std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("can not open " + inputs[i]);
+        }
+        while (next - passed <= index.size() and (end == 0 or next <= end)) {
+            const std::size_t frame = next - passed - 1;
+            buffer.resize(index.frame_size(frame));
+            ifs.seekg(index[frame].offset);
+            ifs.read(buffer.data(), buffer.size());
+            if (!ifs or !(type == FileType::XTC ? renumber_xtc(buffer, static_cast<std::int32_t>(written))
+                                                 : renumber_trr(buffer, static_cast<std::int32_t>(written)))) {
+                throw std::runtime_error("error read frame " + std::to_string(frame + 1) + " of " + inputs[i]);
+            }
+            ofs.write(buffer.data(), buffer.size());
+            ++written;
+            next += step;
+        }
+        passed += index.size();
+    }
+    ofs.close();
+    if (!ofs) {
+        throw std::runtime_error("error write " + target);
+    }
+    return written;
+}
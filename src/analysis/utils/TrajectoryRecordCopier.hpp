@@ -0,0 +1,33 @@
+#ifndef TINKER_TRAJECTORYRECORDCOPIER_HPP
+#define TINKER_TRAJECTORYRECORDCOPIER_HPP
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "utils/std.hpp"
+
+/*
+ *  concatenate, slice and stride Gromacs XTC/TRR trajectories by copying compressed frame records
+ *  byte-for-byte, located by FrameIndex, nothing is decoded or re-encoded.
+ *  frames are numbered from 1 over all input files, and frames start, start + step ... up to end (0 for all)
+ *  are written. Step and time of the output frames are rewritten to 0, 1, 2 ... the same as XTCWriter and
+ *  TRRWriter do, so the output equals the one of decoding and writing the frames.
+ *  With write_index, frame indexes of the inputs are saved as sidecar files
+ */
+class TrajectoryRecordCopier {
+public:
+    TrajectoryRecordCopier(uint start = 1, uint end = 0, uint step = 1, bool write_index = false);
+
+    /*
+     *  return number of frames written, or boost::none without touching target if the frame records can not be
+     *  copied (inputs and target are not all XTC or all TRR, a frame index is not available or atom numbers differ)
+     */
+    boost::optional<std::size_t> copy(const std::vector<std::string> &inputs, const std::string &target) const;
+
+private:
+    uint start, end, step;
+    bool write_index;
+};
+
+#endif // TINKER_TRAJECTORYRECORDCOPIER_HPP
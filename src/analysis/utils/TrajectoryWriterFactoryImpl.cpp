@@ -8,6 +8,8 @@
 #include <unordered_map>
 
 #include "utils/ArcWriter.hpp"
+#include "utils/async_writer.hpp"
+#include "utils/cache_writer.hpp"
 #include "utils/gro_writer.hpp"
 #include "utils/netcdf_writer.hpp"
 #include "utils/trr_writer.hpp"
@@ -19,11 +21,15 @@ shared_ptr<TrajectoryFormatWriter> TrajectoryWriterFactoryImpl::make_instance(Fi
     unordered_map<FileType, function<shared_ptr<TrajectoryFormatWriter>()>> mapping = {
         {FileType::NC, bind(make_shared<NetCDFWriter>)}, {FileType::XTC, bind(make_shared<XTCWriter>)},
         {FileType::TRR, bind(make_shared<TRRWriter>)},   {FileType::GRO, bind(make_shared<GROWriter>)},
-        {FileType::ARC, bind(make_shared<ArcWriter>)},
+        {FileType::ARC, bind(make_shared<ArcWriter>)},   {FileType::CACHE, bind(make_shared<CacheWriter>)},
     };
     auto it = mapping.find(t);
     if (it != mapping.end()) {
-        return it->second();
+        auto writer = it->second();
+        if (async_write_depth > 0) {
+            return make_shared<AsyncTrajectoryWriter>(writer, async_write_depth);
+        }
+        return writer;
     }
     throw std::runtime_error("File Type Error");
 }
@@ -0,0 +1,107 @@
+#include "async_writer.hpp"
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+
+AsyncTrajectoryWriter::AsyncTrajectoryWriter(std::shared_ptr<TrajectoryFormatWriter> writer, std::size_t depth)
+    : writer(std::move(writer)), depth(std::max<std::size_t>(depth, 1)) {}
+
+AsyncTrajectoryWriter::~AsyncTrajectoryWriter() { stop(); }
+
+void AsyncTrajectoryWriter::open(const std::string &filename) {
+    stop();
+    failed = false;
+    write_exception = nullptr;
+    writer->open(filename);
+}
+
+void AsyncTrajectoryWriter::write(const std::shared_ptr<Frame> &frame,
+                                  const std::vector<std::shared_ptr<Atom>> &atoms) {
+    rethrow();
+    if (!write_thread.joinable()) {
+        // names, residues and connectivity never change, only coordinates are copied afterwards
+        shadow_frame = std::make_shared<Frame>();
+        shadow_frame->atom_list = frame->atom_list;
+        shadow_frame->box = frame->box;
+        shadow_frame->title = frame->title;
+        shadow_atoms.clear();
+        shadow_atoms.reserve(atoms.size());
+        for (const auto &atom : atoms) {
+            shadow_atoms.push_back(std::make_shared<Atom>(*atom));
+        }
+        snapshots.clear();
+        free_snapshots.clear();
+        ready_snapshots.clear();
+        for (std::size_t i = 0; i < depth; ++i) {
+            auto &snapshot = snapshots.emplace_back(std::make_unique<FrameBuffer>());
+            snapshot->reserve(atoms.size());
+            free_snapshots.push(snapshot.get());
+        }
+        write_thread = std::thread(&AsyncTrajectoryWriter::writeLoop, this);
+    }
+
+    FrameBuffer *snapshot;
+    free_snapshots.pop(snapshot);
+    snapshot->reset();
+    snapshot->natoms = std::min(atoms.size(), snapshot->capacity);
+    for (std::size_t i = 0; i < snapshot->natoms; ++i) {
+        snapshot->x[3 * i] = atoms[i]->x;
+        snapshot->x[3 * i + 1] = atoms[i]->y;
+        snapshot->x[3 * i + 2] = atoms[i]->z;
+    }
+    if (frame->has_velocity) {
+        snapshot->has_velocity = true;
+        snapshot->v.resize(3 * snapshot->natoms);
+        for (std::size_t i = 0; i < snapshot->natoms; ++i) {
+            snapshot->v[3 * i] = atoms[i]->vx;
+            snapshot->v[3 * i + 1] = atoms[i]->vy;
+            snapshot->v[3 * i + 2] = atoms[i]->vz;
+        }
+    }
+    snapshot->enable_bound = frame->enable_bound;
+    snapshot->box = frame->box;
+    snapshot->time = frame->getCurrentTime();
+    snapshot->title = frame->title;
+    ready_snapshots.push(snapshot);
+}
+
+void AsyncTrajectoryWriter::writeLoop() {
+    for (;;) {
+        FrameBuffer *snapshot;
+        ready_snapshots.pop(snapshot);
+        if (!snapshot)
+            return;
+        // after a failure the remaining frames are dropped, the error is reported to the caller
+        if (!failed.load(std::memory_order_relaxed)) {
+            try {
+                snapshot->apply(shadow_frame, shadow_atoms);
+                shadow_frame->enable_bound = snapshot->enable_bound;
+                writer->write(shadow_frame, shadow_atoms);
+            } catch (...) {
+                write_exception = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        }
+        free_snapshots.push(snapshot);
+    }
+}
+
+void AsyncTrajectoryWriter::stop() {
+    if (write_thread.joinable()) {
+        ready_snapshots.push(nullptr);
+        write_thread.join();
+    }
+}
+
+void AsyncTrajectoryWriter::rethrow() {
+    // write_exception is never touched by the writer thread after failed is set
+    if (failed.load(std::memory_order_acquire) and write_exception) {
+        std::rethrow_exception(std::exchange(write_exception, nullptr));
+    }
+}
+
+void AsyncTrajectoryWriter::close() {
+    stop();
+    writer->close();
+    rethrow();
+}
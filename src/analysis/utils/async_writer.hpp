@@ -0,0 +1,54 @@
+#ifndef TINKER_ASYNC_WRITER_HPP
+#define TINKER_ASYNC_WRITER_HPP
+
+#include <atomic>
+#include <tbb/concurrent_queue.h>
+#include <thread>
+
+#include "TrajectoryFormatWriter.hpp"
+#include "trajectory_reader/FrameBuffer.hpp"
+
+/*
+ *  run another writer on a dedicated thread, write() only copies coordinates, box and time of the frame
+ *  into one of depth snapshots and returns, so encoding and disk IO overlap with the analysis loop.
+ *  close() waits until all queued frames are written
+ */
+class AsyncTrajectoryWriter : public TrajectoryFormatWriter {
+public:
+    AsyncTrajectoryWriter(std::shared_ptr<TrajectoryFormatWriter> writer, std::size_t depth);
+
+    void open(const std::string &filename) override;
+
+    void close() override;
+
+    using TrajectoryFormatWriter::write;
+
+    void write(const std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+
+    [[nodiscard]] const auto &getWriter() const { return writer; }
+
+    ~AsyncTrajectoryWriter() override;
+
+private:
+    void writeLoop();
+
+    void stop();
+
+    void rethrow();
+
+    std::shared_ptr<TrajectoryFormatWriter> writer;
+    std::size_t depth;
+
+    // copies of the frame and atoms the wrapped writer works on, owned by the writer thread once started
+    std::shared_ptr<Frame> shadow_frame;
+    std::vector<std::shared_ptr<Atom>> shadow_atoms;
+
+    std::vector<std::unique_ptr<FrameBuffer>> snapshots;
+    tbb::concurrent_bounded_queue<FrameBuffer *> free_snapshots;
+    tbb::concurrent_bounded_queue<FrameBuffer *> ready_snapshots; // nullptr asks writer thread to finish
+    std::atomic<bool> failed = false;
+    std::exception_ptr write_exception;
+    std::thread write_thread;
+};
+
+#endif // TINKER_ASYNC_WRITER_HPP
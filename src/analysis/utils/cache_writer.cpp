@@ -0,0 +1,28 @@
+#include "cache_writer.hpp"
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+
+void CacheWriter::open(const std::string &filename) { this->filename = filename; }
+
+void CacheWriter::write(const std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) {
+    // atom number is known from the first frame
+    if (!writer.is_open()) {
+        writer.open(filename, atoms.size());
+        buffer.reserve(atoms.size());
+    }
+    buffer.reset();
+    buffer.natoms = atoms.size();
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        buffer.x[3 * i] = atoms[i]->x;
+        buffer.x[3 * i + 1] = atoms[i]->y;
+        buffer.x[3 * i + 2] = atoms[i]->z;
+    }
+    if (frame->enable_bound) {
+        buffer.box = frame->box;
+    }
+    buffer.time = frame->getCurrentTime();
+    writer.write(buffer);
+}
+
+void CacheWriter::close() { writer.close(); }
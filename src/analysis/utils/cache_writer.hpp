@@ -0,0 +1,27 @@
+#ifndef TINKER_CACHE_WRITER_HPP
+#define TINKER_CACHE_WRITER_HPP
+
+#include <memory>
+#include <string>
+
+#include "TrajectoryFormatWriter.hpp"
+#include "trajectory_reader/TrajectoryCache.hpp"
+
+class Frame;
+
+class CacheWriter : public TrajectoryFormatWriter {
+    TrajectoryCacheWriter writer;
+    FrameBuffer buffer;
+    std::string filename;
+
+public:
+    void open(const std::string &filename) override;
+
+    void close() override;
+
+    using TrajectoryFormatWriter::write;
+
+    void write(const std::shared_ptr<Frame> &frame, const std::vector<std::shared_ptr<Atom>> &atoms) override;
+};
+
+#endif  // TINKER_CACHE_WRITER_HPP
@@ -17,6 +17,7 @@
 bool enable_read_velocity = false;
 bool enable_tbb = false;
 bool enable_outfile = false;
+std::size_t async_write_depth = 0;
 
 Forcefield forcefield;
 bool enable_forcefield = false;
@@ -79,7 +80,7 @@ FileType getFileType(const std::string &filename) {
         {".xtc", FileType::XTC},      {".trr", FileType::TRR},   {".nc", FileType::NC},   {".mdcrd", FileType::NC},
         {".xyz", FileType::ARC},      {".arc", FileType::ARC},   {".tpr", FileType::TPR}, {".prmtop", FileType::PRMTOP},
         {".parm7", FileType::PRMTOP}, {".mol2", FileType::MOL2}, {".prm", FileType::PRM}, {".gro", FileType::GRO},
-        {".traj", FileType::TRAJ},    {".json", FileType::JSON}};
+        {".traj", FileType::TRAJ},    {".json", FileType::JSON}, {".cache", FileType::CACHE}};
 
     auto it = mapping.find(extension);
     return it != mapping.end() ? it->second : FileType::UnKnown;
@@ -175,8 +176,20 @@ boost::program_options::options_description make_program_options() {
         "fchk", po::value<std::string>()->value_name("file-name"),
         "Gaussian Fchk File")("silent", po::bool_switch()->default_value(false), "Dont show the main menu")(
         "mask", po::value<std::string>()->value_name("mask"),
-        "specify for read traj")("config", po::value<std::string>()->value_name("config_filename"),
-                                 "configuration file name")("verbose,v", "show verbose message")("debug", "debug mode");
+        "specify for read traj")("prefetch", po::value<int>()->value_name("frames"),
+                                 "number of frames decoded ahead by a background reader thread")(
+        "parallel-decode", po::value<int>()->value_name("frames"),
+        "number of XTC frames decompressed at a time on the thread pool")(
+        "cache", po::bool_switch()->default_value(false),
+        "read trajectories from <trajectory>.cache, written by the first pass, and save frame indexes as "
+        "<trajectory>.idx and parsed topologies as <topology>.snapshot")(
+        "async-write", po::value<int>()->value_name("frames"),
+        "number of frames queued for every trajectory writer running on its own thread")(
+        "start", po::value<uint>()->value_name("frame"), "first frame written by fast trajectory convert")(
+        "end", po::value<uint>()->value_name("frame"), "last frame written by fast trajectory convert")(
+        "step", po::value<uint>()->value_name("frames"), "write every n-th frame in fast trajectory convert")(
+        "config", po::value<std::string>()->value_name("config_filename"), "configuration file name")(
+        "verbose,v", "show verbose message")("debug", "debug mode");
 
     return desc;
 }
@@ -212,6 +225,36 @@ std::string getPrmFilename(const boost::program_options::variables_map &vm) {
     return vm.count("prm") ? vm["prm"].as<std::string>() : choose_file("Tinker prm file :").isExist(true);
 }
 
+int getPrefetchDepth(const boost::program_options::variables_map &vm) {
+    auto prefetch = vm.count("prefetch") ? vm["prefetch"].as<int>() : program_configuration->get_prefetch();
+    if (prefetch < 0) {
+        throw std::runtime_error("prefetch frame number cannot less than zero");
+    }
+    return prefetch;
+}
+
+int getParallelDecode(const boost::program_options::variables_map &vm) {
+    auto frames = vm.count("parallel-decode") ? vm["parallel-decode"].as<int>()
+                                              : program_configuration->get_parallel_decode();
+    if (frames < 0) {
+        throw std::runtime_error("parallel decode frame number cannot less than zero");
+    }
+    return frames;
+}
+
+bool getCacheEnabled(const boost::program_options::variables_map &vm) {
+    return (vm.count("cache") and vm["cache"].as<bool>()) or program_configuration->get_cache();
+}
+
+int getAsyncWriteDepth(const boost::program_options::variables_map &vm) {
+    auto frames =
+        vm.count("async-write") ? vm["async-write"].as<int>() : program_configuration->get_async_write();
+    if (frames < 0) {
+        throw std::runtime_error("async write frame number cannot less than zero");
+    }
+    return frames;
+}
+
 std::size_t getDefaultVectorReserve() {
     auto p = std::getenv("ANALYSIS_VECTOR_RESERVE");
     return p ? std::stoi(p) : 100000;
@@ -51,6 +51,9 @@ extern bool enable_read_velocity;
 extern bool enable_tbb;
 extern bool enable_outfile;
 
+// frames queued for every trajectory writer running on its own thread, 0 for synchronous writers
+extern std::size_t async_write_depth;
+
 extern Forcefield forcefield;
 extern bool enable_forcefield;
 
@@ -69,7 +72,7 @@ class ProgramConfiguration;
 
 extern std::unique_ptr<ProgramConfiguration> program_configuration;
 
-enum class FileType { XTC, TRR, NC, ARC, TPR, PRMTOP, MOL2, PRM, GRO, TRAJ, JSON, UnKnown };
+enum class FileType { XTC, TRR, NC, ARC, TPR, PRMTOP, MOL2, PRM, GRO, TRAJ, JSON, CACHE, UnKnown };
 
 FileType getFileType(const std::string &filename);
 
@@ -604,6 +607,14 @@ std::string getTrajectoryFilename(const boost::program_options::variables_map &v
 
 std::string getPrmFilename(const boost::program_options::variables_map &vm);
 
+int getPrefetchDepth(const boost::program_options::variables_map &vm);
+
+int getParallelDecode(const boost::program_options::variables_map &vm);
+
+bool getCacheEnabled(const boost::program_options::variables_map &vm);
+
+int getAsyncWriteDepth(const boost::program_options::variables_map &vm);
+
 std::size_t getDefaultVectorReserve();
 
 struct join_type {
@@ -0,0 +1,17 @@
+#ifndef TINKER_PRECISION_HPP
+#define TINKER_PRECISION_HPP
+
+#include "config.h"
+
+/*
+ *  floating point type of coordinates gathered for per-frame kernels (AtomGroup::x/y/z) and of the distance
+ *  and histogram arithmetic on them. float doubles the SIMD width and halves the memory traffic, trajectories
+ *  (XTC) carry no more than single precision anyway. Accumulators and final results stay double
+ */
+#ifdef ENABLE_SINGLE_PRECISION
+using coord_real = float;
+#else
+using coord_real = double;
+#endif
+
+#endif // TINKER_PRECISION_HPP
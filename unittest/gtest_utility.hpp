@@ -7,6 +7,14 @@
 
 #include <gmock/gmock.h>
 
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+
 using namespace testing;
 
 
@@ -35,5 +43,58 @@ MATCHER_P2(DOUBLE_ARRAY_EQ, s2, n, "double array compare") {
     return array_eq_impl<double>(arg, s2, n);
 }
 
+/*
+ *  appends an atom with Atom::seq seq at (x, y, z) to frame, also registered in Frame::atom_map. Call
+ *  Frame::index_atoms once the frame is built, analyses expect the coordinate arrays and topology tables
+ */
+inline std::shared_ptr<Atom> add_atom(Frame &frame, std::size_t seq, double x = 0.0, double y = 0.0, double z = 0.0) {
+    auto atom = std::make_shared<Atom>();
+    atom->seq = seq;
+    std::tie(atom->x, atom->y, atom->z) = std::tuple(x, y, z);
+    frame.atom_list.push_back(atom);
+    frame.atom_map[atom->seq] = atom;
+    return atom;
+}
+
+/*
+ *  natoms water oxygens, a residue each, at random positions within [-range, range] along every axis, the same
+ *  positions for the same seed. Coordinate arrays and topology tables are built
+ */
+inline std::shared_ptr<Frame> make_random_frame(const PBCBox &box, bool enable_bound, std::size_t natoms,
+                                                double range, unsigned seed) {
+    auto frame = std::make_shared<Frame>();
+    frame->box = box;
+    frame->enable_bound = enable_bound;
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-range, range);
+    for (std::size_t i = 0; i < natoms; i++) {
+        const double x = dist(gen), y = dist(gen), z = dist(gen);
+        auto atom = add_atom(*frame, i + 1, x, y, z);
+        atom->atom_name = "O";
+        atom->residue_name = "WAT";
+        atom->residue_num = i + 1;
+    }
+    frame->index_atoms();
+    return frame;
+}
+
+// every atom moved randomly by at most step along each axis, written to the atoms and synced to the arrays
+inline void move_atoms_randomly(Frame &frame, double step, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-step, step);
+    for (auto &atom : frame.atom_list) {
+        atom->x += dist(gen);
+        atom->y += dist(gen);
+        atom->z += dist(gen);
+    }
+    frame.sync_atoms();
+}
+
+// offset, offset + step, ... below natoms
+inline std::vector<std::size_t> every(std::size_t step, std::size_t offset, std::size_t natoms) {
+    std::vector<std::size_t> indices;
+    for (std::size_t i = offset; i < natoms; i += step) indices.push_back(i);
+    return indices;
+}
 
 #endif //TINKER_GTEST_UTILITY_HPP
@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "dsl/AmberMaskIndex.hpp"
+#include "gtest_utility.hpp"
+
+using namespace std;
+using namespace testing;
+using namespace AmberMaskAST;
+
+namespace {
+
+// 4 water molecules followed by one residue of 6 atoms
+shared_ptr<Frame> make_frame() {
+    auto frame = make_shared<Frame>();
+    auto add_atom = [&frame](const string &name, const string &type, int typ, const string &symbol,
+                             const string &residue, uint residue_num, const shared_ptr<Molecule> &mol) {
+        auto atom = ::add_atom(*frame, frame->atom_list.size() + 1);
+        atom->atom_name = name;
+        atom->type_name = type;
+        atom->typ = typ;
+        atom->atom_symbol = symbol;
+        atom->residue_name = residue;
+        atom->residue_num = residue_num;
+        atom->real_residue_number = residue_num;
+        atom->molecule = mol;
+        mol->atom_list.push_back(atom);
+    };
+    for (uint i = 1; i <= 4; i++) {
+        auto mol = make_shared<Molecule>();
+        mol->sequence = i;
+        frame->molecule_list.push_back(mol);
+        add_atom("OW", "OW", 1, "O", "WAT", i, mol);
+        add_atom("HW1", "HW", 2, "H", "WAT", i, mol);
+        add_atom("HW2", "HW", 2, "H", "WAT", i, mol);
+    }
+    auto mol = make_shared<Molecule>();
+    mol->sequence = 5;
+    frame->molecule_list.push_back(mol);
+    add_atom("N", "N", 3, "N", "ASP", 12, mol);
+    add_atom("H", "H", 4, "H", "ASP", 12, mol);
+    add_atom("CA", "CT", 5, "C", "ASP", 12, mol);
+    add_atom("CB", "CT", 5, "C", "ASP", 12, mol);
+    add_atom("C", "C", 6, "C", "ASP", 12, mol);
+    add_atom("O", "O", 7, "O", "ASP", 12, mol);
+    return frame;
+}
+
+} // namespace
+
+TEST(AmberMaskIndex, SameAsIsMatch) {
+    auto frame = make_frame();
+    AmberMaskIndex index(frame);
+    for (const string mask_text :
+         {":WAT", ":ASP", ":1-3", ":1-4#2", ":1*", ":A*P", "@OW", "@H*", "@1,2-5#2,9", "@10-3#2", "@1*", "@%CT",
+          "@%1-3", "@/C", "@/H*", "$2", "$1-4#3", ":WAT & !@H*", ":ASP | @/O", "!(:WAT | @CA)", ":12 & @%CT"}) {
+        auto mask = parse_atoms(mask_text, true);
+        auto selection = index.evaluate(mask);
+        ASSERT_THAT(selection.size(), Eq(frame->atom_list.size()));
+        for (size_t i = 0; i < frame->atom_list.size(); i++) {
+            ASSERT_THAT(selection.test(i), Eq(is_match(frame->atom_list[i], mask))) << mask_text << " atom " << i + 1;
+        }
+    }
+}
+
+TEST(AmberMaskIndex, SelectIsCachedPerTopology) {
+    auto frame = make_frame();
+    auto mask = parse_atoms(":WAT & @OW", true);
+    auto selection = AmberMaskIndex::select(mask, frame);
+    ASSERT_THAT(selection->count(), Eq(4));
+    ASSERT_THAT(AmberMaskIndex::select(parse_atoms(":WAT & @OW", true), frame), Eq(selection));
+
+    auto other = make_frame();
+    other->atom_list.pop_back();
+    auto other_selection = AmberMaskIndex::select(mask, other);
+    ASSERT_THAT(other_selection, Ne(selection));
+    ASSERT_THAT(other_selection->size(), Eq(other->atom_list.size()));
+}
+
+TEST(AmberMaskIndex, SelectFollowsTopologyChanges) {
+    auto frame = make_frame();
+    frame->index_atoms();
+    auto mask = parse_atoms(":SOL", true);
+    ASSERT_THAT(AmberMaskIndex::select(mask, frame)->count(), Eq(0));
+
+    // renamed in place, like a force field assigns residue names to an indexed frame
+    for (size_t i = 0; i < 6; i++) frame->atom_list[i]->residue_name = "SOL";
+    frame->topology_changed();
+    auto selection = AmberMaskIndex::select(mask, frame);
+    ASSERT_THAT(selection->count(), Eq(6));
+    ASSERT_TRUE(selection->test(0) and selection->test(5) and !selection->test(6));
+    ASSERT_THAT(AmberMaskIndex::select(parse_atoms(":WAT", true), frame)->count(), Eq(6));
+}
+
+TEST(AmberMaskIndex, ResidueSelectionNeedsResidues) {
+    auto frame = make_frame();
+    frame->atom_list.front()->residue_name.reset();
+    AmberMaskIndex index(frame);
+    ASSERT_THROW(index.evaluate(parse_atoms(":WAT", true)), std::runtime_error);
+    ASSERT_THAT(index.evaluate(parse_atoms("@OW", true)).count(), Eq(4));
+}
@@ -0,0 +1,109 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/TrajectoryWriterFactoryImpl.hpp"
+#include "utils/async_writer.hpp"
+#include "utils/xtc_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+class RecordingWriter : public TrajectoryFormatWriter {
+public:
+    void open(const string &filename) override { opened = filename; }
+
+    void close() override { closed = true; }
+
+    void write(const shared_ptr<Frame> &frame, const vector<shared_ptr<Atom>> &atoms) override {
+        if (fail_at and frames.size() == fail_at.value()) {
+            throw runtime_error("disk full");
+        }
+        vector<double> x;
+        for (auto &atom : atoms) {
+            x.push_back(atom->x);
+        }
+        frames.push_back(x);
+        boxes.push_back(frame->box.getBoxParameter()[0]);
+        names.push_back(atoms.back()->atom_name);
+        writer_thread = this_thread::get_id();
+    }
+
+    string opened;
+    bool closed = false;
+    std::optional<size_t> fail_at;
+    vector<vector<double>> frames;
+    vector<double> boxes;
+    vector<string> names;
+    thread::id writer_thread;
+};
+
+shared_ptr<Frame> make_frame(int natoms) {
+    auto frame = make_shared<Frame>();
+    frame->enable_bound = true;
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1)->atom_name = "C" + to_string(i + 1);
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST(AsyncTrajectoryWriter, FramesWrittenInOrderOnWriterThread) {
+    auto recorder = make_shared<RecordingWriter>();
+    AsyncTrajectoryWriter writer(recorder, 2);
+    auto frame = make_frame(5);
+    vector<shared_ptr<Atom>> atoms(frame->atom_list.begin() + 1, frame->atom_list.end());
+
+    writer.open("out.xtc");
+    for (int n = 0; n < 20; n++) {
+        for (auto &atom : frame->atom_list) {
+            atom->x = n + atom->seq * 0.1;
+        }
+        frame->box = PBCBox(10.0 + n, 10.0, 10.0, 90.0, 90.0, 90.0);
+        writer.write(frame, atoms);
+    }
+    writer.close();
+
+    ASSERT_THAT(recorder->opened, Eq("out.xtc"));
+    ASSERT_TRUE(recorder->closed);
+    ASSERT_THAT(recorder->frames.size(), Eq(20));
+    for (int n = 0; n < 20; n++) {
+        ASSERT_THAT(recorder->frames[n], ElementsAre(DoubleEq(n + 0.2), DoubleEq(n + 0.3), DoubleEq(n + 0.4),
+                                                     DoubleEq(n + 0.5)));
+        ASSERT_THAT(recorder->boxes[n], DoubleEq(10.0 + n));
+        ASSERT_THAT(recorder->names[n], Eq("C5"));
+    }
+    ASSERT_THAT(recorder->writer_thread, Ne(this_thread::get_id()));
+}
+
+TEST(AsyncTrajectoryWriter, WriteErrorReportedToCaller) {
+    auto recorder = make_shared<RecordingWriter>();
+    recorder->fail_at = 3;
+    AsyncTrajectoryWriter writer(recorder, 1);
+    auto frame = make_frame(3);
+
+    writer.open("out.xtc");
+    ASSERT_THROW(
+        {
+            for (int n = 0; n < 10; n++) {
+                writer.write(frame);
+            }
+            writer.close();
+        },
+        runtime_error);
+    ASSERT_THAT(recorder->frames.size(), Eq(3));
+}
+
+TEST(AsyncTrajectoryWriter, FactoryWrapsWritersWhenEnabled) {
+    TrajectoryWriterFactoryImpl factory;
+    async_write_depth = 4;
+    auto writer = factory.make_instance(FileType::XTC);
+    async_write_depth = 0;
+    auto async_writer = dynamic_pointer_cast<AsyncTrajectoryWriter>(writer);
+    ASSERT_TRUE(async_writer);
+    ASSERT_TRUE(typeid(*async_writer->getWriter()) == typeid(XTCWriter));
+}
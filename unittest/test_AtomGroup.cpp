@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/atom_group.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "gtest_utility.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// two molecules of 2 atoms each and two atoms outside any molecule
+shared_ptr<Frame> make_frame() {
+    auto frame = make_shared<Frame>();
+    for (int i = 0; i < 6; i++) {
+        add_atom(*frame, i + 1, i, 2 * i, 3 * i);
+    }
+    for (int m = 0; m < 2; m++) {
+        auto mol = make_shared<Molecule>();
+        for (int i = 2 * m; i < 2 * m + 2; i++) {
+            mol->atom_list.push_back(frame->atom_list[i]);
+            frame->atom_list[i]->molecule = mol;
+        }
+        frame->molecule_list.push_back(mol);
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST(AtomGroup, CompileSortsAndAssignsMolecules) {
+    auto frame = make_frame();
+    AtomGroup group(frame, {frame->atom_list[4], frame->atom_list[2], frame->atom_list[0], frame->atom_list[3],
+                            frame->atom_list[2]});
+    ASSERT_TRUE(frame->has_coordinate_arrays());
+    ASSERT_THAT(group.indices(), ElementsAre(0, 2, 3, 4));
+    ASSERT_THAT(group.molecules()[0], Eq(0));
+    ASSERT_THAT(group.molecules()[1], Eq(1));
+    ASSERT_THAT(group.molecules()[2], Eq(1));
+    ASSERT_THAT(group.molecules()[3], AllOf(Ne(0), Ne(1)));
+    ASSERT_THAT(group.atom(1), Eq(frame->atom_list[2]));
+}
+
+TEST(AtomGroup, Exclusion) {
+    auto frame = make_frame();
+    AtomGroup group1(frame, {frame->atom_list[0], frame->atom_list[4]});
+    AtomGroup group2(frame, {frame->atom_list[0], frame->atom_list[1], frame->atom_list[2]});
+
+    ASSERT_TRUE(group1.excluded(0, group2, 0, true));  // same atom
+    ASSERT_TRUE(group1.excluded(0, group2, 1, false)); // same molecule
+    ASSERT_FALSE(group1.excluded(0, group2, 1, true));
+    ASSERT_FALSE(group1.excluded(0, group2, 2, false));
+    ASSERT_FALSE(group1.excluded(1, group2, 0, false));
+}
+
+TEST(AtomGroup, AtomsWithoutMoleculeCountAsOneMolecule) {
+    auto frame = make_frame();
+    AtomGroup group1(frame, {frame->atom_list[4]});
+    AtomGroup group2(frame, {frame->atom_list[5], frame->atom_list[0]});
+
+    ASSERT_THAT(group2.molecules()[1], Eq(group1.molecules()[0]));
+    ASSERT_TRUE(group1.excluded(0, group2, 1, false));
+    ASSERT_FALSE(group1.excluded(0, group2, 1, true));
+    ASSERT_FALSE(group1.excluded(0, group2, 0, false));
+}
+
+TEST(AtomGroup, GatherCoordinates) {
+    auto frame = make_frame();
+    AtomGroup group(frame, {frame->atom_list[1], frame->atom_list[3]});
+    frame->x[3] = 7.5;
+    group.gather(*frame);
+    ASSERT_THAT(group.x, ElementsAre(1, 7.5));
+    ASSERT_THAT(group.y, ElementsAre(2, 6));
+    ASSERT_THAT(group.z, ElementsAre(3, 9));
+}
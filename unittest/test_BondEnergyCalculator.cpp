@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/BondEnergyCalculator.hpp"
+#include "utils/common.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// a butane like chain of 4 atoms, atoms 1-2 in residue 1 and 3-4 in residue 2
+shared_ptr<Frame> make_frame() {
+    auto frame = make_shared<Frame>();
+    vector<array<double, 3>> coords{{0.0, 1.4, 0.0}, {0.1, 0.0, 0.0}, {1.5, -0.1, 0.2}, {1.7, -1.4, 1.1}};
+    for (size_t i = 0; i < coords.size(); i++) {
+        add_atom(*frame, i + 1, coords[i][0], coords[i][1], coords[i][2])->residue_num = i / 2 + 1;
+    }
+    auto &a = frame->atom_list;
+    frame->f_bond_params[{a[0], a[1]}] = {300.0, 1.5};
+    frame->f_bond_params[{a[1], a[2]}] = {310.0, 1.4};
+    frame->f_bond_params[{a[2], a[3]}] = {320.0, 1.6};
+    frame->f_angle_params[{a[0], a[1], a[2]}] = {50.0, 109.5};
+    frame->f_angle_params[{a[1], a[2], a[3]}] = {60.0, 112.0};
+    frame->f_dihedral_params.insert({{a[0], a[1], a[2], a[3]}, {0.0, 1.4, 3}});
+    frame->f_dihedral_params.insert({{a[0], a[1], a[2], a[3]}, {180.0, 0.2, 1}});
+    frame->f_improper_dihedral_params.insert({{a[1], a[0], a[2], a[3]}, {180.0, 1.1, 2}});
+    frame->index_atoms();
+    return frame;
+}
+
+// reference energies computed term by term from the topology maps
+BondEnergyCalculator::Term reference(const shared_ptr<Frame> &frame) {
+    BondEnergyCalculator::Term term{};
+    for (const auto &[atoms, param] : frame->f_bond_params) {
+        auto r = atom_distance(atoms, frame) - param.rA;
+        term.bond += 0.5 * param.krA * r * r;
+    }
+    for (const auto &[atoms, param] : frame->f_angle_params) {
+        auto theta = (atom_angle(atoms, frame) - param.rA) * degree;
+        term.angle += 0.5 * param.krA * theta * theta;
+    }
+    for (const auto &[atoms, param] : frame->f_dihedral_params) {
+        term.dihedral += param.cpA * (1 + std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree));
+    }
+    for (const auto &[atoms, param] : frame->f_improper_dihedral_params) {
+        term.improper += param.cpA * (1 + std::cos((atom_dihedral(atoms, frame) * param.mult - param.phiA) * degree));
+    }
+    return term;
+}
+
+} // namespace
+
+TEST(BondEnergyCalculator, TotalMatchesTopologyTerms) {
+    auto frame = make_frame();
+    BondEnergyCalculator calculator(frame->atom_list, frame);
+    auto term = calculator.energy(frame);
+    auto expected = reference(frame);
+    ASSERT_THAT(term.bond, DoubleNear(expected.bond, 1E-10));
+    ASSERT_THAT(term.angle, DoubleNear(expected.angle, 1E-10));
+    ASSERT_THAT(term.dihedral, DoubleNear(expected.dihedral, 1E-10));
+    ASSERT_THAT(term.improper, DoubleNear(expected.improper, 1E-10));
+}
+
+TEST(BondEnergyCalculator, ResidueDecompositionSumsToTotal) {
+    auto frame = make_frame();
+    BondEnergyCalculator calculator(frame->atom_list, frame);
+    auto total = calculator.energy(frame);
+    auto residues = calculator.energy_with_residue_rank(frame);
+    ASSERT_THAT(residues.size(), Eq(2));
+    BondEnergyCalculator::Term sum{};
+    for (const auto &[resid, term] : residues) {
+        sum.bond += term.bond;
+        sum.angle += term.angle;
+        sum.dihedral += term.dihedral;
+        sum.improper += term.improper;
+    }
+    ASSERT_THAT(sum.total(), DoubleNear(total.total(), 1E-10));
+
+    // bond 1-2 is entirely residue 1, bond 2-3 is shared
+    auto r12 = atom_distance(frame->atom_list[0], frame->atom_list[1], frame) - 1.5;
+    auto r23 = atom_distance(frame->atom_list[1], frame->atom_list[2], frame) - 1.4;
+    ASSERT_THAT(residues.at(1).bond, DoubleNear(0.5 * 300.0 * r12 * r12 + 0.25 * 310.0 * r23 * r23, 1E-10));
+}
+
+TEST(BondEnergyCalculator, SubsetOnlyKeepsInnerTerms) {
+    auto frame = make_frame();
+    BondEnergyCalculator calculator({frame->atom_list[0], frame->atom_list[1], frame->atom_list[2]}, frame);
+    auto term = calculator.energy(frame);
+    ASSERT_THAT(term.dihedral, DoubleEq(0.0));
+    ASSERT_THAT(term.improper, DoubleEq(0.0));
+    ASSERT_THAT(term.angle, Gt(0.0));
+}
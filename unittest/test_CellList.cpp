@@ -0,0 +1,101 @@
+#include <gmock/gmock.h>
+
+#include <map>
+#include <tuple>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/CellList.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// the nested loop the cell list replaces
+vector<tuple<uint32_t, uint32_t, double>> brute_force(const Frame &frame, const vector<size_t> &a,
+                                                      const vector<size_t> &b, double cutoff) {
+    vector<tuple<uint32_t, uint32_t, double>> pairs;
+    for (size_t i = 0; i < a.size(); i++) {
+        for (size_t j = 0; j < b.size(); j++) {
+            double dx = frame.x[b[j]] - frame.x[a[i]];
+            double dy = frame.y[b[j]] - frame.y[a[i]];
+            double dz = frame.z[b[j]] - frame.z[a[i]];
+            frame.image(dx, dy, dz);
+            double d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= cutoff * cutoff) pairs.emplace_back(i, j, d2);
+        }
+    }
+    return pairs;
+}
+
+void expect_same_pairs(const Frame &frame, const vector<size_t> &a, const vector<size_t> &b, double cutoff) {
+    BasicCellList<double> cell_list(cutoff);
+    const auto &pairs = cell_list.search(frame, a, b);
+    const auto expected = brute_force(frame, a, b, cutoff);
+    ASSERT_THAT(pairs.size(), Eq(expected.size()));
+    for (size_t n = 0; n < pairs.size(); n++) {
+        ASSERT_THAT(pairs[n].i, Eq(get<0>(expected[n])));
+        ASSERT_THAT(pairs[n].j, Eq(get<1>(expected[n])));
+        ASSERT_THAT(pairs[n].distance2, DoubleNear(get<2>(expected[n]), 1E-9));
+    }
+}
+
+class CellListTest : public TestWithParam<PBCBox> {};
+
+} // namespace
+
+TEST_P(CellListTest, MatchesBruteForce) {
+    // coordinates scattered beyond the cell, so binning has to wrap them
+    auto frame = make_random_frame(GetParam(), true, 3000, 40.0, 42);
+    expect_same_pairs(*frame, every(3, 0, 3000), every(2, 1, 3000), 3.5);
+    expect_same_pairs(*frame, every(1, 0, 3000), every(1, 0, 3000), 5.0);
+    // cutoff close to half the box, fewer than three cells along every vector
+    expect_same_pairs(*frame, every(5, 0, 3000), every(4, 0, 3000), 13.0);
+    // a sparse second set
+    expect_same_pairs(*frame, every(1, 0, 3000), {7, 1500}, 6.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Boxes, CellListTest,
+                         Values(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0),
+                                PBCBox(36.0, 36.0, 36.0, 70.528779, 109.471221, 70.528779),
+                                PBCBox(30.0, 35.0, 40.0, 80.0, 95.0, 105.0)));
+
+TEST(CellList, NonPeriodicMatchesBruteForce) {
+    auto frame = make_random_frame(PBCBox(), false, 2000, 20.0, 42);
+    expect_same_pairs(*frame, every(2, 0, 2000), every(3, 1, 2000), 4.0);
+    expect_same_pairs(*frame, every(1, 0, 2000), every(1, 0, 2000), 50.0);
+}
+
+TEST(CellList, EmptySetsGiveNoPairs) {
+    auto frame = make_random_frame(PBCBox(30.0, 30.0, 30.0, 90.0, 90.0, 90.0), true, 10, 15.0, 42);
+    CellList cell_list(5.0);
+    ASSERT_THAT(cell_list.search(*frame, vector<size_t>{}, every(1, 0, 10)), IsEmpty());
+    ASSERT_THAT(cell_list.search(*frame, every(1, 0, 10), vector<size_t>{}), IsEmpty());
+}
+
+TEST(CellList, RejectsNonPositiveCutoff) { ASSERT_THROW(CellList(0.0), std::runtime_error); }
+
+// only pairs at the cutoff may differ, coordinates rounded to float are off by 1E-6 relative
+TEST(CellList, SinglePrecisionMatchesDouble) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 80.0, 95.0, 105.0), true, 3000, 40.0, 42);
+    const auto a = every(2, 0, 3000);
+    const auto b = every(2, 1, 3000);
+    BasicCellList<float> single(5.0);
+    BasicCellList<double> dual(5.0);
+
+    map<pair<uint32_t, uint32_t>, double> expected;
+    for (const auto &pair : dual.search(*frame, a, b)) expected[{pair.i, pair.j}] = pair.distance2;
+    size_t missing = expected.size();
+    for (const auto &pair : single.search(*frame, a, b)) {
+        auto it = expected.find({pair.i, pair.j});
+        if (it == expected.end()) {
+            ASSERT_THAT(pair.distance2, DoubleNear(25.0, 1E-3));
+            continue;
+        }
+        ASSERT_THAT(pair.distance2, DoubleNear(it->second, 1E-3));
+        missing--;
+    }
+    ASSERT_THAT(missing, Le(expected.size() / 1000));
+}
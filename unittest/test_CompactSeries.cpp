@@ -0,0 +1,53 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <random>
+
+#include "utils/CompactSeries.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(CompactSeries, BitSeriesKeepsEveryBitAcrossWords) {
+    BitSeries bits;
+    for (size_t i = 0; i < 1000; i++) {
+        bits.push_back(i % 3 == 0 or i % 64 == 63);
+    }
+    ASSERT_THAT(bits.size(), Eq(1000));
+    for (size_t i = 0; i < bits.size(); i++) {
+        ASSERT_THAT(bits[i], Eq(i % 3 == 0 or i % 64 == 63)) << "bit " << i;
+    }
+}
+
+TEST(CompactSeries, ChunkedArrayIndexesAcrossChunks) {
+    ChunkedArray<int, 4> array;
+    for (int i = 0; i < 100; i++) {
+        array.push_back(i * i);
+    }
+    ASSERT_THAT(array.size(), Eq(100));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_THAT(array[i], Eq(i * i));
+    }
+    array.clear();
+    ASSERT_TRUE(array.empty());
+}
+
+// the angle between a unit vector and its packed form stays below 1E-4 rad all over the sphere
+TEST(CompactSeries, PackedUnitVectorKeepsDirection) {
+    mt19937 gen(20200);
+    normal_distribution<double> normal;
+    vector<tuple<double, double, double>> vectors{{1, 0, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (int i = 0; i < 100000; i++) {
+        double x = normal(gen), y = normal(gen), z = normal(gen);
+        double norm = std::sqrt(x * x + y * y + z * z);
+        vectors.emplace_back(x / norm, y / norm, z / norm);
+    }
+    for (const auto &vector : vectors) {
+        auto [x, y, z] = vector;
+        auto packed = PackedUnitVector(vector).unpack();
+        double cos = x * packed[0] + y * packed[1] + z * packed[2];
+        double sin = std::sqrt(std::pow(y * packed[2] - z * packed[1], 2) + std::pow(z * packed[0] - x * packed[2], 2) +
+                               std::pow(x * packed[1] - y * packed[0], 2));
+        ASSERT_THAT(std::atan2(sin, cos), Lt(1E-4)) << x << ' ' << y << ' ' << z;
+    }
+}
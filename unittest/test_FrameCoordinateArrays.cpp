@@ -0,0 +1,71 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/FrameBuffer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+shared_ptr<Frame> make_frame(int natoms) {
+    auto frame = make_shared<Frame>();
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1, i, 2 * i, 3 * i);
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST(FrameCoordinateArrays, IndexAtomsFillsArrays) {
+    auto frame = make_frame(4);
+    ASSERT_FALSE(frame->has_coordinate_arrays());
+    frame->index_atoms();
+    ASSERT_TRUE(frame->has_coordinate_arrays());
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_THAT(frame->atom_list[i]->index, Eq(i));
+    }
+    ASSERT_THAT(frame->x, ElementsAre(0, 1, 2, 3));
+    ASSERT_THAT(frame->y, ElementsAre(0, 2, 4, 6));
+    ASSERT_THAT(frame->z, ElementsAre(0, 3, 6, 9));
+}
+
+TEST(FrameCoordinateArrays, ApplyFillsArraysAndAtoms) {
+    auto frame = make_frame(5);
+    frame->index_atoms();
+    // only atoms 1, 3 and 4 are read
+    vector<shared_ptr<Atom>> atoms{frame->atom_list[1], frame->atom_list[3], frame->atom_list[4]};
+
+    FrameBuffer buffer;
+    buffer.reserve(atoms.size());
+    buffer.natoms = atoms.size();
+    buffer.x = {10, 11, 12, 30, 31, 32, 40, 41, 42};
+    buffer.apply(frame, atoms);
+
+    ASSERT_THAT(frame->x, ElementsAre(0, 10, 2, 30, 40));
+    ASSERT_THAT(frame->y, ElementsAre(0, 11, 4, 31, 41));
+    ASSERT_THAT(frame->z, ElementsAre(0, 12, 6, 32, 42));
+    ASSERT_THAT(frame->atom_list[3]->y, DoubleEq(31));
+    ASSERT_TRUE(frame->coordinate_arrays_in_sync());
+}
+
+TEST(FrameCoordinateArrays, SyncAtomAfterMove) {
+    auto frame = make_frame(3);
+    frame->index_atoms();
+    auto &atom = frame->atom_list[2];
+    atom->x += 100;
+    ASSERT_THAT(frame->x[2], DoubleEq(2));
+    ASSERT_FALSE(frame->coordinate_arrays_in_sync());
+    frame->sync_atom(*atom);
+    ASSERT_THAT(frame->x[2], DoubleEq(102));
+    ASSERT_TRUE(frame->coordinate_arrays_in_sync());
+
+    for (auto &a : frame->atom_list) {
+        a->z = -1;
+    }
+    frame->sync_atoms();
+    ASSERT_THAT(frame->z, Each(DoubleEq(-1)));
+}
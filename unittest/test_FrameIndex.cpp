@@ -0,0 +1,122 @@
+
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/FrameIndex.hpp"
+#include "utils/trr_writer.hpp"
+#include "utils/xtc_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+shared_ptr<Frame> make_frame(int natoms) {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(10.0, 20.0, 30.0, 90.0, 90.0, 90.0);
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1, 0.1 * i, 0.2 * i, 0.3 * i);
+    }
+    return frame;
+}
+
+template <typename Writer>
+void write_trajectory(const string &filename, int natoms, int nframes) {
+    auto frame = make_frame(natoms);
+    Writer writer;
+    writer.open(filename);
+    for (int i = 0; i < nframes; i++) {
+        writer.write(frame);
+    }
+    writer.close();
+}
+
+} // namespace
+
+TEST(FrameIndex, BuildXtcIndexAndReuseSidecar) {
+    const string filename = "frame_index_test.xtc";
+    write_trajectory<XTCWriter>(filename, 100, 5);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+
+    auto index = FrameIndex::load_or_build(filename, FileType::XTC, true);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_THAT(index->size(), Eq(5));
+    ASSERT_THAT(index->natoms(), Eq(100));
+    ASSERT_THAT((*index)[0].offset, Eq(0));
+    for (std::size_t i = 0; i < index->size(); i++) {
+        ASSERT_THAT((*index)[i].step, Eq(i));
+        ASSERT_THAT((*index)[i].time, FloatEq(i));
+        ASSERT_THAT((*index)[i].box[0], FloatNear(1.0, 1E-5));
+        ASSERT_THAT((*index)[i].box[4], FloatNear(2.0, 1E-5));
+        ASSERT_THAT((*index)[i].box[8], FloatNear(3.0, 1E-5));
+        if (i > 0) {
+            ASSERT_THAT((*index)[i].offset, Gt((*index)[i - 1].offset));
+        }
+    }
+    ASSERT_TRUE(boost::filesystem::exists(FrameIndex::index_filename(filename)));
+
+    auto reloaded = FrameIndex::load_or_build(filename, FileType::XTC);
+    ASSERT_TRUE(reloaded.has_value());
+    ASSERT_THAT(reloaded->size(), Eq(index->size()));
+    ASSERT_THAT((*reloaded)[4].offset, Eq((*index)[4].offset));
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}
+
+TEST(FrameIndex, SidecarIsWrittenOnlyOnRequest) {
+    const string filename = "frame_index_test.xtc";
+    write_trajectory<XTCWriter>(filename, 100, 3);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+
+    auto index = FrameIndex::load_or_build(filename, FileType::XTC);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_THAT(index->size(), Eq(3));
+    ASSERT_FALSE(boost::filesystem::exists(FrameIndex::index_filename(filename)));
+
+    boost::filesystem::remove(filename);
+}
+
+TEST(FrameIndex, TruncatedBoxEndsIndex) {
+    const string filename = "frame_index_test.xtc";
+    write_trajectory<XTCWriter>(filename, 100, 5);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+    auto complete = FrameIndex::load_or_build(filename, FileType::XTC);
+    ASSERT_THAT(complete->size(), Eq(5));
+
+    // the last frame stops after magic natoms step time and two box elements
+    boost::filesystem::resize_file(filename, (*complete)[4].offset + 6 * sizeof(float));
+    auto index = FrameIndex::load_or_build(filename, FileType::XTC);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_THAT(index->size(), Eq(4));
+    ASSERT_THAT(index->frame_size(3), Eq(complete->frame_size(3)));
+
+    boost::filesystem::remove(filename);
+}
+
+TEST(FrameIndex, BuildTrrIndex) {
+    const string filename = "frame_index_test.trr";
+    write_trajectory<TRRWriter>(filename, 3, 4);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+
+    auto index = FrameIndex::load_or_build(filename, FileType::TRR);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_THAT(index->size(), Eq(4));
+    ASSERT_THAT(index->natoms(), Eq(3));
+    auto frame_size = (*index)[1].offset - (*index)[0].offset;
+    for (std::size_t i = 0; i < index->size(); i++) {
+        ASSERT_THAT((*index)[i].offset, Eq(i * frame_size));
+        ASSERT_THAT((*index)[i].step, Eq(i));
+        ASSERT_THAT((*index)[i].box[0], FloatNear(1.0, 1E-5));
+    }
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}
+
+TEST(FrameIndex, UnsupportedFileType) {
+    ASSERT_FALSE(FrameIndex::load_or_build("tpr_test_system1.tpr", FileType::TPR).has_value());
+}
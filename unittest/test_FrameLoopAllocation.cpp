@@ -0,0 +1,141 @@
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "ana_module/CoordinateNumPerFrame.hpp"
+#include "ana_module/HBond.hpp"
+#include "ana_module/HBondSpread.hpp"
+#include "ana_module/KeyInteractionResidueFinder.hpp"
+#include "ana_module/RadicalDistribtuionFunction.hpp"
+#include "ana_module/SearchInteractionResidue.hpp"
+#include "ana_module/ShellDensity.hpp"
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "dsl/AmberMask.hpp"
+#include "gtest_utility.hpp"
+
+using namespace std;
+using namespace testing;
+using namespace AmberMaskAST;
+
+// every heap allocation of this test binary is counted
+namespace {
+std::atomic<std::size_t> allocations = 0;
+}
+
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (auto p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// 27 water molecules on a 3.1 Ang lattice in a periodic box
+shared_ptr<Frame> make_frame() {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(9.3, 9.3, 9.3, 90.0, 90.0, 90.0);
+    frame->enable_bound = true;
+    for (int i = 0; i < 27; i++) {
+        auto mol = make_shared<Molecule>();
+        mol->sequence = i + 1;
+        const double x = 3.1 * (i % 3), y = 3.1 * (i / 3 % 3), z = 3.1 * (i / 9);
+        vector<tuple<string, double, double, double, double>> atoms{
+            {"OW", 16.0, x, y, z}, {"HW1", 1.008, x + 0.96, y, z}, {"HW2", 1.008, x - 0.24, y + 0.93, z}};
+        const size_t first = frame->atom_list.size() + 1;
+        for (const auto &[name, mass, ax, ay, az] : atoms) {
+            auto atom = add_atom(*frame, frame->atom_list.size() + 1, ax, ay, az);
+            atom->atom_name = name;
+            atom->mass = mass;
+            atom->residue_name = "WAT";
+            atom->residue_num = i + 1;
+            atom->molecule = mol;
+            mol->atom_list.push_back(atom);
+        }
+        frame->atom_map[first]->con_list = {first + 1, first + 2};
+        frame->atom_map[first + 1]->con_list = {first};
+        frame->atom_map[first + 2]->con_list = {first};
+        frame->molecule_list.push_back(mol);
+    }
+    frame->index_atoms();
+    return frame;
+}
+
+// the next frame of a trajectory, every atom moved a bit
+void move_atoms(const shared_ptr<Frame> &frame, int step) {
+    for (size_t i = 0; i < frame->atom_list.size(); i++) {
+        auto &atom = frame->atom_list[i];
+        atom->x += 0.01 * ((i + step) % 5) - 0.02;
+        atom->y += 0.01 * ((i * 3 + step) % 5) - 0.02;
+        frame->sync_atom(*atom);
+    }
+    frame->coordinates_changed();
+}
+
+// heap allocations of task over frames after the first two, the task knows the number of frames ahead
+size_t steady_state_allocations(const shared_ptr<AbstractAnalysis> &task, int frames) {
+    auto frame = make_frame();
+    task->processFirstFrame(frame);
+    task->reserve_frames(frames);
+    task->process(frame);
+    move_atoms(frame, 1);
+    task->process(frame);
+
+    const auto before = allocations.load();
+    for (int step = 2; step < frames; step++) {
+        move_atoms(frame, step);
+        task->process(frame);
+    }
+    return allocations.load() - before;
+}
+
+} // namespace
+
+TEST(FrameLoopAllocation, CounterSeesAllocations) {
+    const auto before = allocations.load();
+    auto p = make_unique<int>(1);
+    ASSERT_THAT(allocations.load() - before, Eq(1));
+}
+
+TEST(FrameLoopAllocation, HistogramModulesDoNotAllocate) {
+    auto rdf = make_shared<RadicalDistribtuionFunction>();
+    rdf->setParameters(parse_atoms("@OW", true), parse_atoms("@OW", true), 4.5, 0.05, false, "rdf.xvg");
+    ASSERT_THAT(steady_state_allocations(rdf, 64), Eq(0));
+
+    auto shell = make_shared<ShellDensity>();
+    shell->setParameters(parse_atoms("@OW", true), parse_atoms("@HW1,HW2", true), 4.5, 0.05, "shell.xvg");
+    ASSERT_THAT(steady_state_allocations(shell, 64), Eq(0));
+}
+
+// modules keeping a value per frame size their histories by reserve_frames
+TEST(FrameLoopAllocation, HistoryModulesDoNotAllocate) {
+    const int frames = 256;
+
+    auto hbond = make_shared<HBond>();
+    hbond->setParameters(parse_atoms(":WAT", true), parse_atoms(":WAT", true), 3.5, 30.0, "vmd", "hbond.dat");
+    ASSERT_THAT(steady_state_allocations(hbond, frames), Eq(0));
+
+    auto cn = make_shared<CoordinateNumPerFrame>();
+    cn->setParameters(parse_atoms("@OW", true), parse_atoms("@OW", true), 3.5, "cn.dat");
+    ASSERT_THAT(steady_state_allocations(cn, frames), Eq(0));
+
+    auto spread = make_shared<HBondSpread>();
+    spread->setParameters(parse_atoms("@2", true), parse_atoms("@OW", true), 3.5, 30.0, 4.5, "spread.dat");
+    ASSERT_THAT(steady_state_allocations(spread, frames), Eq(0));
+
+    auto key_residues = make_shared<KeyInteractionResidueFinder>();
+    key_residues->setParameters(parse_atoms("@OW", true), parse_atoms("@HW1", true), 3.5, "key.dat");
+    ASSERT_THAT(steady_state_allocations(key_residues, frames), Eq(0));
+
+    auto interaction = make_shared<SearchInteractionResidue>();
+    interaction->setParameters(parse_atoms("@OW", true), parse_atoms("@OW", true), 3.5, false, "interaction.dat");
+    ASSERT_THAT(steady_state_allocations(interaction, frames), Eq(0));
+}
@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/Geometry.hpp"
+#include "utils/common.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+template <size_t N> vector<array<size_t, N>> random_tuples(size_t natoms, size_t count) {
+    mt19937 gen(7);
+    uniform_int_distribution<size_t> dist(0, natoms - 1);
+    vector<array<size_t, N>> tuples(count);
+    for (auto &tuple : tuples) {
+        for (auto &index : tuple) {
+            index = dist(gen);
+        }
+        // distinct atoms, so no angle is undefined
+        for (size_t i = 1; i < N; i++) {
+            tuple[i] = (tuple[0] + i * 97) % natoms;
+        }
+    }
+    return tuples;
+}
+
+class GeometryTest : public TestWithParam<PBCBox> {};
+
+} // namespace
+
+TEST_P(GeometryTest, BatchMatchesScalar) {
+    auto frame = make_random_frame(GetParam(), true, 1000, 40.0, 42);
+    const auto &atoms = frame->atom_list;
+
+    auto pairs = random_tuples<2>(atoms.size(), 3000);
+    vector<double> distances(pairs.size()), distances2(pairs.size());
+    atom_distances(*frame, pairs, distances);
+    atom_distances2(*frame, pairs, distances2);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        const auto &[a, b] = pairs[i];
+        ASSERT_THAT(distances[i], DoubleNear(atom_distance(atoms[a], atoms[b], frame), 1E-9));
+        ASSERT_THAT(distances2[i], DoubleNear(atom_distance2(atoms[a], atoms[b], frame), 1E-9));
+    }
+
+    auto triplets = random_tuples<3>(atoms.size(), 3000);
+    vector<double> angles(triplets.size());
+    atom_angles(*frame, triplets, angles);
+    for (size_t i = 0; i < triplets.size(); i++) {
+        const auto &[a, b, c] = triplets[i];
+        ASSERT_THAT(angles[i], DoubleNear(atom_angle(atoms[a], atoms[b], atoms[c], frame), 1E-6));
+    }
+
+    auto quadruplets = random_tuples<4>(atoms.size(), 3000);
+    vector<double> dihedrals(quadruplets.size());
+    atom_dihedrals(*frame, quadruplets, dihedrals);
+    for (size_t i = 0; i < quadruplets.size(); i++) {
+        const auto &[a, b, c, d] = quadruplets[i];
+        ASSERT_THAT(dihedrals[i], DoubleNear(atom_dihedral(atoms[a], atoms[b], atoms[c], atoms[d], frame), 1E-6));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Boxes, GeometryTest,
+                         Values(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0),
+                                PBCBox(36.0, 36.0, 36.0, 70.528779, 109.471221, 70.528779),
+                                PBCBox(30.0, 35.0, 40.0, 80.0, 95.0, 105.0)));
+
+// microbenchmark, run with --gtest_also_run_disabled_tests
+TEST(Geometry, DISABLED_ThroughputAgainstScalar) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 10000, 40.0, 42);
+    const auto &atoms = frame->atom_list;
+    auto pairs = random_tuples<2>(atoms.size(), 1000000);
+    auto triplets = random_tuples<3>(atoms.size(), 1000000);
+    vector<double> out(pairs.size());
+
+    auto rate = [](size_t count, auto body) {
+        auto t1 = chrono::steady_clock::now();
+        body();
+        chrono::duration<double> seconds = chrono::steady_clock::now() - t1;
+        return count / seconds.count() / 1E6;
+    };
+
+    auto scalar_distance = rate(pairs.size(), [&] {
+        for (size_t i = 0; i < pairs.size(); i++) {
+            out[i] = atom_distance(atoms[pairs[i][0]], atoms[pairs[i][1]], frame);
+        }
+    });
+    auto batch_distance = rate(pairs.size(), [&] { atom_distances(*frame, pairs, out); });
+    auto scalar_angle = rate(triplets.size(), [&] {
+        for (size_t i = 0; i < triplets.size(); i++) {
+            out[i] = atom_angle(atoms[triplets[i][0]], atoms[triplets[i][1]], atoms[triplets[i][2]], frame);
+        }
+    });
+    auto batch_angle = rate(triplets.size(), [&] { atom_angles(*frame, triplets, out); });
+
+    cout << "distance (M/s) scalar " << scalar_distance << "  batch " << batch_distance << '\n';
+    cout << "angle    (M/s) scalar " << scalar_angle << "  batch " << batch_angle << '\n';
+    ASSERT_THAT(batch_distance, Gt(scalar_distance));
+}
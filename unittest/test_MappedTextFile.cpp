@@ -0,0 +1,74 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "trajectory_reader/ArcTrajectoryReader.hpp"
+#include "trajectory_reader/MappedTextFile.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(MappedTextFile, ScanLinesAndFields) {
+    const string filename = "mapped_text_file_test.txt";
+    {
+        ofstream os(filename, ios::binary);
+        os << "  first line\r\n"
+           << "1  C   -1.25  +2.5E+01  3.0D-02\n"
+           << "\n"
+           << "last";
+    }
+    MappedTextFile file;
+    ASSERT_TRUE(file.open(filename));
+    ASSERT_THAT(string(file.getline()), Eq("  first line"));
+
+    auto line = file.getline();
+    ASSERT_THAT(MappedTextFile::to_int(MappedTextFile::next_field(line)), Eq(1));
+    ASSERT_THAT(string(MappedTextFile::next_field(line)), Eq("C"));
+    ASSERT_THAT(MappedTextFile::to_double(MappedTextFile::next_field(line)), DoubleEq(-1.25));
+    ASSERT_THAT(MappedTextFile::to_double(MappedTextFile::next_field(line)), DoubleEq(25.0));
+    ASSERT_THAT(MappedTextFile::to_double(MappedTextFile::next_field(line)), DoubleEq(std::stod("3.0E-02")));
+    ASSERT_TRUE(MappedTextFile::next_field(line).empty());
+
+    ASSERT_TRUE(file.getline().empty());
+    ASSERT_FALSE(file.eof());
+    ASSERT_THAT(string(file.getline()), Eq("last"));
+    ASSERT_TRUE(file.eof());
+    ASSERT_TRUE(file.getline().empty());
+    file.close();
+
+    ASSERT_THROW(MappedTextFile::to_double("C"), std::invalid_argument);
+    ASSERT_THROW(MappedTextFile::to_int(""), std::invalid_argument);
+    ASSERT_THAT(string(MappedTextFile::trim("  1.000 \t")), Eq("1.000"));
+
+    boost::filesystem::remove(filename);
+}
+
+TEST(MappedTextFile, ReadArcFrames) {
+    const string filename = "mapped_text_file_test.arc";
+    {
+        ofstream os(filename);
+        for (int n = 0; n < 2; n++) {
+            os << "     2  water\n"
+               << "    20.000000   20.000000   20.000000   90.000000   90.000000   90.000000\n"
+               << "     1  O      " << n << ".500000    0.250000   -1.000000   349     2\n"
+               << "     2  H      1.000000   -2.000000    3.000000   350     1\n";
+        }
+    }
+    ArcTrajectoryReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(2);
+
+    for (int n = 0; n < 2; n++) {
+        ASSERT_TRUE(reader.readOneFrame(buffer));
+        ASSERT_THAT(buffer.natoms, Eq(2));
+        ASSERT_THAT(buffer.x, ElementsAre(n + 0.5, 0.25, -1.0, 1.0, -2.0, 3.0));
+        ASSERT_TRUE(buffer.box.has_value());
+        ASSERT_THAT(buffer.box->getBoxParameter()[0], DoubleEq(20.0));
+    }
+    ASSERT_FALSE(reader.readOneFrame(buffer));
+    reader.close();
+
+    boost::filesystem::remove(filename);
+}
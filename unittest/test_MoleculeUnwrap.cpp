@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "gtest_utility.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// chain 1-2-3 with a branch 2-4, split over the x boundary of the box
+shared_ptr<Frame> make_frame(const PBCBox &box) {
+    auto frame = make_shared<Frame>();
+    frame->box = box;
+    frame->enable_bound = true;
+    auto mol = make_shared<Molecule>();
+    mol->sequence = 1;
+    vector<array<double, 3>> coords{{9.5, 5, 5}, {0.4, 5, 5}, {1.3, 5, 5}, {0.4, 6, 5}};
+    vector<list<size_t>> bonds{{2}, {1, 3, 4}, {2}, {2}};
+    for (size_t i = 0; i < coords.size(); i++) {
+        auto atom = add_atom(*frame, i + 1, coords[i][0], coords[i][1], coords[i][2]);
+        atom->con_list = bonds[i];
+        atom->mass = 1.0 + i;
+        atom->molecule = mol;
+        mol->atom_list.push_back(atom);
+    }
+    frame->molecule_list.push_back(mol);
+    frame->build_graph();
+    return frame;
+}
+
+} // namespace
+
+TEST(MoleculeUnwrap, PlanIsSpanningTree) {
+    auto frame = make_frame(PBCBox(10.0, 10.0, 10.0, 90.0, 90.0, 90.0));
+    auto &mol = frame->molecule_list.front();
+    ASSERT_THAT(mol->unwrap_atoms.size(), Eq(4));
+    ASSERT_THAT(mol->unwrap_atoms.front(), Eq(mol->atom_list.front()));
+    ASSERT_THAT(mol->unwrap_plan.size(), Eq(3));
+    for (size_t i = 0; i < mol->unwrap_plan.size(); i++) {
+        ASSERT_THAT(mol->unwrap_plan[i].first, Lt(mol->unwrap_plan[i].second));
+        ASSERT_THAT(mol->unwrap_plan[i].second, Eq(i + 1));
+    }
+}
+
+TEST(MoleculeUnwrap, CentersOrthogonal) {
+    auto frame = make_frame(PBCBox(10.0, 10.0, 10.0, 90.0, 90.0, 90.0));
+    auto &mol = frame->molecule_list.front();
+    auto [x, y, z] = mol->calc_geom_center(frame);
+    ASSERT_THAT(x, DoubleNear((9.5 + 10.4 + 11.3 + 10.4) / 4, 1E-10));
+    ASSERT_THAT(y, DoubleNear(5.25, 1E-10));
+    ASSERT_THAT(z, DoubleNear(5.0, 1E-10));
+
+    auto [wx, wy, wz] = mol->calc_weigh_center(frame);
+    ASSERT_THAT(wx, DoubleNear((9.5 + 2 * 10.4 + 3 * 11.3 + 4 * 10.4) / 10, 1E-10));
+}
+
+TEST(MoleculeUnwrap, AggregateTriclinic) {
+    auto frame = make_frame(PBCBox(10.0, 10.0, 10.0, 90.0, 90.0, 60.0));
+    auto &mol = frame->molecule_list.front();
+    frame->index_atoms();
+    mol->do_aggregate(frame);
+    auto first = mol->atom_list.front();
+    for (auto &atom : mol->atom_list) {
+        if (atom == first) continue;
+        auto r = atom->getCoordinate() - first->getCoordinate();
+        auto imaged = r;
+        frame->image(imaged);
+        ASSERT_THAT(get<0>(r), DoubleNear(get<0>(imaged), 1E-8));
+        ASSERT_THAT(get<1>(r), DoubleNear(get<1>(imaged), 1E-8));
+        ASSERT_THAT(frame->x[atom->index], DoubleEq(atom->x));
+    }
+}
+
+TEST(MoleculeUnwrap, PropertiesMemoizedPerFrameVersion) {
+    auto frame = make_frame(PBCBox(10.0, 10.0, 10.0, 90.0, 90.0, 90.0));
+    auto &mol = frame->molecule_list.front();
+    auto center = mol->calc_geom_center(frame);
+    auto version = frame->coordinate_version();
+
+    // the same version gives the cached center
+    ASSERT_THAT(mol->calc_geom_center(frame), Eq(center));
+    ASSERT_THAT(frame->coordinate_version(), Eq(version));
+
+    // a coordinate write followed by sync renews the version and the center is computed again
+    mol->atom_list.front()->y += 4;
+    frame->sync_atoms();
+    ASSERT_THAT(frame->coordinate_version(), Ne(version));
+    ASSERT_THAT(get<1>(mol->calc_geom_center(frame)), DoubleNear(get<1>(center) + 1.0, 1E-10));
+
+    // the same after moving one atom
+    version = frame->coordinate_version();
+    mol->atom_list.front()->y -= 4;
+    frame->sync_atom(*mol->atom_list.front());
+    frame->coordinates_changed();
+    ASSERT_THAT(frame->coordinate_version(), Ne(version));
+    ASSERT_THAT(get<1>(mol->calc_geom_center(frame)), DoubleNear(get<1>(center), 1E-10));
+
+    auto other = make_frame(PBCBox(10.0, 10.0, 10.0, 90.0, 90.0, 90.0));
+    ASSERT_THAT(other->coordinate_version(), Ne(frame->coordinate_version()));
+}
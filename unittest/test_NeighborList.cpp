@@ -0,0 +1,108 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/NeighborList.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+void expect_same_as_cell_list(NeighborList &list, const Frame &frame, const vector<size_t> &a,
+                              const vector<size_t> &b) {
+    CellList cell_list(list.cutoff());
+    const auto &expected = cell_list.search(frame, a, b);
+    const auto &pairs = list.search(frame);
+    ASSERT_THAT(pairs.size(), Eq(expected.size()));
+    for (size_t n = 0; n < pairs.size(); n++) {
+        ASSERT_THAT(pairs[n].i, Eq(expected[n].i));
+        ASSERT_THAT(pairs[n].j, Eq(expected[n].j));
+        ASSERT_THAT(pairs[n].distance2, DoubleNear(expected[n].distance2, 1E-9));
+    }
+}
+
+} // namespace
+
+TEST(NeighborList, SmallMovesReuseCandidates) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 2000, 20.0, 7);
+    const auto a = every(2, 0, 2000);
+    const auto b = every(2, 1, 2000);
+    NeighborList list(a, b, 3.5, 1.0);
+    expect_same_as_cell_list(list, *frame, a, b);
+    for (unsigned n = 0; n < 5; n++) {
+        // 0.05 Ang per axis, far below half the skin even after five frames
+        move_atoms_randomly(*frame, 0.05, n);
+        expect_same_as_cell_list(list, *frame, a, b);
+    }
+    ASSERT_THAT(list.rebuild_count(), Eq(1));
+}
+
+TEST(NeighborList, LargeMovesRebuild) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 2000, 20.0, 7);
+    const auto a = every(1, 0, 2000);
+    NeighborList list(a, a, 4.0, 1.0);
+    expect_same_as_cell_list(list, *frame, a, a);
+    move_atoms_randomly(*frame, 2.0, 1);
+    expect_same_as_cell_list(list, *frame, a, a);
+    ASSERT_THAT(list.rebuild_count(), Eq(2));
+}
+
+TEST(NeighborList, LargeBoxChangeRebuilds) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 1000, 20.0, 7);
+    const auto a = every(3, 0, 1000);
+    const auto b = every(1, 0, 1000);
+    NeighborList list(a, b, 5.0, 1.0);
+    expect_same_as_cell_list(list, *frame, a, b);
+    // the atoms stay while the box grows, far off the deformed old positions
+    frame->box = PBCBox(31.0, 35.0, 40.0, 90.0, 90.0, 90.0);
+    frame->coordinates_changed();
+    expect_same_as_cell_list(list, *frame, a, b);
+    ASSERT_THAT(list.rebuild_count(), Eq(2));
+}
+
+TEST(NeighborList, SlowlyScalingBoxReusesCandidates) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 2000, 20.0, 7);
+    const auto a = every(2, 0, 2000);
+    const auto b = every(2, 1, 2000);
+    NeighborList list(a, b, 3.5, 1.0);
+    expect_same_as_cell_list(list, *frame, a, b);
+    double scale = 1.0;
+    for (unsigned n = 0; n < 5; n++) {
+        // a barostat step, box and coordinates scaled by 0.2 %, then the atoms move a bit
+        const double factor = 1.002;
+        scale *= factor;
+        frame->box = PBCBox(30.0 * scale, 35.0 * scale, 40.0 * scale, 90.0, 90.0, 90.0);
+        for (auto &atom : frame->atom_list) {
+            atom->x *= factor;
+            atom->y *= factor;
+            atom->z *= factor;
+        }
+        move_atoms_randomly(*frame, 0.02, n);
+        expect_same_as_cell_list(list, *frame, a, b);
+    }
+    ASSERT_THAT(list.rebuild_count(), Eq(1));
+}
+
+TEST(NeighborList, SameFrameIsFilteredOnce) {
+    auto frame = make_random_frame(PBCBox(30.0, 35.0, 40.0, 90.0, 90.0, 90.0), true, 500, 15.0, 7);
+    NeighborList list(every(1, 0, 500), every(1, 0, 500), 3.0, 1.0);
+    const auto *first = &list.search(*frame);
+    ASSERT_THAT(&list.search(*frame), Eq(first));
+    ASSERT_THAT(list.rebuild_count(), Eq(1));
+}
+
+TEST(NeighborList, SharedBySameSetsAndCutoff) {
+    const auto a = every(2, 0, 100);
+    const auto b = every(2, 1, 100);
+    auto list1 = NeighborList::shared(a, b, 3.5);
+    auto list2 = NeighborList::shared(a, b, 3.5);
+    ASSERT_THAT(list1, Eq(list2));
+    ASSERT_THAT(NeighborList::shared(a, b, 4.0), Ne(list1));
+    ASSERT_THAT(NeighborList::shared(b, a, 3.5), Ne(list1));
+}
+
+TEST(NeighborList, RejectsNonPositiveCutoff) {
+    ASSERT_THROW(NeighborList({0}, {1}, 0.0), std::runtime_error);
+}
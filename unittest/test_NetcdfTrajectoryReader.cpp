@@ -0,0 +1,84 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/NetcdfTrajectoryReader.hpp"
+#include "utils/netcdf_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// atom i of frame n is at (n, i, -i)
+void write_numbered_atoms(const string &filename, int natoms, int nframes) {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(30.0, 40.0, 50.0, 90.0, 90.0, 90.0);
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1, 0.0, i, -i);
+    }
+    NetCDFWriter writer;
+    writer.open(filename);
+    for (int n = 0; n < nframes; n++) {
+        for (auto &atom : frame->atom_list) {
+            atom->x = n;
+        }
+        writer.write(frame);
+    }
+    writer.close();
+}
+
+} // namespace
+
+TEST(NetcdfTrajectoryReader, ReadSubsetWithStride) {
+    const string filename = "netcdf_reader_test.nc";
+    write_numbered_atoms(filename, 20, 30);
+
+    NetcdfTrajectoryReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(20);
+    buffer.subset = {1, 2, 3, 7, 9, 11, 19};
+
+    vector<int> frames;
+    while (reader.readOneFrame(buffer)) {
+        frames.push_back(static_cast<int>(buffer.x[3 * 1]));
+        for (auto i : buffer.subset) {
+            ASSERT_THAT(buffer.x[3 * i], DoubleEq(frames.back()));
+            ASSERT_THAT(buffer.x[3 * i + 1], DoubleEq(i));
+            ASSERT_THAT(buffer.x[3 * i + 2], DoubleEq(-static_cast<double>(i)));
+        }
+        ASSERT_TRUE(buffer.box.has_value());
+        ASSERT_THAT(buffer.box->getBoxParameter()[1], DoubleNear(40.0, 1E-5));
+        reader.skipFrames(frames.size() < 3 ? 0 : 6, buffer);
+    }
+    reader.close();
+    ASSERT_THAT(frames, ElementsAre(0, 1, 2, 9, 16, 23));
+
+    boost::filesystem::remove(filename);
+}
+
+TEST(NetcdfTrajectoryReader, ReadFirstAtomsOnly) {
+    const string filename = "netcdf_reader_prefix_test.nc";
+    write_numbered_atoms(filename, 20, 3);
+
+    NetcdfTrajectoryReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    FrameBuffer buffer;
+    buffer.reserve(5);
+
+    int nframes = 0;
+    while (reader.readOneFrame(buffer)) {
+        ASSERT_THAT(buffer.natoms, Eq(5));
+        ASSERT_THAT(buffer.x[3 * 4 + 1], DoubleEq(4));
+        ASSERT_THAT(buffer.x[3 * 4], DoubleEq(nframes));
+        nframes++;
+    }
+    reader.close();
+    ASSERT_THAT(nframes, Eq(3));
+
+    boost::filesystem::remove(filename);
+}
@@ -1,6 +1,8 @@
 
 #include "utils/std.hpp"
 #include <gmock/gmock.h>
+#include <limits>
+#include <random>
 #include "utils/PBCBox.hpp"
 
 using namespace testing;
@@ -81,3 +83,72 @@ TEST(PBCBoxTest, octahedron) {
     ASSERT_THAT(box[2][1], FloatNear(7.63396e+00, 1E-3));
     ASSERT_THAT(box[2][2], FloatNear(1.32224e+01, 1E-3));
 }
+
+namespace {
+
+// shortest |r + i*a + j*b + k*c| over a wide range of lattice shifts
+double brute_force_image_length(const PBCBox &pbc_box, double xr, double yr, double zr) {
+    gmx::matrix box;
+    pbc_box.getBoxParameter(box);
+    double best = std::numeric_limits<double>::max();
+    for (int i = -10; i <= 10; ++i) {
+        for (int j = -10; j <= 10; ++j) {
+            for (int k = -10; k <= 10; ++k) {
+                double x = xr + 10 * (i * box[0][0] + j * box[1][0] + k * box[2][0]);
+                double y = yr + 10 * (i * box[0][1] + j * box[1][1] + k * box[2][1]);
+                double z = zr + 10 * (i * box[0][2] + j * box[1][2] + k * box[2][2]);
+                best = std::min(best, std::sqrt(x * x + y * y + z * z));
+            }
+        }
+    }
+    return best;
+}
+
+void expect_minimum_image(const PBCBox &pbc_box) {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-250.0, 250.0);
+    for (int n = 0; n < 2000; ++n) {
+        double xr = dist(gen), yr = dist(gen), zr = dist(gen);
+        const double expect = brute_force_image_length(pbc_box, xr, yr, zr);
+        pbc_box.image(xr, yr, zr);
+        ASSERT_THAT(std::sqrt(xr * xr + yr * yr + zr * zr), DoubleNear(expect, 1E-4));
+    }
+}
+
+} // namespace
+
+TEST(PBCBoxTest, image_orthogonal) { expect_minimum_image(PBCBox(30.0, 40.0, 50.0, 90.0, 90.0, 90.0)); }
+
+TEST(PBCBoxTest, image_octahedron) {
+    expect_minimum_image(PBCBox(61.940994, 61.940582, 61.940704, 70.528800, 109.471246, 70.528738));
+}
+
+TEST(PBCBoxTest, image_triclinic) { expect_minimum_image(PBCBox(40.0, 45.0, 50.0, 80.0, 95.0, 105.0)); }
+
+TEST(PBCBoxTest, image_span_matches_single) {
+    PBCBox pbc_box(61.940994, 61.940582, 61.940704, 70.528800, 109.471246, 70.528738);
+    std::vector<double> xs{70.0, -3.0, 31.0}, ys{-40.0, 90.0, 31.0}, zs{12.0, -100.0, 31.0};
+    auto expect_x = xs, expect_y = ys, expect_z = zs;
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        pbc_box.image(expect_x[i], expect_y[i], expect_z[i]);
+    }
+    pbc_box.image(xs, ys, zs);
+    ASSERT_THAT(xs, Pointwise(DoubleEq(), expect_x));
+    ASSERT_THAT(ys, Pointwise(DoubleEq(), expect_y));
+    ASSERT_THAT(zs, Pointwise(DoubleEq(), expect_z));
+}
+
+// the box of the previous frame is reused, a different box is not
+TEST(PBCBoxTest, repeated_box_reuses_lattice) {
+    gmx::matrix box{{3.0, 0.0, 0.0}, {0.0, 3.0, 0.0}, {0.0, 0.0, 3.0}};
+    PBCBox first(box);
+    PBCBox second(box);
+    ASSERT_THAT(second.getBoxParameter(), Pointwise(DoubleEq(), first.getBoxParameter()));
+
+    box[0][0] = 4.0;
+    PBCBox third(box);
+    double xr = 25.0, yr = 0.0, zr = 0.0;
+    third.image(xr, yr, zr);
+    ASSERT_THAT(xr, DoubleNear(-15.0, 1E-6));
+    ASSERT_THAT(third.volume(), DoubleNear(40.0 * 30.0 * 30.0, 1E-3));
+}
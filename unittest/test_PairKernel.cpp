@@ -0,0 +1,117 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "utils/PairKernel.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+size_t count_pairs(const Frame &frame, const vector<size_t> &a, const vector<size_t> &b, double cutoff) {
+    CellList cell_list(cutoff);
+    return cell_list.search(frame, a, b).size();
+}
+
+// pairs numbered in the second set b and in the order of a search over it
+void expect_search_pairs(const Frame &frame, const vector<size_t> &a, const vector<size_t> &b, double cutoff,
+                         const vector<CellList::Pair> &pairs) {
+    CellList cell_list(cutoff);
+    const auto &expected = cell_list.search(frame, a, b);
+    ASSERT_THAT(pairs.size(), Eq(expected.size()));
+    for (size_t n = 0; n < pairs.size(); n++) {
+        ASSERT_THAT(pairs[n].i, Eq(expected[n].i));
+        ASSERT_THAT(pairs[n].j, Eq(expected[n].j));
+        ASSERT_THAT(pairs[n].distance2, DoubleNear(expected[n].distance2, 1E-9));
+    }
+}
+
+} // namespace
+
+TEST(PairKernel, RunsAloneWithoutDriver) {
+    auto frame = make_random_frame(PBCBox(25.0, 25.0, 25.0, 90.0, 90.0, 90.0), true, 1500, 12.5, 11);
+    const auto a = every(2, 0, 1500);
+    const auto b = every(2, 1, 1500);
+    size_t count = 0;
+    auto kernel = make_pair_kernel(a, b, 3.5, [&count](const CellList::Pair &) { count++; });
+    ASSERT_THAT(kernel->fused(), IsFalse());
+    kernel->process(*frame);
+    ASSERT_THAT(count, Eq(count_pairs(*frame, a, b, 3.5)));
+}
+
+TEST(PairKernel, DriverWalksSameSetsOnce) {
+    auto frame = make_random_frame(PBCBox(25.0, 25.0, 25.0, 90.0, 90.0, 90.0), true, 1500, 12.5, 11);
+    const auto a = every(2, 0, 1500);
+    const auto b = every(2, 1, 1500);
+    const auto c = every(3, 0, 1500);
+    size_t near = 0, far = 0, other = 0;
+    vector<double> far_distances;
+    auto near_kernel = make_pair_kernel(a, b, 3.0, [&near](const CellList::Pair &) { near++; });
+    auto far_kernel = make_pair_kernel(a, b, 5.0, [&](const CellList::Pair &pair) {
+        far++;
+        far_distances.push_back(pair.distance2);
+    });
+    auto other_kernel = make_pair_kernel(c, b, 4.0, [&other](const CellList::Pair &) { other++; });
+
+    PairKernelDriver driver;
+    driver.add(near_kernel);
+    driver.add(far_kernel);
+    driver.add(other_kernel);
+    ASSERT_THAT(driver.traversal_count(), Eq(2));
+    ASSERT_THAT(near_kernel->fused(), IsTrue());
+
+    driver.run(*frame);
+    // the tasks still call process, the kernels ran already
+    near_kernel->process(*frame);
+    far_kernel->process(*frame);
+    other_kernel->process(*frame);
+
+    ASSERT_THAT(near, Eq(count_pairs(*frame, a, b, 3.0)));
+    ASSERT_THAT(far, Eq(count_pairs(*frame, a, b, 5.0)));
+    ASSERT_THAT(other, Eq(count_pairs(*frame, c, b, 4.0)));
+    ASSERT_THAT(far_distances, Each(Le(25.0)));
+}
+
+TEST(PairKernel, DriverMergesOverlappingSecondSets) {
+    auto frame = make_random_frame(PBCBox(25.0, 25.0, 25.0, 90.0, 90.0, 90.0), true, 1500, 12.5, 11);
+    const auto a = every(2, 0, 1500);
+    const auto b = every(2, 1, 1500);
+    const auto c = every(3, 0, 1500);
+    vector<CellList::Pair> b_pairs, c_pairs;
+    auto b_kernel = make_pair_kernel(a, b, 3.0, [&b_pairs](const CellList::Pair &pair) { b_pairs.push_back(pair); });
+    auto c_kernel = make_pair_kernel(a, c, 4.0, [&c_pairs](const CellList::Pair &pair) { c_pairs.push_back(pair); });
+    // not ascending, walked by itself
+    const vector<size_t> reversed(b.rbegin(), b.rend());
+    size_t reversed_count = 0;
+    auto reversed_kernel =
+        make_pair_kernel(a, reversed, 3.0, [&reversed_count](const CellList::Pair &) { reversed_count++; });
+
+    PairKernelDriver driver;
+    driver.add(b_kernel);
+    driver.add(c_kernel);
+    driver.add(reversed_kernel);
+    ASSERT_THAT(driver.traversal_count(), Eq(2));
+    driver.run(*frame);
+
+    expect_search_pairs(*frame, a, b, 3.0, b_pairs);
+    expect_search_pairs(*frame, a, c, 4.0, c_pairs);
+    ASSERT_THAT(reversed_count, Eq(count_pairs(*frame, a, reversed, 3.0)));
+}
+
+TEST(PairKernel, ClearedKernelsRunAloneAgain) {
+    auto frame = make_random_frame(PBCBox(25.0, 25.0, 25.0, 90.0, 90.0, 90.0), true, 500, 12.5, 11);
+    const auto a = every(1, 0, 500);
+    size_t count = 0;
+    auto kernel = make_pair_kernel(a, a, 4.0, [&count](const CellList::Pair &) { count++; });
+
+    PairKernelDriver driver;
+    driver.add(kernel);
+    driver.clear();
+    ASSERT_THAT(kernel->fused(), IsFalse());
+    driver.run(*frame);
+    ASSERT_THAT(count, Eq(0));
+    kernel->process(*frame);
+    ASSERT_THAT(count, Eq(count_pairs(*frame, a, a, 4.0)));
+}
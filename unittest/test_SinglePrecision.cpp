@@ -0,0 +1,158 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+#include "ana_module/CoordinateNumPerFrame.hpp"
+#include "ana_module/RadicalDistribtuionFunction.hpp"
+#include "ana_module/ShellDensity.hpp"
+#include "data_structure/atom_group.hpp"
+#include "data_structure/frame.hpp"
+#include "dsl/AmberMask.hpp"
+#include "nlohmann/json.hpp"
+#include "trajectory_reader/TprReader.hpp"
+#include "utils/CellList.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+const double rmax = 8.0;
+const double width = 0.1;
+const int nbin = 80;
+const double cn_cutoff = 3.5;
+
+shared_ptr<Frame> read_frame() {
+    auto frame = TprReader().read("tpr_test_system1.tpr");
+    frame->enable_bound = true;
+    frame->index_atoms();
+    return frame;
+}
+
+AmberMask first_mask() { return parse_atoms("@1-3000", true); }
+
+AmberMask second_mask() { return parse_atoms("@3001-6000", true); }
+
+// histogram of the pairs found by the cell list search in the precision of Real, binned like the modules
+template <typename Real> vector<long> search_histogram(const shared_ptr<Frame> &frame, double cutoff) {
+    AtomGroup group1(frame, first_mask());
+    AtomGroup group2(frame, second_mask());
+    BasicCellList<Real> cell_list(cutoff);
+    vector<long> hist(nbin + 1, 0);
+    for (const auto &pair : cell_list.search(*frame, group1, group2)) {
+        int ibin = int(std::sqrt(pair.distance2) / width) + 1;
+        if (ibin <= nbin) hist[ibin]++;
+    }
+    return hist;
+}
+
+long total(const vector<long> &hist) { return accumulate(hist.begin() + 1, hist.end(), 0L); }
+
+// pairs counted in a different bin, relative to all pairs
+double moved(const vector<long> &lhs, const vector<long> &rhs) {
+    long changes = 0;
+    for (int i = 1; i <= nbin; i++) changes += std::abs(lhs[i] - rhs[i]);
+    return double(changes) / total(rhs);
+}
+
+// the counts column of the RDF table
+vector<long> rdf_histogram(const shared_ptr<Frame> &frame) {
+    auto rdf = make_shared<RadicalDistribtuionFunction>();
+    rdf->setParameters(first_mask(), second_mask(), rmax, width, true, "rdf.xvg");
+    shared_ptr<AbstractAnalysis> task = rdf;
+    auto current = frame;
+    task->processFirstFrame(current);
+    task->process(current);
+    stringstream ss;
+    task->print(ss);
+
+    vector<long> hist(nbin + 1, 0);
+    string line;
+    while (getline(ss, line)) {
+        istringstream is(line);
+        int bin;
+        long count;
+        if (is >> bin >> count and bin >= 1 and bin <= nbin) hist[bin] = count;
+    }
+    return hist;
+}
+
+// counts back from the densities of the JSON block, one frame
+vector<long> shell_histogram(const shared_ptr<Frame> &frame) {
+    auto shell = make_shared<ShellDensity>();
+    shell->setParameters(first_mask(), second_mask(), rmax, width, "shell.xvg");
+    shared_ptr<AbstractAnalysis> task = shell;
+    auto current = frame;
+    task->processFirstFrame(current);
+    task->process(current);
+    stringstream ss;
+    task->print(ss);
+
+    const auto out = ss.str();
+    const auto begin = out.find(">>>JSON<<<\n") + 11;
+    const auto json = nlohmann::json::parse(out.substr(begin, out.find("<<<JSON>>>") - begin));
+    const auto &densities = json["Density"]["Y2"]["values"];
+    vector<long> hist(nbin + 1, 0);
+    for (int i = 1; i <= nbin; i++) {
+        double dv = (4.0 / 3.0) * M_PI * (pow(i * width, 3) - pow((i - 1) * width, 3));
+        hist[i] = std::lround(densities[i - 1].get<double>() * dv);
+    }
+    return hist;
+}
+
+// the CN of the only frame
+long coordinate_number(const shared_ptr<Frame> &frame) {
+    auto cn = make_shared<CoordinateNumPerFrame>();
+    cn->setParameters(first_mask(), second_mask(), cn_cutoff, "cn.dat");
+    shared_ptr<AbstractAnalysis> task = cn;
+    auto current = frame;
+    task->processFirstFrame(current);
+    task->process(current);
+    stringstream ss;
+    task->print(ss);
+
+    string line;
+    while (getline(ss, line)) {
+        istringstream is(line);
+        long index, value;
+        if (is >> index >> value) return value;
+    }
+    return -1;
+}
+
+} // namespace
+
+// XTC stores 1E-3 nm, so single precision may only move pairs sitting on the edge of a 0.1 Ang bin
+TEST(SinglePrecision, SearchMatchesDouble) {
+    auto frame = read_frame();
+    auto single = search_histogram<float>(frame, rmax);
+    auto dual = search_histogram<double>(frame, rmax);
+    ASSERT_THAT(total(dual), Gt(0));
+    ASSERT_THAT(moved(single, dual), Le(1E-3));
+}
+
+// the modules bin the pairs of the search in coord_real exactly, so they are within the same tolerance of double
+TEST(SinglePrecision, ModulesMatchDouble) {
+    auto frame = read_frame();
+    const auto expected = search_histogram<coord_real>(frame, rmax);
+    const auto dual = search_histogram<double>(frame, rmax);
+
+    const auto rdf = rdf_histogram(frame);
+    ASSERT_THAT(rdf, Eq(expected));
+    ASSERT_THAT(moved(rdf, dual), Le(1E-3));
+
+    const auto shell = shell_histogram(frame);
+    ASSERT_THAT(shell, Eq(expected));
+    ASSERT_THAT(moved(shell, dual), Le(1E-3));
+
+    AtomGroup group1(frame, first_mask());
+    AtomGroup group2(frame, second_mask());
+    const long pairs = CellList(cn_cutoff).search(*frame, group1, group2).size();
+    const long dual_pairs = BasicCellList<double>(cn_cutoff).search(*frame, group1, group2).size();
+    const auto cn = coordinate_number(frame);
+    ASSERT_THAT(dual_pairs, Gt(0));
+    ASSERT_THAT(cn, Eq(pairs));
+    ASSERT_THAT(double(std::abs(cn - dual_pairs)) / dual_pairs, Le(1E-3));
+}
@@ -0,0 +1,89 @@
+#include <gmock/gmock.h>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "data_structure/topology.hpp"
+#include "gtest_utility.hpp"
+#include "utils/ResidueContactSeries.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// a molecule of residues 1 (atoms 10, 11) and 2 (atom 12), then an ion (atom 20) without molecule
+shared_ptr<Frame> make_frame() {
+    auto frame = make_shared<Frame>();
+    auto mol = make_shared<Molecule>();
+    vector<size_t> seqs{10, 11, 12, 20};
+    vector<list<size_t>> bonds{{11}, {10, 12}, {11}, {}};
+    vector<uint> residues{1, 1, 2, 3};
+    vector<string> residue_names{"ALA", "ALA", "GLY", "NA"};
+    for (size_t i = 0; i < seqs.size(); i++) {
+        auto atom = add_atom(*frame, seqs[i]);
+        atom->con_list = bonds[i];
+        atom->residue_num = residues[i];
+        atom->residue_name = residue_names[i];
+        if (i < 3) {
+            atom->molecule = mol;
+            mol->atom_list.push_back(atom);
+        }
+    }
+    frame->molecule_list.push_back(mol);
+    frame->index_atoms();
+    return frame;
+}
+
+} // namespace
+
+TEST(Topology, BondsAsIndices) {
+    auto frame = make_frame();
+    const auto &topology = *frame->topology;
+    ASSERT_THAT(topology.bonded(0), ElementsAre(1));
+    ASSERT_THAT(topology.bonded(1), ElementsAre(0, 2));
+    ASSERT_THAT(topology.bonded(3), IsEmpty());
+}
+
+TEST(Topology, ResiduesAndMolecules) {
+    auto frame = make_frame();
+    const auto &topology = *frame->topology;
+    ASSERT_THAT(topology.residue_count(), Eq(3));
+    ASSERT_THAT(topology.residue_of(1), Eq(0));
+    ASSERT_THAT(topology.residue_of(2), Eq(1));
+    ASSERT_THAT(topology.residue_number(2), Eq(3));
+    ASSERT_THAT(topology.residue_atoms(0), Eq(pair<uint32_t, uint32_t>(0, 2)));
+
+    ASSERT_THAT(topology.molecule_count(), Eq(1));
+    ASSERT_THAT(topology.molecule_of(2), Eq(0));
+    ASSERT_THAT(topology.molecule_of(3), Eq(Topology::npos));
+    ASSERT_THAT(topology.molecule_atoms(0), ElementsAre(0, 1, 2));
+}
+
+TEST(Topology, ResidueKeysFromResidueTable) {
+    auto frame = make_frame();
+    ResidueContactSeries series;
+    vector<size_t> atoms{2, 0, 1, 3};
+    ASSERT_THAT(series.residue_keys(*frame, atoms, "-"), ElementsAre(0, 1, 1, 2));
+    ASSERT_THAT(series.label(0), Eq("GLY-2"));
+    ASSERT_THAT(series.label(1), Eq("ALA-1"));
+    ASSERT_THAT(series.label(2), Eq("NA-3"));
+    ASSERT_THAT(series.key_count(), Eq(3));
+}
+
+TEST(Topology, MoleculeGraphFromBonds) {
+    auto frame = make_frame();
+    frame->build_graph();
+    const auto &mol = frame->molecule_list.front();
+    // each bond is listed by both of its atoms but added once
+    ASSERT_THAT(boost::num_edges(mol->g), Eq(2));
+    ASSERT_THAT(mol->unwrap_plan, ElementsAre(pair<uint32_t, uint32_t>(0, 1), pair<uint32_t, uint32_t>(1, 2)));
+}
+
+TEST(Topology, AtomBySeq) {
+    auto frame = make_frame();
+    ASSERT_THAT(frame->topology->index_of_seq(20), Eq(3));
+    ASSERT_THAT(frame->topology->index_of_seq(15), Eq(Topology::npos));
+    ASSERT_THAT(frame->atom_by_seq(12), Eq(frame->atom_list[2]));
+    ASSERT_THAT(frame->atom_by_seq(20), Eq(frame->atom_map[20]));
+}
@@ -0,0 +1,113 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "data_structure/molecule.hpp"
+#include "trajectory_reader/TopologySnapshot.hpp"
+#include "trajectory_reader/trajectoryreader.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+shared_ptr<Frame> read_topology(const string &filename, bool cache = true) {
+    TrajectoryReader reader;
+    reader.set_topology(filename);
+    reader.set_cache(cache);
+    return reader.readTopology();
+}
+
+void expect_same_topology(const shared_ptr<Frame> &expected, const shared_ptr<Frame> &actual) {
+    ASSERT_THAT(actual->title, Eq(expected->title));
+    ASSERT_THAT(actual->atom_list.size(), Eq(expected->atom_list.size()));
+    for (size_t i = 0; i < expected->atom_list.size(); ++i) {
+        const auto &a = expected->atom_list[i];
+        const auto &b = actual->atom_list[i];
+        ASSERT_THAT(b->seq, Eq(a->seq));
+        ASSERT_THAT(b->atom_name, Eq(a->atom_name));
+        ASSERT_THAT(b->type_name, Eq(a->type_name));
+        ASSERT_THAT(b->charge, Eq(a->charge));
+        ASSERT_THAT(b->mass, Eq(a->mass));
+        ASSERT_THAT(b->residue_name, Eq(a->residue_name));
+        ASSERT_THAT(b->residue_num, Eq(a->residue_num));
+        ASSERT_THAT(b->real_residue_number, Eq(a->real_residue_number));
+        ASSERT_THAT(b->con_list, ContainerEq(a->con_list));
+        ASSERT_THAT(b->molecule.lock()->sequence, Eq(a->molecule.lock()->sequence));
+        ASSERT_THAT(b->x, DoubleEq(a->x));
+    }
+    ASSERT_THAT(actual->molecule_list.size(), Eq(expected->molecule_list.size()));
+    for (size_t i = 0; i < expected->molecule_list.size(); ++i) {
+        const auto &a = expected->molecule_list[i];
+        const auto &b = actual->molecule_list[i];
+        ASSERT_THAT(b->atom_list.size(), Eq(a->atom_list.size()));
+        ASSERT_THAT(boost::num_edges(b->g), Eq(boost::num_edges(a->g)));
+        ASSERT_THAT(b->atom_list.front()->seq, Eq(a->atom_list.front()->seq));
+    }
+    ASSERT_THAT(actual->f_bond_params.size(), Eq(expected->f_bond_params.size()));
+    ASSERT_THAT(actual->f_angle_params.size(), Eq(expected->f_angle_params.size()));
+    ASSERT_THAT(actual->f_dihedral_params.size(), Eq(expected->f_dihedral_params.size()));
+    ASSERT_THAT(actual->f_improper_dihedral_params.size(), Eq(expected->f_improper_dihedral_params.size()));
+
+    const auto &[bond, param] = *actual->f_bond_params.begin();
+    const auto &expected_param =
+        expected->f_bond_params.at({expected->atom_list[bond[0]->seq - 1], expected->atom_list[bond[1]->seq - 1]});
+    ASSERT_THAT(param.krA, DoubleEq(expected_param.krA));
+    ASSERT_THAT(param.rA, DoubleEq(expected_param.rA));
+}
+
+} // namespace
+
+TEST(TopologySnapshot, SnapshotRestoresPrmtopTopology) {
+    const string topology = "amber_test_topology1.prmtop";
+    const auto snapshot = TopologySnapshot::snapshot_filename(topology);
+    boost::filesystem::remove(snapshot);
+
+    auto parsed = read_topology(topology);
+    ASSERT_TRUE(TopologySnapshot::is_valid(snapshot, topology));
+
+    auto loaded = read_topology(topology);
+    expect_same_topology(parsed, loaded);
+
+    boost::filesystem::remove(snapshot);
+}
+
+TEST(TopologySnapshot, SnapshotRestoresTprTopology) {
+    const string topology = "tpr_test_system1.tpr";
+    const auto snapshot = TopologySnapshot::snapshot_filename(topology);
+    boost::filesystem::remove(snapshot);
+
+    auto parsed = read_topology(topology);
+    auto loaded = TopologySnapshot::load(snapshot);
+    ASSERT_TRUE(loaded);
+    expect_same_topology(parsed, loaded);
+    ASSERT_THAT(loaded->atom_list.front()->lj_param->c6, DoubleEq(parsed->atom_list.front()->lj_param->c6));
+    ASSERT_THAT(loaded->box.getBoxParameter()[0], DoubleNear(parsed->box.getBoxParameter()[0], 1E-8));
+
+    boost::filesystem::remove(snapshot);
+}
+
+TEST(TopologySnapshot, NoSnapshotWithoutCache) {
+    const string topology = "amber_test_topology1.prmtop";
+    const auto snapshot = TopologySnapshot::snapshot_filename(topology);
+    boost::filesystem::remove(snapshot);
+
+    ASSERT_TRUE(read_topology(topology, false));
+    ASSERT_FALSE(boost::filesystem::exists(snapshot));
+}
+
+TEST(TopologySnapshot, SnapshotOutdatedWhenTopologyChanged) {
+    const string topology = "topology_snapshot_test.prmtop";
+    boost::filesystem::copy_file("amber_test_topology1.prmtop", topology,
+                                 boost::filesystem::copy_option::overwrite_if_exists);
+    const auto snapshot = TopologySnapshot::snapshot_filename(topology);
+    read_topology(topology);
+    ASSERT_TRUE(TopologySnapshot::is_valid(snapshot, topology));
+
+    std::ofstream(topology, std::ios::app) << '\n';
+    ASSERT_FALSE(TopologySnapshot::is_valid(snapshot, topology));
+
+    boost::filesystem::remove(topology);
+    boost::filesystem::remove(snapshot);
+}
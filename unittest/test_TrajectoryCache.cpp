@@ -0,0 +1,110 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/CacheTrajectoryReader.hpp"
+#include "trajectory_reader/CachingTrajectoryReader.hpp"
+#include "trajectory_reader/NetcdfTrajectoryReader.hpp"
+#include "utils/netcdf_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// atom i of frame n is at (n, i, -i)
+void write_numbered_atoms(const string &filename, int natoms, int nframes) {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(30.0, 40.0, 50.0, 90.0, 90.0, 90.0);
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1, 0.0, i, -i);
+    }
+    NetCDFWriter writer;
+    writer.open(filename);
+    for (int n = 0; n < nframes; n++) {
+        for (auto &atom : frame->atom_list) {
+            atom->x = n;
+        }
+        writer.write(frame);
+    }
+    writer.close();
+}
+
+} // namespace
+
+TEST(TrajectoryCache, CacheWrittenOnlyAfterFullPass) {
+    const string source = "trajectory_cache_test.nc";
+    const string cache = TrajectoryCache::cache_filename(source);
+    write_numbered_atoms(source, 10, 8);
+    boost::filesystem::remove(cache);
+
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(10);
+
+    {
+        CachingTrajectoryReader reader(make_shared<NetcdfTrajectoryReader>(), cache);
+        ASSERT_TRUE(reader.open(source));
+        ASSERT_TRUE(reader.readOneFrame(buffer));
+        reader.close();
+    }
+    ASSERT_FALSE(boost::filesystem::exists(cache));
+
+    {
+        CachingTrajectoryReader reader(make_shared<NetcdfTrajectoryReader>(), cache);
+        ASSERT_TRUE(reader.open(source));
+        int nframes = 0;
+        while (reader.readOneFrame(buffer)) {
+            ASSERT_THAT(buffer.x[0], DoubleEq(nframes));
+            nframes++;
+        }
+        ASSERT_THAT(nframes, Eq(8));
+        reader.close();
+    }
+    ASSERT_TRUE(TrajectoryCache::is_valid(cache, source, 10));
+    ASSERT_FALSE(TrajectoryCache::is_valid(cache, source, 11));
+
+    boost::filesystem::remove(source);
+    boost::filesystem::remove(cache);
+}
+
+TEST(TrajectoryCache, ReadSubsetAndSkip) {
+    const string source = "trajectory_cache_subset_test.nc";
+    const string cache = TrajectoryCache::cache_filename(source);
+    write_numbered_atoms(source, 20, 12);
+
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(20);
+    {
+        CachingTrajectoryReader reader(make_shared<NetcdfTrajectoryReader>(), cache);
+        ASSERT_TRUE(reader.open(source));
+        while (reader.readOneFrame(buffer)) {
+        }
+        reader.close();
+    }
+
+    CacheTrajectoryReader reader;
+    ASSERT_TRUE(reader.open(cache));
+    buffer.subset = {2, 5, 19};
+
+    vector<int> frames;
+    while (reader.readOneFrame(buffer)) {
+        frames.push_back(static_cast<int>(buffer.x[3 * 2]));
+        for (auto i : buffer.subset) {
+            ASSERT_THAT(buffer.x[3 * i], DoubleEq(frames.back()));
+            ASSERT_THAT(buffer.x[3 * i + 1], DoubleEq(i));
+            ASSERT_THAT(buffer.x[3 * i + 2], DoubleEq(-static_cast<double>(i)));
+        }
+        ASSERT_TRUE(buffer.box.has_value());
+        ASSERT_THAT(buffer.box->getBoxParameter()[2], DoubleNear(50.0, 1E-5));
+        reader.skipFrames(2, buffer);
+    }
+    reader.close();
+    ASSERT_THAT(frames, ElementsAre(0, 3, 6, 9));
+
+    boost::filesystem::remove(source);
+    boost::filesystem::remove(cache);
+}
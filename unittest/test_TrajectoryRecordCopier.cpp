@@ -0,0 +1,164 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/FrameIndex.hpp"
+#include "trajectory_reader/XtcTrajectoryReader.hpp"
+#include "utils/TrajectoryRecordCopier.hpp"
+#include "utils/trr_writer.hpp"
+#include "utils/xtc_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+// x of all atoms in frame n is first + n
+template <typename Writer>
+void write_numbered_frames(const string &filename, int natoms, int nframes, int first) {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(30.0, 30.0, 30.0, 90.0, 90.0, 90.0);
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1, 0.0, i);
+    }
+    Writer writer;
+    writer.open(filename);
+    for (int n = 0; n < nframes; n++) {
+        for (auto &atom : frame->atom_list) {
+            atom->x = first + n;
+        }
+        writer.write(frame);
+    }
+    writer.close();
+}
+
+vector<int> read_frame_numbers(const string &filename) {
+    XtcTrajectoryReader reader;
+    reader.open(filename);
+    FrameBuffer buffer;
+    buffer.reserve(20);
+    vector<int> frames;
+    while (reader.readOneFrame(buffer)) {
+        frames.push_back(static_cast<int>(std::round(buffer.x[0])));
+    }
+    reader.close();
+    return frames;
+}
+
+// the decode path of fast trajectory convert, frames start, start + step ... up to end decoded and written again
+void decode_and_write(const vector<string> &inputs, const string &target, uint start, uint end, uint step) {
+    auto frame = make_shared<Frame>();
+    for (int i = 0; i < 20; i++) {
+        add_atom(*frame, i + 1);
+    }
+    frame->index_atoms();
+    XTCWriter writer;
+    writer.open(target);
+    uint number = 0;
+    for (const auto &input : inputs) {
+        XtcTrajectoryReader reader;
+        reader.open(input);
+        FrameBuffer buffer;
+        buffer.enable_bound = true;
+        buffer.reserve(frame->atom_list.size());
+        while (reader.readOneFrame(buffer)) {
+            ++number;
+            if (number >= start and (end == 0 or number <= end) and (number - start) % step == 0) {
+                buffer.apply(frame, frame->atom_list);
+                writer.write(frame);
+            }
+        }
+        reader.close();
+    }
+    writer.close();
+}
+
+void remove_trajectory(const string &filename) {
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}
+
+} // namespace
+
+TEST(TrajectoryRecordCopier, ConcatenateXtcFiles) {
+    write_numbered_frames<XTCWriter>("record_copier_part1.xtc", 20, 5, 1);
+    write_numbered_frames<XTCWriter>("record_copier_part2.xtc", 20, 6, 6);
+
+    TrajectoryRecordCopier copier;
+    auto frames = copier.copy({"record_copier_part1.xtc", "record_copier_part2.xtc"}, "record_copier_out.xtc");
+    ASSERT_TRUE(frames.has_value());
+    ASSERT_THAT(frames.get(), Eq(11));
+    ASSERT_THAT(boost::filesystem::file_size("record_copier_out.xtc"),
+                Eq(boost::filesystem::file_size("record_copier_part1.xtc") +
+                   boost::filesystem::file_size("record_copier_part2.xtc")));
+    ASSERT_THAT(read_frame_numbers("record_copier_out.xtc"), ElementsAre(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11));
+
+    remove_trajectory("record_copier_part1.xtc");
+    remove_trajectory("record_copier_part2.xtc");
+    remove_trajectory("record_copier_out.xtc");
+}
+
+TEST(TrajectoryRecordCopier, SliceAndStrideRenumbersFrames) {
+    write_numbered_frames<XTCWriter>("record_copier_part1.xtc", 20, 5, 1);
+    write_numbered_frames<XTCWriter>("record_copier_part2.xtc", 20, 6, 6);
+    const vector<string> inputs{"record_copier_part1.xtc", "record_copier_part2.xtc"};
+
+    auto frames = TrajectoryRecordCopier(2, 9, 3).copy(inputs, "record_copier_out.xtc");
+    ASSERT_THAT(frames.get(), Eq(3));
+    ASSERT_THAT(read_frame_numbers("record_copier_out.xtc"), ElementsAre(2, 5, 8));
+    auto index = FrameIndex::load_or_build("record_copier_out.xtc", FileType::XTC);
+    for (std::size_t i = 0; i < index->size(); i++) {
+        ASSERT_THAT((*index)[i].step, Eq(i));
+        ASSERT_THAT((*index)[i].time, FloatEq(i));
+    }
+
+    remove_trajectory("record_copier_part1.xtc");
+    remove_trajectory("record_copier_part2.xtc");
+    remove_trajectory("record_copier_out.xtc");
+}
+
+TEST(TrajectoryRecordCopier, SameAsDecodePath) {
+    write_numbered_frames<XTCWriter>("record_copier_part1.xtc", 20, 5, 1);
+    write_numbered_frames<XTCWriter>("record_copier_part2.xtc", 20, 6, 6);
+    const vector<string> inputs{"record_copier_part1.xtc", "record_copier_part2.xtc"};
+
+    ASSERT_THAT(TrajectoryRecordCopier(3, 0, 2).copy(inputs, "record_copier_out.xtc").get(), Eq(5));
+    decode_and_write(inputs, "record_copier_decoded.xtc", 3, 0, 2);
+    ASSERT_THAT(read_frame_numbers("record_copier_out.xtc"), ElementsAre(3, 5, 7, 9, 11));
+    ASSERT_THAT(read_frame_numbers("record_copier_decoded.xtc"), ElementsAre(3, 5, 7, 9, 11));
+    auto copied = FrameIndex::load_or_build("record_copier_out.xtc", FileType::XTC);
+    auto decoded = FrameIndex::load_or_build("record_copier_decoded.xtc", FileType::XTC);
+    ASSERT_THAT(copied->size(), Eq(decoded->size()));
+    for (std::size_t i = 0; i < copied->size(); i++) {
+        ASSERT_THAT((*copied)[i].step, Eq((*decoded)[i].step));
+        ASSERT_THAT((*copied)[i].time, FloatEq((*decoded)[i].time));
+        ASSERT_THAT((*copied)[i].box, Pointwise(FloatNear(1E-6), (*decoded)[i].box));
+    }
+
+    remove_trajectory("record_copier_part1.xtc");
+    remove_trajectory("record_copier_part2.xtc");
+    remove_trajectory("record_copier_out.xtc");
+    remove_trajectory("record_copier_decoded.xtc");
+}
+
+TEST(TrajectoryRecordCopier, RenumberTrrFrames) {
+    write_numbered_frames<TRRWriter>("record_copier_part1.trr", 3, 4, 1);
+
+    auto frames = TrajectoryRecordCopier(2, 0, 2).copy({"record_copier_part1.trr"}, "record_copier_out.trr");
+    ASSERT_THAT(frames.get(), Eq(2));
+    auto index = FrameIndex::load_or_build("record_copier_out.trr", FileType::TRR);
+    ASSERT_THAT(index->size(), Eq(2));
+    ASSERT_THAT((*index)[1].step, Eq(1));
+    ASSERT_THAT((*index)[1].time, FloatEq(1));
+
+    remove_trajectory("record_copier_part1.trr");
+    remove_trajectory("record_copier_out.trr");
+}
+
+TEST(TrajectoryRecordCopier, FallbackForOtherFormats) {
+    ASSERT_FALSE(TrajectoryRecordCopier().copy({"a.nc"}, "b.xtc").has_value());
+    ASSERT_FALSE(TrajectoryRecordCopier().copy({"a.xtc"}, "b.nc").has_value());
+    ASSERT_FALSE(boost::filesystem::exists("b.xtc"));
+}
@@ -0,0 +1,149 @@
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include "data_structure/atom.hpp"
+#include "data_structure/frame.hpp"
+#include "gtest_utility.hpp"
+#include "trajectory_reader/FrameIndex.hpp"
+#include "trajectory_reader/XtcTrajectoryReader.hpp"
+#include "utils/xtc_writer.hpp"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+
+void write_moving_atoms(const string &filename, int natoms, int nframes) {
+    auto frame = make_shared<Frame>();
+    frame->box = PBCBox(30.0, 30.0, 30.0, 90.0, 90.0, 90.0);
+    for (int i = 0; i < natoms; i++) {
+        add_atom(*frame, i + 1);
+    }
+    XTCWriter writer;
+    writer.open(filename);
+    for (int n = 0; n < nframes; n++) {
+        for (int i = 0; i < natoms; i++) {
+            auto &atom = frame->atom_list[i];
+            atom->x = 0.1 * i + n;
+            atom->y = 0.2 * i;
+            atom->z = 0.3 * i - n;
+        }
+        writer.write(frame);
+    }
+    writer.close();
+}
+
+vector<vector<double>> read_all(const string &filename, int natoms, size_t parallel_decode, size_t skip_after_first) {
+    XtcTrajectoryReader reader;
+    reader.setParallelDecode(parallel_decode);
+    reader.open(filename);
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(natoms);
+
+    vector<vector<double>> frames;
+    while (reader.readOneFrame(buffer)) {
+        frames.emplace_back(buffer.x.begin(), buffer.x.begin() + 3 * buffer.natoms);
+        if (frames.size() == 1) {
+            reader.skipFrames(skip_after_first, buffer);
+        }
+    }
+    reader.close();
+    return frames;
+}
+
+// every stride-th frame, the others skipped the way TrajectoryReader skips unselected frames
+vector<vector<double>> read_strided(const string &filename, int natoms, size_t parallel_decode, size_t stride) {
+    XtcTrajectoryReader reader;
+    reader.setParallelDecode(parallel_decode);
+    reader.setDecodeStride(stride);
+    reader.open(filename);
+    FrameBuffer buffer;
+    buffer.enable_bound = true;
+    buffer.reserve(natoms);
+
+    vector<vector<double>> frames;
+    while (reader.readOneFrame(buffer)) {
+        frames.emplace_back(buffer.x.begin(), buffer.x.begin() + 3 * buffer.natoms);
+        reader.skipFrames(stride - 1, buffer);
+    }
+    reader.close();
+    return frames;
+}
+
+} // namespace
+
+TEST(XtcParallelDecode, FramesAreReturnedInOrder) {
+    const string filename = "xtc_parallel_decode_test.xtc";
+    write_moving_atoms(filename, 50, 11);
+
+    auto serial = read_all(filename, 50, 0, 0);
+    ASSERT_THAT(serial.size(), Eq(11));
+    for (size_t n = 0; n < serial.size(); n++) {
+        ASSERT_THAT(serial[n][0], DoubleNear(n, 2E-2));
+    }
+
+    for (size_t batch : {2, 4, 16}) {
+        auto parallel = read_all(filename, 50, batch, 0);
+        ASSERT_THAT(parallel, ContainerEq(serial)) << "parallel decode with " << batch << " frames";
+    }
+
+    auto skipped = read_all(filename, 50, 4, 5);
+    ASSERT_THAT(skipped.size(), Eq(6));
+    ASSERT_THAT(skipped[0], ContainerEq(serial[0]));
+    ASSERT_THAT(skipped[1], ContainerEq(serial[6]));
+    ASSERT_THAT(skipped[5], ContainerEq(serial[10]));
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}
+
+TEST(XtcParallelDecode, BatchesFollowStride) {
+    const string filename = "xtc_stride_decode_test.xtc";
+    write_moving_atoms(filename, 30, 23);
+
+    auto serial = read_all(filename, 30, 0, 0);
+    for (size_t stride : {2, 5, 7}) {
+        auto strided = read_strided(filename, 30, 4, stride);
+        ASSERT_THAT(strided.size(), Eq((serial.size() + stride - 1) / stride));
+        for (size_t n = 0; n < strided.size(); n++) {
+            ASSERT_THAT(strided[n], ContainerEq(serial[n * stride])) << "stride " << stride << " frame " << n;
+        }
+    }
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}
+
+TEST(XtcParallelDecode, OnlyAtomsInSubsetAreConverted) {
+    const string filename = "xtc_subset_test.xtc";
+    write_moving_atoms(filename, 20, 3);
+
+    for (size_t batch : {0, 4}) {
+        XtcTrajectoryReader reader;
+        reader.setParallelDecode(batch);
+        reader.open(filename);
+        FrameBuffer buffer;
+        buffer.reserve(20);
+        buffer.subset = {3, 7};
+
+        auto frame = make_shared<Frame>();
+        vector<shared_ptr<Atom>> atoms;
+        for (int i = 0; i < 20; i++) {
+            atoms.push_back(make_shared<Atom>());
+            atoms.back()->x = -100.0;
+        }
+        for (int n = 0; n < 3; n++) {
+            ASSERT_TRUE(reader.readOneFrame(buffer));
+            ASSERT_THAT(buffer.x[3 * 3], DoubleNear(0.3 + n, 2E-2));
+            ASSERT_THAT(buffer.x[3 * 7 + 1], DoubleNear(1.4, 2E-2));
+            buffer.apply(frame, atoms);
+            ASSERT_THAT(atoms[3]->x, DoubleNear(0.3 + n, 2E-2));
+            ASSERT_THAT(atoms[5]->x, DoubleEq(-100.0));
+        }
+        reader.close();
+    }
+
+    boost::filesystem::remove(filename);
+    boost::filesystem::remove(FrameIndex::index_filename(filename));
+}